@@ -0,0 +1,248 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+//
+// Steady-state microbenchmarks for the OpenCLOn12 runtime. Each benchmark
+// prints one CSV line per measurement to stdout:
+//
+//     benchmark,parameter,value,unit
+//
+// so per-commit results can be diffed or charted by scripts. Failures print
+// a diagnostic to stderr and make the process exit nonzero; no output line
+// is ever emitted for a measurement that didn't run.
+
+#define CL_TARGET_OPENCL_VERSION 220
+#include <CL/cl.h>
+
+#define CL_HPP_ENABLE_EXCEPTIONS
+#define CL_HPP_TARGET_OPENCL_VERSION 220
+#define CL_HPP_MINIMUM_OPENCL_VERSION 220
+#define CL_HPP_CL_1_2_DEFAULT_BUILD
+#include "cl2.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double ElapsedMs(Clock::time_point start, Clock::time_point end)
+{
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void Report(const char* benchmark, std::string const& parameter, double value, const char* unit)
+{
+    printf("%s,%s,%.4f,%s\n", benchmark, parameter.c_str(), value, unit);
+}
+
+static std::pair<cl::Context, cl::Device> GetBenchContext()
+{
+    std::vector<cl::Platform> platforms;
+    cl::Platform::get(&platforms);
+    if (platforms.empty())
+    {
+        fprintf(stderr, "No OpenCL platforms found\n");
+        exit(1);
+    }
+
+    std::vector<cl::Device> devices;
+    platforms[0].getDevices(CL_DEVICE_TYPE_ALL, &devices);
+    if (devices.empty())
+    {
+        fprintf(stderr, "No OpenCL devices found\n");
+        exit(1);
+    }
+
+    // Use the first enumerated device by default; CLON12_BENCH_DEVICE selects
+    // by substring of the device name for multi-adapter machines.
+    cl::Device device = devices[0];
+    if (const char* filter = getenv("CLON12_BENCH_DEVICE"))
+    {
+        for (auto& d : devices)
+        {
+            if (d.getInfo<CL_DEVICE_NAME>().find(filter) != std::string::npos)
+            {
+                device = d;
+                break;
+            }
+        }
+    }
+    fprintf(stderr, "Device: %s\n", device.getInfo<CL_DEVICE_NAME>().c_str());
+
+    cl_context_properties context_props[] = { CL_CONTEXT_PLATFORM, (cl_context_properties)platforms[0](), 0 };
+    cl::Context context(device, context_props,
+        [](const char* msg, const void*, size_t, void*)
+    {
+        fprintf(stderr, "%s\n", msg);
+    });
+    return { context, device };
+}
+
+static const char* kKernelSource =
+"__kernel void add(__global uint *a, uint val)\n\
+{\n\
+    a[get_global_id(0)] += val;\n\
+}\n";
+
+// Wall time of the clEnqueueNDRangeKernel call itself, measured in a steady
+// state where the device is continuously busy and submissions are batched.
+static void BenchEnqueueLatency(cl::Context& context, cl::Device& device, cl::Kernel& kernel)
+{
+    cl::CommandQueue queue(context, device);
+    cl::Buffer buffer(context, CL_MEM_READ_WRITE, 1024 * sizeof(cl_uint));
+    kernel.setArg(0, buffer);
+    kernel.setArg(1, (cl_uint)1);
+
+    constexpr int warmup = 256, iterations = 4096;
+    for (int i = 0; i < warmup; ++i)
+    {
+        queue.enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange{ 1024 });
+    }
+    queue.finish();
+
+    auto start = Clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        queue.enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange{ 1024 });
+    }
+    auto end = Clock::now();
+    queue.finish();
+
+    Report("enqueue_ndrange", "per_call", ElapsedMs(start, end) * 1000.0 / iterations, "us");
+}
+
+// clFlush cost as a function of how many unflushed tasks are queued.
+static void BenchFlushCost(cl::Context& context, cl::Device& device, cl::Kernel& kernel)
+{
+    cl::CommandQueue queue(context, device);
+    cl::Buffer buffer(context, CL_MEM_READ_WRITE, 1024 * sizeof(cl_uint));
+    kernel.setArg(0, buffer);
+    kernel.setArg(1, (cl_uint)1);
+
+    constexpr int repeats = 32;
+    for (int taskCount : { 1, 16, 64, 256 })
+    {
+        double totalMs = 0;
+        for (int r = 0; r < repeats; ++r)
+        {
+            for (int i = 0; i < taskCount; ++i)
+            {
+                queue.enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange{ 1024 });
+            }
+            auto start = Clock::now();
+            queue.flush();
+            totalMs += ElapsedMs(start, Clock::now());
+            queue.finish();
+        }
+        Report("flush", std::to_string(taskCount) + "_tasks", totalMs * 1000.0 / repeats, "us");
+    }
+}
+
+// Blocking map + unmap + finish round trip on a buffer the device just wrote.
+static void BenchMapUnmap(cl::Context& context, cl::Device& device, cl::Kernel& kernel)
+{
+    cl::CommandQueue queue(context, device);
+    constexpr size_t elements = 1024 * 1024;
+    cl::Buffer buffer(context, CL_MEM_READ_WRITE, elements * sizeof(cl_uint));
+    kernel.setArg(0, buffer);
+    kernel.setArg(1, (cl_uint)1);
+
+    constexpr int warmup = 4, iterations = 64;
+    double totalMs = 0;
+    for (int i = 0; i < warmup + iterations; ++i)
+    {
+        queue.enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange{ elements });
+        auto start = Clock::now();
+        void* ptr = queue.enqueueMapBuffer(buffer, CL_TRUE, CL_MAP_READ, 0, elements * sizeof(cl_uint));
+        queue.enqueueUnmapMemObject(buffer, ptr);
+        queue.finish();
+        if (i >= warmup)
+        {
+            totalMs += ElapsedMs(start, Clock::now());
+        }
+    }
+    Report("map_unmap", "round_trip", totalMs * 1000.0 / iterations, "us");
+}
+
+// Blocking write then read bandwidth across a range of transfer sizes.
+static void BenchTransferBandwidth(cl::Context& context, cl::Device& device)
+{
+    cl::CommandQueue queue(context, device);
+    constexpr size_t maxSize = 64 * 1024 * 1024;
+    std::vector<char> host(maxSize, 1);
+
+    for (size_t size = 64 * 1024; size <= maxSize; size *= 4)
+    {
+        cl::Buffer buffer(context, CL_MEM_READ_WRITE, size);
+        int iterations = (int)std::max<size_t>(4, (256 * 1024 * 1024) / size);
+
+        queue.enqueueWriteBuffer(buffer, CL_TRUE, 0, size, host.data());
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            queue.enqueueWriteBuffer(buffer, CL_TRUE, 0, size, host.data());
+        }
+        double seconds = ElapsedMs(start, Clock::now()) / 1000.0;
+        Report("write_bandwidth", std::to_string(size / 1024) + "KB",
+               (double)size * iterations / seconds / 1.0e9, "GB/s");
+
+        queue.enqueueReadBuffer(buffer, CL_TRUE, 0, size, host.data());
+        start = Clock::now();
+        for (int i = 0; i < iterations; ++i)
+        {
+            queue.enqueueReadBuffer(buffer, CL_TRUE, 0, size, host.data());
+        }
+        seconds = ElapsedMs(start, Clock::now()) / 1000.0;
+        Report("read_bandwidth", std::to_string(size / 1024) + "KB",
+               (double)size * iterations / seconds / 1.0e9, "GB/s");
+    }
+}
+
+// Cold build compiles through clang; the warm build of identical source on a
+// fresh program object should come from the runtime's compile caches.
+static void BenchBuildProgram(cl::Context& context, cl::Device& device)
+{
+    // Unique source per run so "cold" isn't served by a previous process's
+    // disk cache entry.
+    std::string source = kKernelSource;
+    source += "// salt ";
+    source += std::to_string(Clock::now().time_since_epoch().count());
+    source += "\n";
+
+    auto start = Clock::now();
+    cl::Program cold(context, source);
+    cold.build();
+    Report("build_program", "cold", ElapsedMs(start, Clock::now()), "ms");
+
+    start = Clock::now();
+    cl::Program warm(context, source);
+    warm.build();
+    Report("build_program", "warm", ElapsedMs(start, Clock::now()), "ms");
+}
+
+int main()
+{
+    try
+    {
+        auto&& [context, device] = GetBenchContext();
+
+        cl::Program program(context, kKernelSource);
+        program.build();
+        cl::Kernel kernel(program, "add");
+
+        BenchEnqueueLatency(context, device, kernel);
+        BenchFlushCost(context, device, kernel);
+        BenchMapUnmap(context, device, kernel);
+        BenchTransferBandwidth(context, device);
+        BenchBuildProgram(context, device);
+    }
+    catch (cl::Error& e)
+    {
+        fprintf(stderr, "%s failed: %d\n", e.what(), e.err());
+        return 1;
+    }
+    return 0;
+}
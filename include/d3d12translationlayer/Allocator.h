@@ -82,12 +82,37 @@ namespace D3D12TranslationLayer
         
         HeapSuballocationBlock Allocate(UINT64 size)
         {
+            UINT order = CacheOrder(size);
+            if (order < MaxCachedOrders)
+            {
+                auto& cache = m_Caches[order];
+                auto cacheLock = std::lock_guard(cache.m_Lock);
+                if (cache.m_Count > 0)
+                {
+                    HeapSuballocationBlock block = cache.m_Blocks[--cache.m_Count];
+                    // Relabel with the requested size: both sizes round to this
+                    // order, so the buddy sees the order it handed out when the
+                    // block is eventually returned to it.
+                    return HeapSuballocationBlock(block.GetOffset(), size);
+                }
+            }
             auto scopedLock = std::lock_guard(m_Lock);
             return DisjointBuddyHeapAllocator::Allocate(size);
         }
 
         void Deallocate(const HeapSuballocationBlock &block)
         {
+            UINT order = CacheOrder(block.GetSize());
+            if (order < MaxCachedOrders)
+            {
+                auto& cache = m_Caches[order];
+                auto cacheLock = std::lock_guard(cache.m_Lock);
+                if (cache.m_Count < MaxCachedBlocksPerOrder)
+                {
+                    cache.m_Blocks[cache.m_Count++] = block;
+                    return;
+                }
+            }
             auto scopedLock = std::lock_guard(m_Lock);
             DisjointBuddyHeapAllocator::Deallocate(block);
         }
@@ -102,6 +127,33 @@ namespace D3D12TranslationLayer
         using DisjointBuddyHeapAllocator::IsOwner;
 
     private:
+        // Small caches of recently freed blocks, bucketed by buddy order, sit
+        // in front of the buddy structure. A hit touches only that order's
+        // lock and skips the buddy tree walk entirely, so concurrent queues
+        // streaming same-sized uploads stop serializing on m_Lock. Orders
+        // cover the suballocated range (alignment up through the 64KB
+        // conditional-allocator threshold), bounding pinned memory to
+        // MaxCachedBlocksPerOrder * ~128KB per allocator.
+        static UINT CacheOrder(UINT64 size) noexcept
+        {
+            UINT order = 0;
+            UINT64 orderSize = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+            while (orderSize < size)
+            {
+                orderSize <<= 1;
+                ++order;
+            }
+            return order;
+        }
+        static constexpr UINT MaxCachedOrders = 8;
+        static constexpr UINT MaxCachedBlocksPerOrder = 16;
+        struct OrderCache
+        {
+            std::mutex m_Lock;
+            UINT m_Count = 0;
+            HeapSuballocationBlock m_Blocks[MaxCachedBlocksPerOrder];
+        };
+        OrderCache m_Caches[MaxCachedOrders];
         mutable std::mutex m_Lock;
     };
 
@@ -30,6 +30,11 @@ namespace D3D12TranslationLayer
 
         void SubmitCommandList();
         void InitCommandList();
+        // Warm-up: seeds the allocator recycling pool with Count ready-to-use
+        // command allocators so steady-state submission never has to create
+        // one mid-stream. Intended to be called once at queue creation with
+        // the expected number of in-flight command lists.
+        void PreallocateCommandAllocators(UINT Count); // throw( _com_error )
         void ResetCommandList();
         void CloseCommandList() { CloseCommandList(nullptr); }
         void DiscardCommandList();
@@ -5,15 +5,19 @@
 #include "D3D12TranslationLayerDependencyIncludes.h"
 #include "Allocator.h"
 #include "CommandListManager.hpp"
+#include "Query.hpp"
 #include "Residency.h"
 #include "Resource.hpp"
 #include "ResourceState.hpp"
 #include "SubresourceHelpers.hpp"
 #include "Util.hpp"
 #include "View.hpp"
+#include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <functional>
 #include <queue>
+#include <thread>
 
 namespace D3D12TranslationLayer
 {
@@ -26,8 +30,14 @@ template <typename TResourceType, UINT64 ResourceSizeMultiple>
 class CMultiLevelPool
 {
 public:
-    CMultiLevelPool(UINT64 TrimThreshold, bool bLock)
+    // TrimThreshold is the fence age after which the per-submit trim starts
+    // freeing idle entries (one per size class per pump); MaxRetainedBytes
+    // caps the total bytes parked in the pool, freeing oldest-first past the
+    // cap (zero = uncapped). Under memory pressure Trim ignores the cap and
+    // drains everything the GPU is done with.
+    CMultiLevelPool(UINT64 TrimThreshold, UINT64 MaxRetainedBytes, bool bLock)
         : m_TrimThreshold(TrimThreshold)
+        , m_MaxRetainedBytes(MaxRetainedBytes)
     {
     }
 
@@ -41,7 +51,10 @@ public:
             m_MultiPool.resize(PoolIndex + 1);
         }
 
-        m_MultiPool[PoolIndex].ReturnToPool(std::move(Resource), FenceValue);
+        if (m_MultiPool[PoolIndex].ReturnToPool(std::move(Resource), FenceValue))
+        {
+            m_RetainedBytes.fetch_add((PoolIndex + 1) * ResourceSizeMultiple, std::memory_order_relaxed);
+        }
     }
 
     template <typename PFNCreateNew>
@@ -67,19 +80,60 @@ public:
         // m_Lock will be held during this potentially slow operation
         // This is not optimized because it is expected that once an app reaches steady-state
         // behavior, the pool will not need to grow.
-        return std::move(m_MultiPool[PoolIndex].RetrieveFromPool(CurrentFenceValue, pfnCreateNew, AlignedSize)); // throw( _com_error )
+        bool CreatedNew = false;
+        auto CountingCreateNew = [&](UINT64 CreateSize)
+        {
+            CreatedNew = true;
+            return pfnCreateNew(CreateSize);
+        };
+        TResourceType ret = std::move(m_MultiPool[PoolIndex].RetrieveFromPool(CurrentFenceValue, CountingCreateNew, AlignedSize)); // throw( _com_error )
+        if (!CreatedNew)
+        {
+            m_RetainedBytes.fetch_sub(AlignedSize, std::memory_order_relaxed);
+        }
+        return std::move(ret);
     }
 
-    void Trim(UINT64 CurrentFenceValue)
+    void Trim(UINT64 CurrentFenceValue, bool BudgetPressure)
     {
         auto Lock = std::lock_guard(m_Lock);
 
-        for (TPool& pool : m_MultiPool)
+        for (size_t i = 0; i < m_MultiPool.size(); ++i)
+        {
+            if (m_MultiPool[i].Trim(m_TrimThreshold, CurrentFenceValue))
+            {
+                m_RetainedBytes.fetch_sub((i + 1) * ResourceSizeMultiple, std::memory_order_relaxed);
+            }
+        }
+
+        // Byte cap, and on budget pressure a full drain: sweep the size
+        // classes freeing the oldest completed entry from each until the
+        // target is met or a sweep frees nothing (the rest is still in
+        // flight on the GPU and gets picked up by a later pump).
+        const UINT64 Target = BudgetPressure ? 0 : m_MaxRetainedBytes;
+        if (Target == 0 && !BudgetPressure)
         {
-            pool.Trim(m_TrimThreshold, CurrentFenceValue);
+            return;
+        }
+        bool Freed = true;
+        while (Freed && m_RetainedBytes.load(std::memory_order_relaxed) > Target)
+        {
+            Freed = false;
+            for (size_t i = 0; i < m_MultiPool.size() &&
+                 m_RetainedBytes.load(std::memory_order_relaxed) > Target; ++i)
+            {
+                if (m_MultiPool[i].TryTrimHead(CurrentFenceValue))
+                {
+                    m_RetainedBytes.fetch_sub((i + 1) * ResourceSizeMultiple, std::memory_order_relaxed);
+                    Freed = true;
+                }
+            }
         }
     }
 
+    // Gauge for telemetry; approximate (relaxed) but never perturbs the pool.
+    UINT64 GetRetainedBytes() const noexcept { return m_RetainedBytes.load(std::memory_order_relaxed); }
+
 protected:
     UINT IndexFromSize(UINT64 Size) noexcept { return (Size == 0) ? 0 : (UINT)((Size - 1) / ResourceSizeMultiple); }
 
@@ -91,6 +145,8 @@ protected:
     TMultiPool m_MultiPool;
     std::mutex m_Lock;
     UINT64 m_TrimThreshold;
+    UINT64 m_MaxRetainedBytes;
+    std::atomic<UINT64> m_RetainedBytes{ 0 };
 };
 
 typedef CMultiLevelPool<unique_comptr<ID3D12Resource>, 64*1024> TDynamicBufferPool;
@@ -501,6 +557,7 @@ public:
     }
 
     bool TrimDeletedObjects(bool deviceBeingDestroyed = false);
+    void ExtractReadyObjects(std::queue<RetiredD3D12Object> &objects, std::queue<RetiredSuballocationBlock> &suballocations);
     UINT64 GetFenceValueForObjectDeletion();
     UINT64 GetFenceValueForSuballocationDeletion();
 
@@ -522,6 +579,18 @@ public:
         }
     }
 
+    // Raw insertions used by ScopedDeferredDeletionBatch, which has already
+    // read the completed fence once for the whole batch and filtered out
+    // entries that could be destroyed immediately.
+    void AddRetiredObjectToQueue(RetiredD3D12Object &&object)
+    {
+        m_DeferredObjectDeletionQueue.push(std::move(object));
+    }
+    void AddRetiredSuballocationToQueue(RetiredSuballocationBlock &&block)
+    {
+        m_DeferredSuballocationDeletionQueue.push(std::move(block));
+    }
+
 private:
     bool SuballocationsReadyToBeDestroyed(bool deviceBeingDestroyed);
 
@@ -551,6 +620,30 @@ public:
     LockedAccess GetLocked() { return LockedAccess(m_CS, m_Obj); }
 };
 
+// Accumulates this thread's deferred-deletion queue insertions for the
+// lifetime of the scope and performs them in one pass when the outermost
+// scope closes: one queue-lock acquisition and one completed-fence read per
+// context, instead of one of each per released object. Bulk teardown paths -
+// an app releasing thousands of buffers back to back - open one of these
+// around the loop.
+class ScopedDeferredDeletionBatch
+{
+public:
+    ScopedDeferredDeletionBatch() noexcept;
+    ~ScopedDeferredDeletionBatch() noexcept;
+    ScopedDeferredDeletionBatch(ScopedDeferredDeletionBatch const&) = delete;
+    ScopedDeferredDeletionBatch& operator=(ScopedDeferredDeletionBatch const&) = delete;
+
+    // Called from the release paths below: returns true when an active batch
+    // on this thread took ownership of the entry. On failure (no batch, or no
+    // memory to grow the batch) the arguments are left untouched so the
+    // caller can fall back to the immediate path.
+    static bool Accumulate(ImmediateContext* pContext, ID3D12Object* pUnderlying,
+                           std::unique_ptr<ResidencyManagedObjectWrapper> &pResidencyHandle, UINT64 lastCommandListID) noexcept;
+    static bool Accumulate(ImmediateContext* pContext, HeapSuballocationBlock &block,
+                           ConditionalHeapAllocator &parentAllocator, UINT64 lastCommandListID) noexcept;
+};
+
 using RenameResourceSet = std::deque<unique_comptr<Resource>>;
 
 class ImmediateContext
@@ -573,16 +666,58 @@ private:
 
     // It is important that the deferred deletion queue manager gets destroyed last, place solely strict dependencies above.
     CLockedContainer<DeferredDeletionQueueManager> m_DeferredDeletionQueueManager;
+
+    // Background worker that destroys fence-retired objects and suballocations
+    // handed over by PostSubmitNotification, so submission paths don't pay for
+    // freeing thousands of D3D12 objects inline. Started on first use and
+    // joined in the destructor body, before any member it touches is destroyed.
+    // Everything the retired entries reach on destruction (residency manager,
+    // buffer pools, buddy allocators) takes its own lock.
+    std::mutex m_DeletionThreadMutex;
+    std::condition_variable m_DeletionThreadWake;
+    std::queue<RetiredD3D12Object> m_PendingDeletionObjects;
+    std::queue<RetiredSuballocationBlock> m_PendingDeletionSuballocations;
+    bool m_bDeletionThreadExit = false;
+    std::thread m_DeletionThread;
+
+    void DeletionThreadProc();
+    void QueueDeferredDeletions();
 public:
     friend class Query;
     friend class CommandListManager;
+    friend class ScopedDeferredDeletionBatch;
 
     class CreationArgs
     {
     public:
         CreationArgs() { ZeroMemory(this, sizeof(*this)); }
-        
+
         GUID CreatorID;
+
+        // Pre-sizing hints for the ring-buffer descriptor heaps, in
+        // descriptors. Zero means use the defaults. Values are clamped to
+        // [default, max heap size], so a hint can only grow the initial
+        // allocation; workloads that know their descriptor footprint can
+        // start at steady-state size instead of growing through rollovers.
+        UINT32 ViewHeapStartingCountHint;
+        UINT32 SamplerHeapStartingCountHint;
+
+        // D3D12_COMMAND_QUEUE_PRIORITY for the command queue created when the
+        // caller doesn't provide one; zero matches PRIORITY_NORMAL. Global
+        // realtime degrades to high if the process lacks the privilege.
+        INT CommandQueuePriority;
+
+        // Retention policy for the upload and readback buffer pools (each
+        // AllocatorHeapType has its own pool and is capped independently).
+        // BufferPoolTrimFenceAge is how many fence values a pooled buffer may
+        // sit idle before the per-submit trim frees it; zero means the
+        // default of 100. BufferPoolMaxRetainedBytes caps the bytes parked in
+        // each pool, freed oldest-first at submit boundaries so a long-idle
+        // service doesn't hoard retired staging memory; zero means uncapped.
+        // Independent of either setting, the pools drain completely while the
+        // residency manager reports the process over its OS memory budget.
+        UINT64 BufferPoolTrimFenceAge;
+        UINT64 BufferPoolMaxRetainedBytes;
     };
 
     ImmediateContext(D3D12_FEATURE_DATA_D3D12_OPTIONS& caps,
@@ -591,6 +726,21 @@ public:
 
     CreationArgs m_CreationArgs;
 
+    // Always-on telemetry for the layer above. Counters are monotonic,
+    // bumped with relaxed atomics on paths that already do far heavier work,
+    // and read without synchronization - readers get approximate totals,
+    // which is all fleet-level monitoring needs.
+    struct PerfCounters
+    {
+        std::atomic<UINT64> m_CommandListsSubmitted{ 0 };
+        std::atomic<UINT64> m_ResourceBarriers{ 0 };
+        std::atomic<UINT64> m_UploadHeapBytesAllocated{ 0 };
+        // Creations / acquisitions gives the dynamic buffer pool miss rate.
+        std::atomic<UINT64> m_PoolBufferAcquisitions{ 0 };
+        std::atomic<UINT64> m_PoolBufferCreations{ 0 };
+    };
+    PerfCounters m_PerfCounters;
+
     CommandListManager *GetCommandListManager() noexcept;
     ID3D12CommandList *GetCommandList() noexcept;
     UINT64 GetCommandListID() noexcept;
@@ -612,6 +762,8 @@ public:
     void AdditionalCommandsAdded() noexcept;
     void UploadHeapSpaceAllocated(UINT64 HeapSize) noexcept;
 
+    TimestampQueryPool& GetTimestampQueryPool() noexcept { return m_TimestampQueryPool; }
+
     unique_comptr<ID3D12Resource> AllocateHeap(UINT64 HeapSize, UINT64 alignment, AllocatorHeapType heapType) noexcept(false);
     void ClearState() noexcept;
 
@@ -624,6 +776,10 @@ public:
 
     unique_comptr<ID3D12Resource> AcquireTransitionableUploadBuffer(AllocatorHeapType HeapType, UINT64 Size) noexcept(false);
 
+    // Bytes currently parked in the given dynamic buffer pool; a gauge for
+    // the telemetry counters, approximate like the rest of PerfCounters.
+    UINT64 GetPoolRetainedBytes(AllocatorHeapType HeapType) noexcept { return GetBufferPool(HeapType).GetRetainedBytes(); }
+
     void ReturnTransitionableBufferToPool(AllocatorHeapType HeapType, UINT64 Size, unique_comptr<ID3D12Resource>&&spResource, UINT64 FenceValue) noexcept;
 
     D3D12ResourceSuballocation AcquireSuballocatedHeapForResource(_In_ Resource* pResource, ResourceAllocationContext threadingContext) noexcept(false);
@@ -733,6 +889,7 @@ public:
 public:
     
     void Dispatch( UINT, UINT, UINT );
+    void DispatchIndirect( ID3D12CommandSignature* pCommandSignature, UINT NumDispatches, ID3D12Resource* pArgumentBuffer, UINT64 ArgumentBufferOffset );
 
     // Returns if any work was actually submitted
     bool Flush();
@@ -847,6 +1004,10 @@ public: // variables
         UINT m_DescriptorSize;
         UINT m_BitsToSetOnNewHeap = 0;
         UINT m_MaxHeapSize;
+        // Rollovers observed while recording the current command list; reset
+        // at each submit boundary and used to decide whether to grow the heap
+        // there instead of mid-list.
+        UINT m_NumRollovers = 0;
 
         CFencedRingBuffer m_DescriptorRingBuffer;
 
@@ -863,6 +1024,7 @@ public: // variables
     } m_ViewHeap, m_SamplerHeap;
 
     void RollOverHeap(OnlineDescriptorHeap& Heap) noexcept(false);
+    void GrowHeapAtSubmitBoundary(OnlineDescriptorHeap& Heap) noexcept;
     UINT ReserveSlotsForBindings(OnlineDescriptorHeap& Heap, UINT (ImmediateContext::*pfnCalcRequiredSlots)()) noexcept(false);
     UINT ReserveSlots(OnlineDescriptorHeap& Heap, UINT NumSlots) noexcept(false);
 
@@ -892,7 +1054,8 @@ private: // variables
     unique_comptr<Resource> m_pStagingBuffer;
 
 private: // Dynamic/staging resource pools
-    const UINT64 m_BufferPoolTrimThreshold = 100;
+    static constexpr UINT64 cDefaultBufferPoolTrimThreshold = 100;
+    const UINT64 m_BufferPoolTrimThreshold;
     TDynamicBufferPool m_UploadBufferPool;
     TDynamicBufferPool m_ReadbackBufferPool;
     TDynamicBufferPool& GetBufferPool(AllocatorHeapType HeapType)
@@ -940,6 +1103,10 @@ private: // Dynamic/staging resource pools
 private:
     D3D12_FEATURE_DATA_D3D12_OPTIONS m_caps;
     const bool m_bUseRingBufferDescriptorHeaps;
+
+    // Declared after the suballocators so its pages can be released into
+    // them during destruction.
+    TimestampQueryPool m_TimestampQueryPool{ this };
 };
 
 DEFINE_ENUM_FLAG_OPERATORS(ImmediateContext::UpdateSubresourcesFlags);
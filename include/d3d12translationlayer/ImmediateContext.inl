@@ -46,6 +46,17 @@ inline void  ImmediateContext::Dispatch(UINT x, UINT y, UINT z)
     catch (_com_error) {} // already handled, but can't touch the command list
 }
 
+//----------------------------------------------------------------------------------------------------------------------------------
+inline void  ImmediateContext::DispatchIndirect(ID3D12CommandSignature* pCommandSignature, UINT NumDispatches, ID3D12Resource* pArgumentBuffer, UINT64 ArgumentBufferOffset)
+{
+    try
+    {
+        GetGraphicsCommandList()->ExecuteIndirect(pCommandSignature, NumDispatches, pArgumentBuffer, ArgumentBufferOffset, nullptr, 0);
+        PostDispatch();
+    }
+    catch (_com_error) {} // already handled, but can't touch the command list
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------
 inline ID3D12CommandQueue *ImmediateContext::GetCommandQueue() noexcept
 {
@@ -17,6 +17,10 @@ namespace D3D12TranslationLayer
         PipelineState(ImmediateContext *pContext, const D3D12_SHADER_BYTECODE &CS, RootSignature *pRS, D3D12_CACHED_PIPELINE_STATE Cached = {});
         ~PipelineState();
 
+        // False if a cached blob was provided but rejected by the runtime/driver,
+        // in which case the pipeline was recompiled from bytecode.
+        bool UsedCachedBlob() const { return m_Desc.CachedPSO.pCachedBlob != nullptr; }
+
         using DeviceChildImpl::GetForUse;
         using DeviceChildImpl::GetForImmediateUse;
 
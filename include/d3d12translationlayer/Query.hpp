@@ -5,9 +5,69 @@
 #include "D3D12TranslationLayerDependencyIncludes.h"
 #include "DeviceChild.hpp"
 #include "Resource.hpp"
+#include <mutex>
+#include <vector>
 
 namespace D3D12TranslationLayer
 {
+    // Hands out timestamp query slots suballocated from pooled query heaps,
+    // each page backed by a readback buffer for the resolved results. Queries
+    // that were ended on the current command list are resolved in one batch
+    // when that command list is submitted, rather than one resolve per query.
+    class TimestampQueryPool
+    {
+    public:
+        struct Slot
+        {
+            UINT PageIndex = UINT_MAX;
+            UINT Index = 0;
+            bool IsValid() const noexcept { return PageIndex != UINT_MAX; }
+        };
+
+        TimestampQueryPool(ImmediateContext* pParent) noexcept
+            : m_pParent(pParent)
+        {
+        }
+        ~TimestampQueryPool() noexcept;
+
+        Slot AcquireSlot() noexcept(false);
+        void ReleaseSlot(Slot slot, UINT64 LastUsedCommandListID) noexcept;
+
+        // Records an EndQuery for the slot and defers its resolve to the
+        // batch issued when the current command list is submitted.
+        void EndQuery(Slot slot) noexcept;
+        // Issues the batched ResolveQueryData calls for every query ended on
+        // the command list that is about to be submitted.
+        void ResolvePendingQueries() noexcept;
+
+        UINT64 GetData(Slot slot) noexcept;
+
+        static constexpr UINT c_PageSize = 256;
+
+    private:
+        struct Page
+        {
+            unique_comptr<ID3D12QueryHeap> spQueryHeap;
+            D3D12ResourceSuballocation ResultBuffer;
+            // Readback buffers stay persistently mapped, so harvesting a
+            // result after fence completion is a single read rather than a
+            // Map/Unmap pair per query.
+            void* pMappedResults = nullptr;
+        };
+        struct DeferredSlot
+        {
+            Slot slot;
+            UINT64 FenceValue;
+        };
+
+        ImmediateContext* const m_pParent;
+        std::mutex m_Lock;
+        std::vector<Page> m_Pages;
+        std::vector<Slot> m_FreeSlots;
+        std::vector<DeferredSlot> m_DeferredFreeSlots;
+        std::vector<Slot> m_PendingResolves;
+    };
+
     class TimestampQuery : public DeviceChild
     {
     public:
@@ -18,7 +78,6 @@ namespace D3D12TranslationLayer
         UINT64 GetData() noexcept;
 
     private:
-        unique_comptr<ID3D12QueryHeap> m_spQueryHeap;
-        D3D12ResourceSuballocation m_spResultBuffer;
+        TimestampQueryPool::Slot m_Slot;
     };
-};
\ No newline at end of file
+};
@@ -4,10 +4,13 @@
 
 #include "D3D12TranslationLayerDependencyIncludes.h"
 #include "Util.hpp"
+#include <algorithm>
 #include <mutex>
 
 namespace D3D12TranslationLayer
 {
+    namespace Internal { class LRUCache; }
+
     // Used to contain waits that must be satisfied before a pinned ManagedObject can be unpinned.
     class PinWaits
     {
@@ -58,6 +61,8 @@ namespace D3D12TranslationLayer
         std::vector<PinWait> m_pinWaits;
     };
 
+    class ResidencySet;
+
     // Used to track meta data for each object the app potentially wants
     // to make resident or evict.
     class ManagedObject
@@ -115,6 +120,11 @@ namespace D3D12TranslationLayer
         // Pinning an object prevents eviction.  Callers must seperately make resident as usual.
         UINT32 PinCount = 0;
 
+        // Back-link to the persistent residency set this object belongs to,
+        // if any. This layer drives one queue (command list index 0) per
+        // context, so an object is a member of at most one set.
+        ResidencySet* pPersistentSet = nullptr;
+
         PinWaits m_pinWaits;
     };
 
@@ -131,7 +141,10 @@ namespace D3D12TranslationLayer
         ResidencySet() = default;
         ~ResidencySet() = default;
 
-        // Returns true if the object was inserted, false otherwise
+        // Returns true if the object was inserted, false otherwise.
+        // For persistent sets, callers must hold the residency manager's
+        // mutex (see ResidencyManager::AddToResidencySet) - membership is
+        // shared with the trim and eviction paths.
         inline bool Insert(ManagedObject* pObject)
         {
             assert(CommandListIndex != InvalidIndex);
@@ -141,6 +154,11 @@ namespace D3D12TranslationLayer
             {
                 pObject->CommandListsUsedOn[CommandListIndex] = true;
                 Set.push_back(pObject);
+                if (bPersistent)
+                {
+                    pObject->pPersistentSet = this;
+                    Delta.push_back(pObject);
+                }
 
                 return true;
             }
@@ -158,19 +176,101 @@ namespace D3D12TranslationLayer
             Set.clear();
         }
 
+        // Incremental mode: the set outlives individual command lists, so
+        // steady-state workloads that reference the same resources every
+        // submission keep their membership and the paging work per submit
+        // walks only the delta (new members plus members evicted since the
+        // last submit) instead of re-marking every object.
+        void OpenPersistent(UINT commandListType)
+        {
+            assert(Set.empty());
+            Open(commandListType);
+            bPersistent = true;
+        }
+
+        bool IsPersistent() const { return bPersistent; }
+
+        // For transient sets this just unmarks the members; the Set vector is
+        // left intact for the paging walk that follows and is reset on the
+        // next Open. Closing a persistent set dissolves its membership
+        // entirely and must happen under the residency manager's mutex (see
+        // ResidencyManager::CloseResidencySet).
         void Close()
         {
             for (auto pObject : Set)
             {
                 pObject->CommandListsUsedOn[CommandListIndex] = false;
+                if (bPersistent)
+                {
+                    pObject->pPersistentSet = nullptr;
+                }
+            }
+            if (bPersistent)
+            {
+                Set.clear();
+                Delta.clear();
+                EvictedMembers.clear();
+                bPersistent = false;
+                bNeedsFullWalk = false;
             }
 
             CommandListIndex = InvalidIndex;
         }
 
+        // Drops a member, e.g. when its object stops being tracked. Callers
+        // hold the residency manager's mutex. Removal is O(members) but only
+        // runs per destruction, not per submit.
+        void Remove(ManagedObject* pObject)
+        {
+            auto EraseFrom = [pObject](std::vector<ManagedObject*>& v)
+            {
+                auto iter = std::find(v.begin(), v.end(), pObject);
+                if (iter != v.end())
+                {
+                    *iter = v.back();
+                    v.pop_back();
+                }
+            };
+            EraseFrom(Set);
+            EraseFrom(Delta);
+            EraseFrom(EvictedMembers);
+            pObject->CommandListsUsedOn[CommandListIndex] = false;
+            pObject->pPersistentSet = nullptr;
+        }
+
+        // Called (under the residency manager's lock) when a member is
+        // evicted, so the next submit makes it resident again without
+        // walking the whole set.
+        void NotifyEvicted(ManagedObject* pObject) noexcept
+        {
+            try
+            {
+                EvictedMembers.push_back(pObject);
+            }
+            catch (std::bad_alloc&)
+            {
+                // Can't record the delta; have the next submit walk the
+                // full set once instead.
+                bNeedsFullWalk = true;
+            }
+        }
+
     private:
         UINT32 CommandListIndex = InvalidIndex;
         std::vector<ManagedObject*> Set;
+
+        bool bPersistent = false;
+        bool bNeedsFullWalk = false;
+        // New members since the last submit.
+        std::vector<ManagedObject*> Delta;
+        // Members evicted since the last submit.
+        std::vector<ManagedObject*> EvictedMembers;
+        // Every member counts as used at the set's last submission; the trim
+        // paths consult these instead of per-object stamps for members.
+        UINT64 LastSubmittedFenceValue = 0;
+        UINT64 LastSubmittedTimestamp = 0;
+
+        friend class Internal::LRUCache;
     };
 
     namespace Internal
@@ -287,6 +387,13 @@ namespace D3D12TranslationLayer
                 NumResidentObjects--;
                 ResidentSize -= pObject->Size;
                 NumEvictedObjects++;
+
+                // All Evict callers hold the residency manager's mutex, which
+                // also guards the set's evicted-member list.
+                if (pObject->pPersistentSet)
+                {
+                    pObject->pPersistentSet->NotifyEvicted(pObject);
+                }
             }
 
             // Evict all of the resident objects used in sync points up to the specficied one (inclusive)
@@ -320,6 +427,7 @@ namespace D3D12TranslationLayer
             ImmCtx(ImmCtx)
         {
         }
+        ~ResidencyManager();
 
         HRESULT Initialize(IDXCoreAdapter* ParentAdapterDXCore);
 
@@ -338,9 +446,37 @@ namespace D3D12TranslationLayer
         {
             std::lock_guard Lock(Mutex);
 
+            if (pObject->pPersistentSet)
+            {
+                pObject->pPersistentSet->Remove(pObject);
+            }
             LRU.Remove(pObject);
         }
 
+        // Persistent-set membership is shared with the trim and eviction
+        // paths, so changes to it take the residency lock. The unsynchronized
+        // fast path is safe: the flag for an object is only written by the
+        // thread inserting it, or while dropping membership on destruction -
+        // which can't race an insert of the same (still referenced) object.
+        void AddToResidencySet(ResidencySet* pSet, ManagedObject* pObject)
+        {
+            if (pObject->CommandListsUsedOn[pSet->CommandListIndex])
+            {
+                return;
+            }
+
+            std::lock_guard Lock(Mutex);
+            pSet->Insert(pObject);
+        }
+
+        // Dissolves a persistent set's membership without racing the
+        // budget-change trim thread.
+        void CloseResidencySet(ResidencySet* pSet)
+        {
+            std::lock_guard Lock(Mutex);
+            pSet->Close();
+        }
+
         // One residency set per command-list
         HRESULT ExecuteCommandList(ID3D12CommandQueue* Queue, UINT CommandListIndex, ID3D12CommandList* CommandList, ResidencySet* pMasterSet)
         {
@@ -361,6 +497,16 @@ namespace D3D12TranslationLayer
             return PrepareToExecuteMasterSet(Queue, CommandListIndex, pMasterSet);
         }
 
+        // Whether the latest budget snapshot (refreshed by the paging work on
+        // each submission and by the OS budget-change callback) has this
+        // process over its memory budget. Cheap enough for per-submit policy
+        // decisions like draining the staging buffer pools.
+        bool IsOverBudget()
+        {
+            std::lock_guard Lock(Mutex);
+            return CachedBudget.budget != 0 && CachedBudget.currentUsage > CachedBudget.budget;
+        }
+
     private:
         HRESULT PrepareToExecuteMasterSet(ID3D12CommandQueue* Queue, UINT CommandListIndex, ResidencySet* pMasterSet)
         {
@@ -394,6 +540,12 @@ namespace D3D12TranslationLayer
 
         void GetCurrentBudget(UINT64 Timestamp, DXCoreAdapterMemoryBudget* InfoOut);
 
+        // Invoked by DXCore on its notification thread whenever the OS changes
+        // this process's memory budget, so eviction happens off the submitting
+        // thread instead of stalling the next ExecuteCommandList.
+        static void STDMETHODCALLTYPE BudgetChangeCallback(DXCoreNotificationType, IUnknown*, void* pContext);
+        void TrimOnBudgetChange();
+
         // Generate a result between the minimum period and the maximum period based on the current
         // local memory pressure. I.e. when memory pressure is low, objects will persist longer before
         // being evicted.
@@ -423,6 +575,9 @@ namespace D3D12TranslationLayer
 
         CComPtr<ID3D12Device3> Device;
         IDXCoreAdapter* AdapterDXCore = nullptr;
+        CComPtr<IDXCoreAdapterFactory> AdapterFactory;
+        uint32_t BudgetNotificationCookie = 0;
+        bool BudgetNotificationRegistered = false;
         Internal::LRUCache LRU;
 
         std::mutex Mutex;
@@ -435,7 +590,7 @@ namespace D3D12TranslationLayer
         // (valid between 0.0 - 1.0)
         static constexpr float cTrimPercentageMemoryUsageThreshold = 0.7f;
 
-        DXCoreAdapterMemoryBudget CachedBudget;
+        DXCoreAdapterMemoryBudget CachedBudget = {};
         static constexpr float cBudgetQueryPeriod = 1.0f;
         UINT64 BudgetQueryPeriodTicks;
         UINT64 LastBudgetTimestamp = 0;
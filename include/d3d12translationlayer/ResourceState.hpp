@@ -174,9 +174,49 @@ constexpr D3D12_RESOURCE_STATES RESOURCE_STATE_ALL_WRITE_BITS =
         // Submit all barriers
         void ApplyAllResourceTransitions() noexcept(false);
 
+        // Begin a split transition toward State, to be ended at the resource's
+        // next use (or at command list submission if none arrives). Transitions
+        // here are resolved lazily at the next use, so the begin half of a
+        // BEGIN_ONLY/END_ONLY pair has to come from a caller that knows at
+        // record time what that next use will want - e.g. a readback copy whose
+        // source returns to UAV for the next dispatch. The GPU can then overlap
+        // the transition with unrelated work recorded in between, instead of
+        // draining at a full barrier when the use arrives. Purely a hint: no-op
+        // when the resource has a transition pending, is tracked
+        // per-subresource, supports simultaneous access, or is already in
+        // State. If the next use wants something else, it pays the END plus a
+        // regular transition.
+        void BeginTransition(Resource* pResource, D3D12_RESOURCE_STATES State) noexcept;
+
+        // Ends any split transitions still open, updating tracked state to the
+        // begin's after-state. Called before the command list closes so no
+        // BEGIN_ONLY ships without its END_ONLY.
+        void FlushPendingSplitBarriers(CommandListManager* pManager) noexcept;
+
+        // Detaches a dying resource from its pending split, if any. The END
+        // still reaches the command list (the underlying allocation outlives
+        // the layer object via deferred deletion), but there is no identity
+        // left to update, and the slot must not match a new resource recycled
+        // at the same address.
+        void ResourceDestroyed(Resource* pResource) noexcept;
+
     private:
         LIST_ENTRY m_TransitionListHead;
         std::vector<D3D12_RESOURCE_BARRIER> m_vResourceBarriers;
+        // Split transitions begun but not yet ended, at most one per resource.
+        struct PendingSplitBarrier
+        {
+            Resource* pOwner; // Null once the owning resource is destroyed.
+            ID3D12Resource* pResource;
+            D3D12_RESOURCE_STATES StateBefore;
+            D3D12_RESOURCE_STATES StateAfter;
+        };
+        std::vector<PendingSplitBarrier> m_vPendingSplitBarriers;
+        // Set while processing transitions when a subresource is re-requested in a
+        // write state it was already left in by earlier work in the same command
+        // list. No transition is emitted in that case, so a single UAV barrier is
+        // folded into the batch to order the accesses instead.
+        bool m_bInsertUAVBarrier = false;
 
         // These methods set the destination state of the resource/subresources and ensure it's in the transition list.
         void TransitionResource(TransitionableResourceBase &Resource,
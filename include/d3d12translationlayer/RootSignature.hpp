@@ -8,6 +8,15 @@
 
 namespace D3D12TranslationLayer
 {
+    // Layout of one entry in the argument buffer consumed by the dispatch
+    // command signature: rebinds the work properties root CBV, then issues
+    // the dispatch.
+    struct DispatchIndirectCommand
+    {
+        D3D12_GPU_VIRTUAL_ADDRESS WorkPropertiesCbv;
+        D3D12_DISPATCH_ARGUMENTS Dispatch;
+    };
+
     class RootSignature : protected DeviceChildImpl<ID3D12RootSignature>
     {
     public:
@@ -15,10 +24,23 @@ namespace D3D12TranslationLayer
             : DeviceChildImpl(pParent)
         {
         }
+        ~RootSignature()
+        {
+            AddToDeferredDeletionQueue(m_spDispatchCommandSignature);
+        }
 
         void Create(D3D12_VERSIONED_ROOT_SIGNATURE_DESC const& rootDesc) noexcept(false);
         void Create(const void* pBlob, SIZE_T BlobSize) noexcept(false);
         using DeviceChildImpl::GetForUse;
         using DeviceChildImpl::GetForImmediateUse;
+
+        // Lazily creates (then caches) the command signature used to record a
+        // tiled dispatch as a single ExecuteIndirect over an array of
+        // DispatchIndirectCommand entries. It changes a root parameter, so it
+        // is tied to this root signature.
+        ID3D12CommandSignature* GetDispatchCommandSignature(UINT WorkPropertiesRootParam) noexcept(false);
+
+    private:
+        unique_comptr<ID3D12CommandSignature> m_spDispatchCommandSignature;
     };
 };
@@ -493,17 +493,21 @@ namespace D3D12TranslationLayer
     class CFencePool
     {
     public:
-        void ReturnToPool(TResourceType&& Resource, UINT64 FenceValue) noexcept
+        // Returns whether the resource was actually pooled (callers that
+        // account for pooled bytes need to know about the drop-on-bad_alloc).
+        bool ReturnToPool(TResourceType&& Resource, UINT64 FenceValue) noexcept
         {
             try
             {
                 auto lock = m_pLock ? std::unique_lock(*m_pLock) : std::unique_lock<std::mutex>();
                 m_Pool.emplace_back(FenceValue, std::move(Resource)); // throw( bad_alloc )
+                return true;
             }
             catch (std::bad_alloc&)
             {
                 // Just drop the error
                 // All uses of this pool use unique_comptr, which will release the resource
+                return false;
             }
         }
 
@@ -523,7 +527,7 @@ namespace D3D12TranslationLayer
             return std::move(ret);
         }
 
-        void Trim(UINT64 TrimThreshold, UINT64 CurrentFenceValue)
+        bool Trim(UINT64 TrimThreshold, UINT64 CurrentFenceValue)
         {
             auto lock = m_pLock ? std::unique_lock(*m_pLock) : std::unique_lock<std::mutex>();
 
@@ -531,7 +535,7 @@ namespace D3D12TranslationLayer
 
             if (Head == m_Pool.end() || (CurrentFenceValue < Head->first))
             {
-                return;
+                return false;
             }
 
             UINT64 difference = CurrentFenceValue - Head->first;
@@ -541,7 +545,17 @@ namespace D3D12TranslationLayer
                 // only erase one item per 'pump'
                 assert(Head->second);
                 m_Pool.erase(Head);
+                return true;
             }
+            return false;
+        }
+
+        // Frees the oldest entry if the GPU is done with it, regardless of
+        // age. Used by byte-cap and budget-pressure trimming, which keep
+        // calling until the pool is small enough or nothing is freeable.
+        bool TryTrimHead(UINT64 CurrentFenceValue)
+        {
+            return Trim(0, CurrentFenceValue);
         }
 
         CFencePool(bool bLock = false) noexcept
@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 namespace XPlatHelpers
 {
 #ifdef _WIN32
@@ -80,6 +83,65 @@ namespace XPlatHelpers
         operator bool() const { return m_event != InvalidEvent; }
     };
 
+    // An auto-reset event checked out of a process-wide pool instead of
+    // created fresh. Short-lived wait points (one wait, then destruction)
+    // otherwise pay a create and a close syscall each; checkout and return
+    // are a mutex-protected vector push/pop in steady state. Events are
+    // drained on return, so a handle that was signaled but never waited on
+    // can't leak its signal into the next checkout. Default construction is
+    // free - call checkout() only once it's known a wait is actually needed.
+    class pooled_event
+    {
+        unique_event m_Event;
+
+        static std::vector<unique_event>& Pool(std::unique_lock<std::mutex>& lock)
+        {
+            static std::mutex s_Lock;
+            static std::vector<unique_event> s_Pool;
+            lock = std::unique_lock(s_Lock);
+            return s_Pool;
+        }
+        static constexpr size_t MaxPooledEvents = 32;
+
+    public:
+        pooled_event() = default;
+        pooled_event(pooled_event const&) = delete;
+        pooled_event& operator=(pooled_event const&) = delete;
+        ~pooled_event()
+        {
+            if (!m_Event)
+            {
+                return;
+            }
+            // Consume a pending signal so the next checkout starts unsignaled.
+            m_Event.poll();
+            std::unique_lock<std::mutex> lock;
+            auto& pool = Pool(lock);
+            if (pool.size() < MaxPooledEvents)
+            {
+                try { pool.push_back(std::move(m_Event)); } catch (std::bad_alloc&) {}
+            }
+            // On overflow (or allocation failure) the event is simply closed.
+        }
+        void checkout()
+        {
+            {
+                std::unique_lock<std::mutex> lock;
+                auto& pool = Pool(lock);
+                if (!pool.empty())
+                {
+                    m_Event = std::move(pool.back());
+                    pool.pop_back();
+                    return;
+                }
+            }
+            m_Event.create();
+        }
+        void set() const { m_Event.set(); }
+        void wait() const { m_Event.wait(); }
+        operator bool() const { return static_cast<bool>(m_Event); }
+    };
+
     // This class relies on the fact that modules are void* in both, and using the same Windows API names in the Linux Windows.h.
     class unique_module
     {
@@ -4,6 +4,7 @@
 #include "compiler.hpp"
 #include "platform.hpp"
 #include <dxc/dxcapi.h>
+#include <stdexcept>
 
 void Logger::Log(const char *msg) const
 {
@@ -86,6 +87,161 @@ std::vector<ProgramBinary::Kernel> const& ProgramBinary::GetKernelInfo() const
     return m_KernelInfo;
 }
 
+// Layout of the serialized metadata section, all uint32 fields:
+//   NumKernels, TotalArgs, NumSpecConstants, StringTableBytes
+//   per kernel:        NameOffset, NumArgs, VecHintSize, VecHintType
+//   per arg, in order: NameOffset, TypeNameOffset, Flags, AddressQualifier
+//   per spec constant: ID, ValueSize
+// followed by the string table. Offsets index into the string table;
+// c_NullString marks a null pointer.
+static constexpr uint32_t c_NullString = ~0u;
+static constexpr uint32_t c_ArgReadable = 1, c_ArgWritable = 2,
+    c_ArgConst = 4, c_ArgRestrict = 8, c_ArgVolatile = 16;
+
+std::vector<uint8_t> ProgramBinary::SerializeKernelInfo() const
+{
+    std::vector<char> strings;
+    auto AddString = [&strings](const char* str) -> uint32_t
+    {
+        if (!str)
+            return c_NullString;
+        uint32_t offset = (uint32_t)strings.size();
+        strings.insert(strings.end(), str, str + strlen(str) + 1);
+        return offset;
+    };
+
+    size_t totalArgs = 0;
+    for (auto& kernel : m_KernelInfo)
+        totalArgs += kernel.args.size();
+
+    std::vector<uint32_t> words;
+    words.reserve(4 + m_KernelInfo.size() * 4 + totalArgs * 4 + m_SpecConstants.size() * 2);
+    words.push_back((uint32_t)m_KernelInfo.size());
+    words.push_back((uint32_t)totalArgs);
+    words.push_back((uint32_t)m_SpecConstants.size());
+    words.push_back(0); // String table size, patched below
+
+    for (auto& kernel : m_KernelInfo)
+    {
+        words.push_back(AddString(kernel.name));
+        words.push_back((uint32_t)kernel.args.size());
+        words.push_back(kernel.vec_hint_size);
+        words.push_back((uint32_t)kernel.vec_hint_type);
+    }
+    for (auto& kernel : m_KernelInfo)
+    {
+        for (auto& arg : kernel.args)
+        {
+            words.push_back(AddString(arg.name));
+            words.push_back(AddString(arg.type_name));
+            words.push_back((arg.readable ? c_ArgReadable : 0) |
+                            (arg.writable ? c_ArgWritable : 0) |
+                            (arg.is_const ? c_ArgConst : 0) |
+                            (arg.is_restrict ? c_ArgRestrict : 0) |
+                            (arg.is_volatile ? c_ArgVolatile : 0));
+            words.push_back((uint32_t)arg.address_qualifier);
+        }
+    }
+    for (auto& [id, info] : m_SpecConstants)
+    {
+        words.push_back(id);
+        words.push_back(info.value_size);
+    }
+    words[3] = (uint32_t)strings.size();
+
+    std::vector<uint8_t> blob(words.size() * sizeof(uint32_t) + strings.size());
+    memcpy(blob.data(), words.data(), words.size() * sizeof(uint32_t));
+    memcpy(blob.data() + words.size() * sizeof(uint32_t), strings.data(), strings.size());
+    return blob;
+}
+
+bool ProgramBinary::DeserializeKernelInfo(const void* data, size_t size)
+{
+    // The caller's pointer has no alignment guarantee; stage the word section
+    // through an aligned copy before reading.
+    if (size < 4 * sizeof(uint32_t))
+        return false;
+    uint32_t counts[4];
+    memcpy(counts, data, sizeof(counts));
+    const uint32_t numKernels = counts[0], totalArgs = counts[1],
+        numSpecConstants = counts[2], stringBytes = counts[3];
+
+    const size_t numWords = 4 + (size_t)numKernels * 4 + (size_t)totalArgs * 4 + (size_t)numSpecConstants * 2;
+    if (size < numWords * sizeof(uint32_t) ||
+        size - numWords * sizeof(uint32_t) < stringBytes)
+        return false;
+
+    std::vector<uint32_t> words(numWords);
+    memcpy(words.data(), data, numWords * sizeof(uint32_t));
+    std::vector<char> strings(reinterpret_cast<const char*>(data) + numWords * sizeof(uint32_t),
+                              reinterpret_cast<const char*>(data) + numWords * sizeof(uint32_t) + stringBytes);
+    if (stringBytes && strings.back() != '\0')
+        return false;
+
+    auto GetString = [&strings, stringBytes](uint32_t offset) -> const char*
+    {
+        if (offset == c_NullString)
+            return nullptr;
+        if (offset >= stringBytes)
+            throw std::out_of_range("String offset out of range");
+        return strings.data() + offset;
+    };
+
+    try
+    {
+        std::vector<Kernel> kernels;
+        kernels.reserve(numKernels);
+        std::unordered_map<uint32_t, SpecConstantInfo> specConstants;
+        size_t kernelWord = 4, argWord = 4 + (size_t)numKernels * 4, argsSeen = 0;
+        for (uint32_t i = 0; i < numKernels; ++i, kernelWord += 4)
+        {
+            Kernel info;
+            info.name = GetString(words[kernelWord]);
+            if (!info.name)
+                return false;
+            info.vec_hint_size = words[kernelWord + 2];
+            info.vec_hint_type = (Kernel::VecHintType)words[kernelWord + 3];
+
+            const uint32_t numArgs = words[kernelWord + 1];
+            if (argsSeen + numArgs > totalArgs)
+                return false;
+            argsSeen += numArgs;
+            info.args.reserve(numArgs);
+            for (uint32_t j = 0; j < numArgs; ++j, argWord += 4)
+            {
+                Kernel::Arg arg;
+                arg.name = GetString(words[argWord]);
+                arg.type_name = GetString(words[argWord + 1]);
+                const uint32_t flags = words[argWord + 2];
+                arg.readable = (flags & c_ArgReadable) != 0;
+                arg.writable = (flags & c_ArgWritable) != 0;
+                arg.is_const = (flags & c_ArgConst) != 0;
+                arg.is_restrict = (flags & c_ArgRestrict) != 0;
+                arg.is_volatile = (flags & c_ArgVolatile) != 0;
+                arg.address_qualifier = (Kernel::Arg::AddressSpace)words[argWord + 3];
+                info.args.push_back(arg);
+            }
+            kernels.push_back(std::move(info));
+        }
+        size_t specWord = 4 + (size_t)numKernels * 4 + (size_t)totalArgs * 4;
+        for (uint32_t i = 0; i < numSpecConstants; ++i, specWord += 2)
+        {
+            specConstants.emplace(words[specWord], SpecConstantInfo{ words[specWord + 1] });
+        }
+
+        // Committing the string store by move keeps the heap buffer (and so
+        // every name pointer taken above) valid.
+        m_KernelInfoStrings = std::move(strings);
+        m_KernelInfo = std::move(kernels);
+        m_SpecConstants = std::move(specConstants);
+        return true;
+    }
+    catch (std::out_of_range&)
+    {
+        return false;
+    }
+}
+
 const ProgramBinary::SpecConstantInfo *ProgramBinary::GetSpecConstantInfo(uint32_t ID) const
 {
     auto iter = m_SpecConstants.find(ID);
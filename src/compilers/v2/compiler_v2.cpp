@@ -8,6 +8,7 @@
 #include "cache.hpp"
 
 #include <dxcapi.h>
+#include <future>
 
 template <typename T>
 struct unique_object : public T
@@ -68,6 +69,11 @@ public:
     virtual std::byte * CopyWorkProperties(std::byte *WorkPropertiesBuffer, WorkProperties const& props) const final;
     virtual size_t GetWorkPropertiesChunkSize() const final;
     virtual uint64_t GetVersionForCache() const final;
+
+private:
+    // One clc_link_spirv invocation over a set of objects; the result is
+    // not yet parsed.
+    std::unique_ptr<ProgramBinary> LinkOnePass(std::vector<ProgramBinary const*> const& objs, bool create_library, Logger const& logger) const;
 };
 
 class ProgramBinaryV2 : public ProgramBinary
@@ -252,17 +258,17 @@ std::unique_ptr<ProgramBinary> CompilerV2::Compile(CompileArgs const& args, Logg
     return std::make_unique<ProgramBinaryV2>(std::move(obj));
 }
 
-std::unique_ptr<ProgramBinary> CompilerV2::Link(LinkerArgs const& args, Logger const& logger) const
+std::unique_ptr<ProgramBinary> CompilerV2::LinkOnePass(std::vector<ProgramBinary const*> const& objs, bool create_library, Logger const& logger) const
 {
     ProgramBinaryV2::unique_obj linked({}, FreeSpirv);
 
     std::vector<clc_binary const*> raw_objs;
-    raw_objs.reserve(args.objs.size());
-    for (auto& obj : args.objs)
+    raw_objs.reserve(objs.size());
+    for (auto& obj : objs)
         raw_objs.push_back(&static_cast<ProgramBinaryV2 const*>(obj)->GetRaw());
 
     clc_linker_args args_impl;
-    args_impl.create_library = args.create_library;
+    args_impl.create_library = create_library;
     args_impl.num_in_objs = (unsigned)raw_objs.size();
     args_impl.in_objs = raw_objs.data();
 
@@ -270,14 +276,95 @@ std::unique_ptr<ProgramBinary> CompilerV2::Link(LinkerArgs const& args, Logger c
     if (!LinkImpl(&args_impl, &logger_impl, &linked))
         return nullptr;
 
-    auto ret = std::make_unique<ProgramBinaryV2>(std::move(linked));
-    if (!ret)
+    return std::make_unique<ProgramBinaryV2>(std::move(linked));
+}
+
+std::unique_ptr<ProgramBinary> CompilerV2::Link(LinkerArgs const& args, Logger const& logger) const
+{
+    // Links over many objects are tree-reduced: groups of objects are linked
+    // into intermediate libraries in parallel, and the libraries are merged
+    // with one final pass. Group links run on compile-scheduler workers *and*
+    // the calling thread, all pulling from the same shared counter, so if
+    // every worker is busy (or queueing fails) the reduction degrades to a
+    // serial link on this thread instead of deadlocking.
+    constexpr size_t LinkGroupSize = 8;
+    std::unique_ptr<ProgramBinary> linked;
+    if (args.objs.size() > 2 * LinkGroupSize)
+    {
+        struct ReduceState
+        {
+            LinkerArgs const* pArgs;
+            Logger const* pLogger;
+            std::vector<std::unique_ptr<ProgramBinary>> Results;
+            std::atomic<size_t> NextGroup = {0};
+            std::atomic<size_t> CompletedGroups = {0};
+            std::atomic<bool> bFailed = {false};
+            std::promise<void> Done;
+        };
+        const size_t NumGroups = (args.objs.size() + LinkGroupSize - 1) / LinkGroupSize;
+        auto State = std::make_shared<ReduceState>();
+        State->pArgs = &args;
+        State->pLogger = &logger;
+        State->Results.resize(NumGroups);
+
+        // args and logger are only dereferenced while a claimed group is in
+        // flight, and Link doesn't return until every claimed group has
+        // completed; stragglers that claim nothing touch only State.
+        auto ProcessGroups = [this, State]()
+        {
+            const size_t NumGroups = State->Results.size();
+            for (size_t Group = State->NextGroup++; Group < NumGroups; Group = State->NextGroup++)
+            {
+                // Bound only after a group is claimed: pArgs points at
+                // Link's stack, and a straggler that claims nothing must not
+                // touch it after Link has returned.
+                auto const& objs = State->pArgs->objs;
+                try
+                {
+                    State->Results[Group] = LinkOnePass(
+                        { objs.begin() + Group * LinkGroupSize,
+                          objs.begin() + std::min((Group + 1) * LinkGroupSize, objs.size()) },
+                        /*create_library*/true, *State->pLogger);
+                }
+                catch (...) { }
+                if (!State->Results[Group])
+                {
+                    State->bFailed = true;
+                }
+                if (++State->CompletedGroups == NumGroups)
+                {
+                    State->Done.set_value();
+                }
+            }
+        };
+        for (size_t i = 1; i < NumGroups; ++i)
+        {
+            try { g_Platform->QueueProgramOp(ProcessGroups); }
+            catch (std::bad_alloc&) { break; }
+        }
+        ProcessGroups();
+        State->Done.get_future().wait();
+        if (State->bFailed)
+            return nullptr;
+
+        std::vector<ProgramBinary const*> libraries;
+        libraries.reserve(NumGroups);
+        for (auto& result : State->Results)
+            libraries.push_back(result.get());
+        linked = LinkOnePass(libraries, args.create_library, logger);
+    }
+    else
+    {
+        linked = LinkOnePass(args.objs, args.create_library, logger);
+    }
+
+    if (!linked)
         return nullptr;
 
-    if (!ret->Parse(&logger))
+    if (!linked->Parse(&logger))
         return nullptr;
 
-    return ret;
+    return linked;
 }
 
 std::unique_ptr<ProgramBinary> CompilerV2::Load(const void *data, size_t size) const
@@ -314,7 +401,7 @@ static dxil_shader_model TranslateShaderModel(D3D_SHADER_MODEL sm)
     }
 }
 
-static dxil_validator_version GetValidatorVersion(const XPlatHelpers::unique_module &dxil)
+static dxil_validator_version QueryValidatorVersion(const XPlatHelpers::unique_module &dxil)
 {
     if (!dxil)
         return NO_DXIL_VALIDATION;
@@ -336,6 +423,17 @@ static dxil_validator_version GetValidatorVersion(const XPlatHelpers::unique_mod
     return NO_DXIL_VALIDATION;
 }
 
+static dxil_validator_version GetValidatorVersion(const XPlatHelpers::unique_module &dxil)
+{
+    // Queried once per process and shared read-only afterwards, like the
+    // libclc module itself. The answer can't change after dxil.dll is
+    // loaded, and instantiating a DxcValidator just to read its version on
+    // every kernel specialization adds up when hundreds of small programs
+    // each compile a handful of kernels.
+    static const dxil_validator_version version = QueryValidatorVersion(dxil);
+    return version;
+}
+
 std::unique_ptr<ProgramBinary> CompilerV2::Specialize(ProgramBinary const& obj, ProgramBinary::SpecConstantValues const& values, Logger const& logger) const
 {
     std::vector<clc_spirv_specialization> specializations;
@@ -467,6 +565,11 @@ bool ProgramBinaryV2::Parse(Logger const *logger)
     if (!CompilerV2::Instance()->ParseSpirv(&m_Object, logger ? &logger_impl : nullptr, &m_Parsed))
         return false;
 
+    // Tables may have been pre-populated from a binary's serialized metadata;
+    // the real parse is authoritative.
+    m_KernelInfo.clear();
+    m_SpecConstants.clear();
+
     if (m_Parsed.num_kernels)
     {
         m_KernelInfo.reserve(m_Parsed.num_kernels);
@@ -31,15 +31,24 @@ namespace D3D12TranslationLayer
             queue.Type = D3D12_COMMAND_LIST_TYPE_COMPUTE;
             queue.NodeMask = 1;
             queue.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+            queue.Priority = m_pParent->m_CreationArgs.CommandQueuePriority;
             CComPtr<ID3D12Device9> spDevice9;
-            if (SUCCEEDED(m_pParent->m_pDevice12->QueryInterface(&spDevice9)))
+            m_pParent->m_pDevice12->QueryInterface(&spDevice9);
+            auto CreateQueue = [&]()
             {
-                ThrowFailure(spDevice9->CreateCommandQueue1(&queue, m_pParent->m_CreationArgs.CreatorID, IID_PPV_ARGS(&m_pCommandQueue)));
-            }
-            else
+                return spDevice9 ?
+                    spDevice9->CreateCommandQueue1(&queue, m_pParent->m_CreationArgs.CreatorID, IID_PPV_ARGS(&m_pCommandQueue)) :
+                    m_pParent->m_pDevice12->CreateCommandQueue(&queue, IID_PPV_ARGS(&m_pCommandQueue));
+            };
+            HRESULT hr = CreateQueue();
+            if (FAILED(hr) && queue.Priority == D3D12_COMMAND_QUEUE_PRIORITY_GLOBAL_REALTIME)
             {
-                ThrowFailure(m_pParent->m_pDevice12->CreateCommandQueue(&queue, IID_PPV_ARGS(&m_pCommandQueue)));
+                // Global realtime needs an elevated process; degrade to high
+                // rather than failing queue creation.
+                queue.Priority = D3D12_COMMAND_QUEUE_PRIORITY_HIGH;
+                hr = CreateQueue();
             }
+            ThrowFailure(hr);
         }
 
         PrepareNewCommandList();
@@ -71,6 +80,7 @@ namespace D3D12TranslationLayer
     void CommandListManager::UploadHeapSpaceAllocated(UINT64 heapSize) noexcept
     {
         m_UploadHeapSpaceAllocated += heapSize;
+        m_pParent->m_PerfCounters.m_UploadHeapBytesAllocated.fetch_add(heapSize, std::memory_order_relaxed);
     }
 
     void CommandListManager::SubmitCommandListIfNeeded()
@@ -161,11 +171,37 @@ namespace D3D12TranslationLayer
         ResetCommandListTrackingData();
     }
 
+    //----------------------------------------------------------------------------------------------------------------------------------
+    void CommandListManager::PreallocateCommandAllocators(UINT Count)
+    {
+        // Returned at fence value 0, which has always completed, so these sit
+        // at the head of the pool and are handed out before any new allocator
+        // would be created.
+        for (UINT i = 0; i < Count; ++i)
+        {
+            unique_comptr<ID3D12CommandAllocator> spAllocator;
+            ThrowFailure(m_pParent->m_pDevice12->CreateCommandAllocator(
+                D3D12_COMMAND_LIST_TYPE_COMPUTE,
+                IID_PPV_ARGS(&spAllocator)
+                )); // throw( _com_error )
+            m_AllocatorPool.ReturnToPool(std::move(spAllocator), 0);
+        }
+    }
+
     //----------------------------------------------------------------------------------------------------------------------------------
     void CommandListManager::ResetResidencySet()
     {
-        m_pResidencySet = std::make_unique<ResidencySet>();
-        m_pResidencySet->Open(0);
+        // The set is persistent: membership carries across command lists, so
+        // steady-state submissions only pay for what changed since the last
+        // one. Nothing to do per submit unless a discard dissolved the set.
+        if (!m_pResidencySet)
+        {
+            m_pResidencySet = std::make_unique<ResidencySet>();
+        }
+        if (!m_pResidencySet->IsPersistent())
+        {
+            m_pResidencySet->OpenPersistent(0);
+        }
     }
 
     //----------------------------------------------------------------------------------------------------------------------------------
@@ -178,10 +214,16 @@ namespace D3D12TranslationLayer
     //----------------------------------------------------------------------------------------------------------------------------------
     void CommandListManager::SubmitCommandListImpl() // throws
     {
-        CloseCommandList(m_pCommandList.get()); // throws
+        // Batch-resolve every timestamp query ended on this command list before closing it
+        m_pParent->GetTimestampQueryPool().ResolvePendingQueries();
 
-        m_pResidencySet->Close();
+        // End any split transitions still open so no BEGIN_ONLY ships unmatched
+        m_pParent->GetResourceStateManager().FlushPendingSplitBarriers(this);
+
+        CloseCommandList(m_pCommandList.get()); // throws
 
+        // The persistent residency set stays open across submissions;
+        // ExecuteCommandList processes just its delta.
         m_pParent->GetResidencyManager().ExecuteCommandList(m_pCommandQueue.get(), 0, m_pCommandList.get(), m_pResidencySet.get());
 
         // Return the command allocator to the pool for recycling
@@ -190,6 +232,7 @@ namespace D3D12TranslationLayer
         SubmitFence();
 
         PrepareNewCommandList();
+        m_pParent->m_PerfCounters.m_CommandListsSubmitted.fetch_add(1, std::memory_order_relaxed);
         m_pParent->PostSubmitNotification();
     }
 
@@ -226,7 +269,7 @@ namespace D3D12TranslationLayer
         if (pResidencyObject)
         {
             assert(pResidencyObject->IsInitialized());
-            m_pResidencySet->Insert(pResidencyObject);
+            m_pParent->GetResidencyManager().AddToResidencySet(m_pResidencySet.get(), pResidencyObject);
         }
     }
 
@@ -351,6 +394,8 @@ namespace D3D12TranslationLayer
         ResetCommandListTrackingData();
         m_pCommandList = nullptr;
 
-        m_pResidencySet->Close();
+        // Dissolve the persistent set's membership; objects re-register as
+        // they're referenced again.
+        m_pParent->GetResidencyManager().CloseResidencySet(m_pResidencySet.get());
     }
 }
@@ -5,6 +5,9 @@
 #include "ImmediateContext.inl"
 #include "FormatDesc.hpp"
 #include "View.inl"
+#include <thread>
+#include <vector>
+#include <algorithm>
 
 namespace D3D12TranslationLayer
 {
@@ -23,8 +26,9 @@ ImmediateContext::ImmediateContext(D3D12_FEATURE_DATA_D3D12_OPTIONS& caps,
     , m_SRVAllocator(pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1024)
     , m_UAVAllocator(pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 1024)
     , m_SamplerAllocator(pDevice, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, 64)
-    , m_UploadBufferPool(m_BufferPoolTrimThreshold, true)
-    , m_ReadbackBufferPool(m_BufferPoolTrimThreshold, true)
+    , m_BufferPoolTrimThreshold(args.BufferPoolTrimFenceAge ? args.BufferPoolTrimFenceAge : cDefaultBufferPoolTrimThreshold)
+    , m_UploadBufferPool(m_BufferPoolTrimThreshold, args.BufferPoolMaxRetainedBytes, true)
+    , m_ReadbackBufferPool(m_BufferPoolTrimThreshold, args.BufferPoolMaxRetainedBytes, true)
     , m_DeferredDeletionQueueManager(this)
 
     , m_UploadHeapSuballocator(
@@ -65,7 +69,11 @@ ImmediateContext::ImmediateContext(D3D12_FEATURE_DATA_D3D12_OPTIONS& caps,
     m_residencyManager.Initialize(m_pDXCoreAdapter.get());
 
     m_ViewHeap.m_MaxHeapSize = (DWORD)D3D12_MAX_SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE_TIER_1;
-    const UINT32 viewHeapStartingCount = m_bUseRingBufferDescriptorHeaps ? 4096 : m_ViewHeap.m_MaxHeapSize;
+    UINT32 viewHeapStartingCount = m_bUseRingBufferDescriptorHeaps ? 4096 : m_ViewHeap.m_MaxHeapSize;
+    if (m_bUseRingBufferDescriptorHeaps && args.ViewHeapStartingCountHint != 0)
+    {
+        viewHeapStartingCount = min(max(viewHeapStartingCount, args.ViewHeapStartingCountHint), m_ViewHeap.m_MaxHeapSize);
+    }
     m_ViewHeap.m_DescriptorRingBuffer = CFencedRingBuffer(viewHeapStartingCount);
     m_ViewHeap.m_Desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
     m_ViewHeap.m_Desc.NumDescriptors = viewHeapStartingCount;
@@ -73,7 +81,11 @@ ImmediateContext::ImmediateContext(D3D12_FEATURE_DATA_D3D12_OPTIONS& caps,
     m_ViewHeap.m_Desc.NodeMask = 1;
 
     m_SamplerHeap.m_MaxHeapSize = D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE;
-    const UINT32 samplerHeapStartingCount = m_bUseRingBufferDescriptorHeaps ? 512 : m_SamplerHeap.m_MaxHeapSize;
+    UINT32 samplerHeapStartingCount = m_bUseRingBufferDescriptorHeaps ? 512 : m_SamplerHeap.m_MaxHeapSize;
+    if (m_bUseRingBufferDescriptorHeaps && args.SamplerHeapStartingCountHint != 0)
+    {
+        samplerHeapStartingCount = min(max(samplerHeapStartingCount, args.SamplerHeapStartingCountHint), m_SamplerHeap.m_MaxHeapSize);
+    }
     m_SamplerHeap.m_DescriptorRingBuffer = CFencedRingBuffer(samplerHeapStartingCount);
     m_SamplerHeap.m_Desc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
     m_SamplerHeap.m_Desc.NumDescriptors = samplerHeapStartingCount;
@@ -142,13 +154,148 @@ ImmediateContext::~ImmediateContext() noexcept
 {
     Shutdown();
 
+    // Stop the background deletion worker; it drains anything still pending
+    // before exiting, and must be gone before members it touches are destroyed.
+    if (m_DeletionThread.joinable())
+    {
+        {
+            std::lock_guard lock(m_DeletionThreadMutex);
+            m_bDeletionThreadExit = true;
+        }
+        m_DeletionThreadWake.notify_one();
+        m_DeletionThread.join();
+    }
+
     //Ensure all remaining allocations are cleaned up
     TrimDeletedObjects(true);
 }
 
+//----------------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+    struct DeferredDeletionBatchEntries
+    {
+        struct ObjectEntry
+        {
+            ImmediateContext* pContext;
+            RetiredD3D12Object Object;
+        };
+        struct SuballocationEntry
+        {
+            ImmediateContext* pContext;
+            RetiredSuballocationBlock Block;
+        };
+        std::vector<ObjectEntry> Objects;
+        std::vector<SuballocationEntry> Suballocations;
+    };
+    // The depth counter is a separate trivially-destructible thread_local so
+    // release paths can safely check for an active batch even while thread
+    // locals are being torn down at thread exit; the entry storage is only
+    // touched while a batch is open.
+    thread_local unsigned g_DeferredDeletionBatchDepth = 0;
+    thread_local DeferredDeletionBatchEntries g_DeferredDeletionBatchEntries;
+}
+
+ScopedDeferredDeletionBatch::ScopedDeferredDeletionBatch() noexcept
+{
+    ++g_DeferredDeletionBatchDepth;
+}
+
+ScopedDeferredDeletionBatch::~ScopedDeferredDeletionBatch() noexcept
+{
+    if (--g_DeferredDeletionBatchDepth != 0)
+    {
+        return;
+    }
+    auto& batch = g_DeferredDeletionBatchEntries;
+    // Everything in a batch usually belongs to one context; loop in case a
+    // teardown spans several.
+    while (!batch.Objects.empty() || !batch.Suballocations.empty())
+    {
+        ImmediateContext* pContext = !batch.Objects.empty() ? batch.Objects.front().pContext
+                                                            : batch.Suballocations.front().pContext;
+        const UINT64 CompletedFence = pContext->GetCompletedFenceValue();
+        {
+            auto Manager = pContext->m_DeferredDeletionQueueManager.GetLocked();
+            for (auto& entry : batch.Objects)
+            {
+                if (entry.pContext == pContext && entry.Object.m_lastCommandListID > CompletedFence)
+                {
+                    Manager->AddRetiredObjectToQueue(std::move(entry.Object));
+                }
+            }
+            for (auto& entry : batch.Suballocations)
+            {
+                if (entry.pContext == pContext && entry.Block.m_lastCommandListID > CompletedFence)
+                {
+                    Manager->AddRetiredSuballocationToQueue(std::move(entry.Block));
+                }
+            }
+        }
+        // Fence-retired suballocations go straight back to their allocators,
+        // outside the queue lock; fence-retired objects release when the
+        // vectors shrink below.
+        for (auto& entry : batch.Suballocations)
+        {
+            if (entry.pContext == pContext && entry.Block.m_lastCommandListID <= CompletedFence)
+            {
+                entry.Block.Destroy();
+            }
+        }
+        auto MatchesContext = [pContext](auto const& entry) { return entry.pContext == pContext; };
+        batch.Objects.erase(std::remove_if(batch.Objects.begin(), batch.Objects.end(), MatchesContext), batch.Objects.end());
+        batch.Suballocations.erase(std::remove_if(batch.Suballocations.begin(), batch.Suballocations.end(), MatchesContext), batch.Suballocations.end());
+    }
+}
+
+bool ScopedDeferredDeletionBatch::Accumulate(ImmediateContext* pContext, ID3D12Object* pUnderlying,
+    std::unique_ptr<ResidencyManagedObjectWrapper> &pResidencyHandle, UINT64 lastCommandListID) noexcept
+{
+    if (g_DeferredDeletionBatchDepth == 0)
+    {
+        return false;
+    }
+    auto& batch = g_DeferredDeletionBatchEntries;
+    try
+    {
+        // Reserve before constructing the entry so a failed reallocation
+        // cannot destroy the residency handle early.
+        batch.Objects.reserve(batch.Objects.size() + 1);
+    }
+    catch (std::bad_alloc&)
+    {
+        return false;
+    }
+    batch.Objects.push_back({ pContext, RetiredD3D12Object(pUnderlying, std::move(pResidencyHandle), lastCommandListID) });
+    return true;
+}
+
+bool ScopedDeferredDeletionBatch::Accumulate(ImmediateContext* pContext, HeapSuballocationBlock &block,
+    ConditionalHeapAllocator &parentAllocator, UINT64 lastCommandListID) noexcept
+{
+    if (g_DeferredDeletionBatchDepth == 0)
+    {
+        return false;
+    }
+    auto& batch = g_DeferredDeletionBatchEntries;
+    try
+    {
+        batch.Suballocations.push_back({ pContext, RetiredSuballocationBlock(block, parentAllocator, lastCommandListID) });
+    }
+    catch (std::bad_alloc&)
+    {
+        return false;
+    }
+    return true;
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------
 void ImmediateContext::AddResourceToDeferredDeletionQueue(ID3D12Object* pUnderlying, std::unique_ptr<ResidencyManagedObjectWrapper> &&pResidencyHandle, UINT64 lastCommandListID)
 {
+    if (ScopedDeferredDeletionBatch::Accumulate(this, pUnderlying, pResidencyHandle, lastCommandListID))
+    {
+        return;
+    }
     // Note: Due to the below routines being called after deferred deletion queue destruction,
     // all callers of the generic AddObjectToQueue should ensure that the object really needs to be in the queue.
     if (!RetiredD3D12Object::ReadyToDestroy(this, lastCommandListID))
@@ -190,6 +337,23 @@ bool DeferredDeletionQueueManager::TrimDeletedObjects(bool deviceBeingDestroyed)
     return AnyObjectsDestroyed;
 }
 
+//----------------------------------------------------------------------------------------------------------------------------------
+void DeferredDeletionQueueManager::ExtractReadyObjects(std::queue<RetiredD3D12Object> &objects, std::queue<RetiredSuballocationBlock> &suballocations)
+{
+    while (m_DeferredObjectDeletionQueue.empty() == false &&
+        m_DeferredObjectDeletionQueue.front().ReadyToDestroy(m_pParent))
+    {
+        objects.push(std::move(m_DeferredObjectDeletionQueue.front()));
+        m_DeferredObjectDeletionQueue.pop();
+    }
+
+    while (SuballocationsReadyToBeDestroyed(false))
+    {
+        suballocations.push(m_DeferredSuballocationDeletionQueue.front());
+        m_DeferredSuballocationDeletionQueue.pop();
+    }
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------
 UINT64 DeferredDeletionQueueManager::GetFenceValueForObjectDeletion()
 {
@@ -220,17 +384,105 @@ bool ImmediateContext::TrimDeletedObjects(bool deviceBeingDestroyed)
     return m_DeferredDeletionQueueManager.GetLocked()->TrimDeletedObjects(deviceBeingDestroyed);
 }
 
+//----------------------------------------------------------------------------------------------------------------------------------
+void ImmediateContext::QueueDeferredDeletions()
+{
+    std::queue<RetiredD3D12Object> objects;
+    std::queue<RetiredSuballocationBlock> suballocations;
+    m_DeferredDeletionQueueManager.GetLocked()->ExtractReadyObjects(objects, suballocations);
+    if (objects.empty() && suballocations.empty())
+    {
+        return;
+    }
+
+    try
+    {
+        std::unique_lock lock(m_DeletionThreadMutex);
+        if (!m_DeletionThread.joinable())
+        {
+            m_DeletionThread = std::thread([this]() { DeletionThreadProc(); });
+        }
+        while (!objects.empty())
+        {
+            m_PendingDeletionObjects.push(std::move(objects.front()));
+            objects.pop();
+        }
+        while (!suballocations.empty())
+        {
+            m_PendingDeletionSuballocations.push(suballocations.front());
+            suballocations.pop();
+        }
+        lock.unlock();
+        m_DeletionThreadWake.notify_one();
+    }
+    catch (...)
+    {
+        // Couldn't start the worker or grow its queues - free whatever wasn't
+        // handed off right here, as the submit paths always used to.
+        while (!suballocations.empty())
+        {
+            suballocations.front().Destroy();
+            suballocations.pop();
+        }
+        // The object queue frees its remaining entries on destruction.
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------
+void ImmediateContext::DeletionThreadProc()
+{
+    // Destruction is cleanup work that shouldn't compete with threads
+    // recording or submitting new commands.
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    std::unique_lock lock(m_DeletionThreadMutex);
+    for (;;)
+    {
+        m_DeletionThreadWake.wait(lock, [this]()
+        {
+            return m_bDeletionThreadExit || !m_PendingDeletionObjects.empty() || !m_PendingDeletionSuballocations.empty();
+        });
+        if (m_PendingDeletionObjects.empty() && m_PendingDeletionSuballocations.empty())
+        {
+            assert(m_bDeletionThreadExit);
+            return;
+        }
+
+        std::queue<RetiredD3D12Object> objects;
+        std::queue<RetiredSuballocationBlock> suballocations;
+        objects.swap(m_PendingDeletionObjects);
+        suballocations.swap(m_PendingDeletionSuballocations);
+        lock.unlock();
+
+        while (!objects.empty())
+        {
+            objects.pop();
+        }
+        while (!suballocations.empty())
+        {
+            suballocations.front().Destroy();
+            suballocations.pop();
+        }
+
+        lock.lock();
+    }
+}
+
 bool ImmediateContext::TrimResourcePools()
 {
-    m_UploadBufferPool.Trim(GetCompletedFenceValue());
-    m_ReadbackBufferPool.Trim(GetCompletedFenceValue());
+    // While the OS reports the process over its memory budget, parked staging
+    // buffers are the cheapest memory to give back: drain everything the GPU
+    // has finished with instead of honoring the retention policy.
+    const bool BudgetPressure = m_residencyManager.IsOverBudget();
+    m_UploadBufferPool.Trim(GetCompletedFenceValue(), BudgetPressure);
+    m_ReadbackBufferPool.Trim(GetCompletedFenceValue(), BudgetPressure);
 
     return true;
 }
 
 void ImmediateContext::PostSubmitNotification()
 {
-    TrimDeletedObjects();
+    QueueDeferredDeletions();
     TrimResourcePools();
 
     const UINT64 completedFence = GetCompletedFenceValue();
@@ -239,12 +491,62 @@ void ImmediateContext::PostSubmitNotification()
     {
         m_ViewHeap.m_DescriptorRingBuffer.Deallocate(completedFence);
         m_SamplerHeap.m_DescriptorRingBuffer.Deallocate(completedFence);
+
+        GrowHeapAtSubmitBoundary(m_ViewHeap);
+        if (!ComputeOnly())
+        {
+            GrowHeapAtSubmitBoundary(m_SamplerHeap);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------
+void ImmediateContext::GrowHeapAtSubmitBoundary(OnlineDescriptorHeap& Heap) noexcept
+{
+    // Rollover hysteresis: a single rollover in a command list is absorbed by
+    // the doubling in RollOverHeap when allocation fails. Rolling over more
+    // than once while recording one list means the ring is undersized for the
+    // workload, and every mid-list rollover costs a heap swap and rebind in
+    // the middle of authored work. Grow again here instead, between command
+    // lists, where the swap only touches the freshly reset (still empty) list.
+    constexpr UINT RolloversPerListThreshold = 2;
+    const UINT NumRollovers = Heap.m_NumRollovers;
+    Heap.m_NumRollovers = 0;
+    if (NumRollovers < RolloversPerListThreshold ||
+        Heap.m_Desc.NumDescriptors >= Heap.m_MaxHeapSize)
+    {
+        return;
+    }
+
+    try
+    {
+        D3D12_DESCRIPTOR_HEAP_DESC Desc = Heap.m_Desc;
+        Desc.NumDescriptors = min(Desc.NumDescriptors * 2, Heap.m_MaxHeapSize);
+        unique_comptr<ID3D12DescriptorHeap> spHeap;
+        ThrowFailure(m_pDevice12->CreateDescriptorHeap(&Desc, IID_PPV_ARGS(&spHeap)));
+
+        // The outgoing heap may still be referenced by in-flight lists.
+        AddObjectToDeferredDeletionQueue(Heap.m_pDescriptorHeap.get(), GetCommandListID());
+
+        Heap.m_pDescriptorHeap = std::move(spHeap);
+        Heap.m_Desc = Desc;
+        Heap.m_DescriptorRingBuffer = CFencedRingBuffer(Heap.m_Desc.NumDescriptors);
+        Heap.m_DescriptorHeapBase = Heap.m_pDescriptorHeap->GetGPUDescriptorHandleForHeapStart().ptr;
+        Heap.m_DescriptorHeapBaseCPU = Heap.m_pDescriptorHeap->GetCPUDescriptorHandleForHeapStart().ptr;
+
+        ID3D12DescriptorHeap* pHeaps[2] = { m_ViewHeap.m_pDescriptorHeap.get(), m_SamplerHeap.m_pDescriptorHeap.get() };
+        GetGraphicsCommandList()->SetDescriptorHeaps(ComputeOnly() ? 1 : 2, pHeaps);
+    }
+    catch (_com_error&)
+    {
+        // Keep the current heap; the next mid-list rollover grows it instead.
     }
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------
 void ImmediateContext::RollOverHeap(OnlineDescriptorHeap& Heap) noexcept(false)
 {
+    ++Heap.m_NumRollovers;
     auto pfnCreateNew = [this](D3D12_DESCRIPTOR_HEAP_DESC const& Desc) -> unique_comptr<ID3D12DescriptorHeap>
     {
         unique_comptr<ID3D12DescriptorHeap> spHeap;
@@ -825,6 +1127,56 @@ void ImmediateContext::ResourceCopyRegion(Resource* pDst, UINT DstSubresource, U
     }
 }
 
+//----------------------------------------------------------------------------------------------------------------------------------
+// Large uploads are bound by a single core's memcpy bandwidth, well below what
+// the memory system can sustain. Copies past the threshold are split into
+// chunks handed to short-lived worker threads; the calling thread copies the
+// first chunk itself, and anything that couldn't be handed out (thread spawn
+// failure) is copied by the caller as part of the tail, keeping this noexcept.
+static void ParallelMemcpy(void* pDst, const void* pSrc, size_t Size) noexcept
+{
+    constexpr size_t cParallelMemcpyThreshold = 32 * 1024 * 1024;
+    constexpr size_t cMinBytesPerWorker = 16 * 1024 * 1024;
+    size_t NumWorkers = min<size_t>(std::thread::hardware_concurrency(), Size / cMinBytesPerWorker);
+    if (Size < cParallelMemcpyThreshold || NumWorkers < 2)
+    {
+        memcpy(pDst, pSrc, Size);
+        return;
+    }
+
+    size_t ChunkSize = Size / NumWorkers;
+    size_t HandedOut = ChunkSize; // The first chunk belongs to the calling thread
+    std::vector<std::thread> Workers;
+    try
+    {
+        Workers.reserve(NumWorkers - 1);
+        for (size_t i = 1; i < NumWorkers; ++i)
+        {
+            size_t ThisChunk = (i == NumWorkers - 1) ? Size - HandedOut : ChunkSize;
+            size_t Offset = HandedOut;
+            Workers.emplace_back([=]()
+            {
+                memcpy(reinterpret_cast<BYTE*>(pDst) + Offset, reinterpret_cast<const BYTE*>(pSrc) + Offset, ThisChunk);
+            });
+            HandedOut += ThisChunk;
+        }
+    }
+    catch (...)
+    {
+        // Out of threads or memory - the un-handed-out tail is copied below.
+    }
+
+    memcpy(pDst, pSrc, ChunkSize);
+    if (HandedOut < Size)
+    {
+        memcpy(reinterpret_cast<BYTE*>(pDst) + HandedOut, reinterpret_cast<const BYTE*>(pSrc) + HandedOut, Size - HandedOut);
+    }
+    for (auto& Worker : Workers)
+    {
+        Worker.join();
+    }
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------
 void ImmediateContext::UploadDataToMappedBuffer(_In_reads_bytes_(Placement.Depth * DepthPitch) const void* pData, UINT SrcPitch, UINT SrcDepth,
                                        _Out_writes_bytes_(Placement.Depth * DepthPitch) void* pMappedData,
@@ -846,7 +1198,7 @@ void ImmediateContext::UploadDataToMappedBuffer(_In_reads_bytes_(Placement.Depth
         UINT CopySize = DepthPitch * (Placement.Depth - 1) +
             Placement.RowPitch * (NumRows - 1) +
             TightRowPitch;
-        memcpy(pMappedData, pData, CopySize);
+        ParallelMemcpy(pMappedData, pData, CopySize);
     }
     else
     {
@@ -1297,6 +1649,41 @@ void ImmediateContext::CPrepareUpdateSubresourcesHelper::UploadSourceDataToMappa
     }
 }
 
+//----------------------------------------------------------------------------------------------------------------------------------
+// Expands a repeating byte pattern into a destination that may be write-combined
+// upload-heap memory: the pattern is replicated into a cacheable stack seed by
+// doubling, then stamped with large memcpys. The CRT's memcpy already dispatches
+// to wide (and, for large sizes, non-temporal) stores at runtime, and nothing
+// here ever reads back from the destination.
+static void FillBufferWithPattern(BYTE* pDst, UINT64 Size, const void* pPattern, UINT PatternSize)
+{
+    BYTE Seed[2048];
+    if (PatternSize > sizeof(Seed))
+    {
+        UINT64 Offset = 0;
+        for (; Offset + PatternSize <= Size; Offset += PatternSize)
+        {
+            memcpy(pDst + Offset, pPattern, PatternSize);
+        }
+        memcpy(pDst + Offset, pPattern, size_t(Size - Offset));
+        return;
+    }
+
+    memcpy(Seed, pPattern, PatternSize);
+    UINT64 SeedSize = PatternSize;
+    // The seed stays a multiple of the pattern size, so every stamp continues
+    // the pattern where the previous one left off.
+    while (SeedSize <= sizeof(Seed) / 2 && SeedSize < Size)
+    {
+        memcpy(Seed + SeedSize, Seed, size_t(SeedSize));
+        SeedSize *= 2;
+    }
+    for (UINT64 Offset = 0; Offset < Size; Offset += SeedSize)
+    {
+        memcpy(pDst + Offset, Seed, size_t(min(SeedSize, Size - Offset)));
+    }
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------
 void ImmediateContext::CPrepareUpdateSubresourcesHelper::UploadDataToMappableResource(D3D11_SUBRESOURCE_DATA const* pSrcData, ImmediateContext& ImmCtx, D3D12_BOX const* pDstBox, const void* pClearPattern, UINT ClearPatternSize, UpdateSubresourcesFlags flags)
 {
@@ -1336,13 +1723,6 @@ void ImmediateContext::CPrepareUpdateSubresourcesHelper::UploadDataToMappableRes
             // for a fully aligned block of pixels. (E.g. YUY2 is 8 bits per element * 2 elements per pixel * 2 pixel subsampling = 32 bits of clear data).
             const UINT SizeOfClearPattern = ClearPatternSize != 0 ? ClearPatternSize :
                 CD3D11FormatHelper::GetByteAlignment(Dst.AppDesc()->Format());
-            UINT ClearByteIndex = 0;
-            auto generator = [&]()
-            {
-                auto result = *(reinterpret_cast<const BYTE*>(pClearPattern) + ClearByteIndex);
-                ClearByteIndex = (ClearByteIndex + 1) % SizeOfClearPattern;
-                return result;
-            };
             if (FirstSubresourcePlacement.Footprint.RowPitch % SizeOfClearPattern != 0)
             {
                 UINT SlicePitch;
@@ -1360,14 +1740,14 @@ void ImmediateContext::CPrepareUpdateSubresourcesHelper::UploadDataToMappableRes
                         BYTE* pDstRow = (BYTE*)pDstData + bufferOffset +
                             FirstSubresourcePlacement.Footprint.RowPitch * y +
                             SlicePitch * z;
-                        ClearByteIndex = 0;
-                        std::generate_n(pDstRow, FirstSubresourcePlacement.Footprint.RowPitch, generator);
+                        // The pattern restarts at byte 0 on every row.
+                        FillBufferWithPattern(pDstRow, FirstSubresourcePlacement.Footprint.RowPitch, pClearPattern, SizeOfClearPattern);
                     }
                 }
             }
             else
             {
-                std::generate_n((BYTE*)pDstData + bufferOffset, CopySize, generator);
+                FillBufferWithPattern((BYTE*)pDstData + bufferOffset, CopySize, pClearPattern, SizeOfClearPattern);
             }
         }
         else
@@ -1430,8 +1810,10 @@ void ImmediateContext::ResourceUpdateSubresourceUP(Resource* pResource, UINT Dst
 unique_comptr<ID3D12Resource> ImmediateContext::AcquireTransitionableUploadBuffer(AllocatorHeapType HeapType, UINT64 Size) noexcept(false)
 {
     TDynamicBufferPool& Pool = GetBufferPool(HeapType);
+    m_PerfCounters.m_PoolBufferAcquisitions.fetch_add(1, std::memory_order_relaxed);
     auto pfnCreateNew = [this, HeapType](UINT64 Size) -> unique_comptr<ID3D12Resource> // noexcept(false)
     {
+        m_PerfCounters.m_PoolBufferCreations.fetch_add(1, std::memory_order_relaxed);
         return std::move(AllocateHeap(Size, 0, HeapType));
     };
 
@@ -1582,7 +1964,10 @@ void ImmediateContext::ReleaseSuballocatedHeap(AllocatorHeapType HeapType, D3D12
 {
     auto &allocator = GetAllocator(HeapType);
 
-    m_DeferredDeletionQueueManager.GetLocked()->AddSuballocationToQueue(resource.GetBufferSuballocation(), allocator, FenceValue);
+    if (!ScopedDeferredDeletionBatch::Accumulate(this, resource.GetBufferSuballocation(), allocator, FenceValue))
+    {
+        m_DeferredDeletionQueueManager.GetLocked()->AddSuballocationToQueue(resource.GetBufferSuballocation(), allocator, FenceValue);
+    }
     resource.Reset();
 }
 
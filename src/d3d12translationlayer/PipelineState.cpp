@@ -22,6 +22,14 @@ namespace D3D12TranslationLayer
     void PipelineState::Create()
     {
         HRESULT hr = m_pParent->m_pDevice12->CreateComputePipelineState(&m_Desc, IID_PPV_ARGS(GetForCreate()));
+        if (FAILED(hr) && m_Desc.CachedPSO.pCachedBlob)
+        {
+            // Cached blobs from a previous run can be rejected after a driver or
+            // adapter change. Fall back to a full compile instead of failing the
+            // pipeline - the caller can detect this and refresh its cache.
+            m_Desc.CachedPSO = {};
+            hr = m_pParent->m_pDevice12->CreateComputePipelineState(&m_Desc, IID_PPV_ARGS(GetForCreate()));
+        }
         ThrowFailure(hr); // throw( _com_error )
     }
 }
\ No newline at end of file
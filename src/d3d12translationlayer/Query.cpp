@@ -5,70 +5,199 @@
 #include "ImmediateContext.inl"
 #include "Query.hpp"
 
+#include <algorithm>
+#include <tuple>
+
 namespace D3D12TranslationLayer
 {
-    TimestampQuery::TimestampQuery(ImmediateContext* pDevice) noexcept(false)
-        : DeviceChild(pDevice)
+    //----------------------------------------------------------------------------------------------------------------------------------
+    TimestampQueryPool::Slot TimestampQueryPool::AcquireSlot() noexcept(false)
     {
-        D3D12_QUERY_HEAP_DESC QueryHeapDesc = { D3D12_QUERY_HEAP_TYPE_TIMESTAMP, 1, 1 };
+        std::lock_guard lock(m_Lock);
+
+        if (m_FreeSlots.empty() && !m_DeferredFreeSlots.empty())
+        {
+            // Recycle slots whose last resolve the GPU has finished with
+            UINT64 CompletedFence = m_pParent->GetCompletedFenceValue();
+            for (size_t i = 0; i < m_DeferredFreeSlots.size(); )
+            {
+                if (m_DeferredFreeSlots[i].FenceValue <= CompletedFence)
+                {
+                    m_FreeSlots.push_back(m_DeferredFreeSlots[i].slot); // throw( bad_alloc )
+                    m_DeferredFreeSlots[i] = m_DeferredFreeSlots.back();
+                    m_DeferredFreeSlots.pop_back();
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
+        if (m_FreeSlots.empty())
+        {
+            Page NewPage;
+            D3D12_QUERY_HEAP_DESC QueryHeapDesc = { D3D12_QUERY_HEAP_TYPE_TIMESTAMP, c_PageSize, 1 };
+            ThrowFailure(m_pParent->m_pDevice12->CreateQueryHeap(
+                &QueryHeapDesc,
+                IID_PPV_ARGS(&NewPage.spQueryHeap)
+            )); // throw( _com_error )
+
+            // Query data goes into a readback heap for CPU readback in GetData
+            NewPage.ResultBuffer = m_pParent->AcquireSuballocatedHeap(
+                AllocatorHeapType::Readback, c_PageSize * sizeof(UINT64), ResourceAllocationContext::FreeThread); // throw( _com_error )
+            ThrowFailure(NewPage.ResultBuffer.Map(0, nullptr, &NewPage.pMappedResults)); // throw( _com_error )
 
-        HRESULT hr = m_pParent->m_pDevice12->CreateQueryHeap(
-            &QueryHeapDesc,
-            IID_PPV_ARGS(&m_spQueryHeap)
-        );
-        ThrowFailure(hr); // throw( _com_error )
+            UINT PageIndex = (UINT)m_Pages.size();
+            m_FreeSlots.reserve(m_FreeSlots.size() + c_PageSize); // throw( bad_alloc )
+            m_Pages.push_back(std::move(NewPage)); // throw( bad_alloc )
+            for (UINT i = c_PageSize; i > 0; --i)
+            {
+                m_FreeSlots.push_back(Slot{ PageIndex, i - 1 });
+            }
+        }
 
-        // Query data goes into a readback heap for CPU readback in GetData
-        m_spResultBuffer = m_pParent->AcquireSuballocatedHeap(
-            AllocatorHeapType::Readback, sizeof(UINT64), ResourceAllocationContext::FreeThread); // throw( _com_error )
+        Slot slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+        return slot;
     }
 
     //----------------------------------------------------------------------------------------------------------------------------------
-    void TimestampQuery::End() noexcept
+    void TimestampQueryPool::ReleaseSlot(Slot slot, UINT64 LastUsedCommandListID) noexcept
+    {
+        if (!slot.IsValid())
+        {
+            return;
+        }
+
+        std::lock_guard lock(m_Lock);
+        try
+        {
+            m_DeferredFreeSlots.push_back(DeferredSlot{ slot, LastUsedCommandListID });
+        }
+        catch (std::bad_alloc&)
+        {
+            // The slot is dropped; the pool just won't hand it out again.
+        }
+    }
+
+    //----------------------------------------------------------------------------------------------------------------------------------
+    void TimestampQueryPool::EndQuery(Slot slot) noexcept
     {
-        // Store data in the query object, then resolve into the result buffer
+        std::lock_guard lock(m_Lock);
+        Page& page = m_Pages[slot.PageIndex];
         auto pIface = m_pParent->GetGraphicsCommandList();
 
-        pIface->EndQuery(m_spQueryHeap.get(), D3D12_QUERY_TYPE_TIMESTAMP, 0);
-        pIface->ResolveQueryData(
-            m_spQueryHeap.get(),
-            D3D12_QUERY_TYPE_TIMESTAMP,
-            0,
-            1,
-            m_spResultBuffer.GetResource(),
-            m_spResultBuffer.GetOffset()
-        );
+        pIface->EndQuery(page.spQueryHeap.get(), D3D12_QUERY_TYPE_TIMESTAMP, slot.Index);
+        try
+        {
+            m_PendingResolves.push_back(slot);
+        }
+        catch (std::bad_alloc&)
+        {
+            // Can't defer it - resolve this one query inline instead
+            pIface->ResolveQueryData(
+                page.spQueryHeap.get(),
+                D3D12_QUERY_TYPE_TIMESTAMP,
+                slot.Index,
+                1,
+                page.ResultBuffer.GetResource(),
+                page.ResultBuffer.GetOffset() + slot.Index * sizeof(UINT64)
+            );
+        }
         m_pParent->AdditionalCommandsAdded();
-        m_LastUsedCommandListID = m_pParent->GetCommandListID();
     }
 
     //----------------------------------------------------------------------------------------------------------------------------------
-    UINT64 TimestampQuery::GetData() noexcept
+    void TimestampQueryPool::ResolvePendingQueries() noexcept
     {
-        void* pMappedData = nullptr;
+        std::lock_guard lock(m_Lock);
+        if (m_PendingResolves.empty())
+        {
+            return;
+        }
 
-        CD3DX12_RANGE ReadRange(0, sizeof(UINT64));
-        HRESULT hr = m_spResultBuffer.Map(
-            0,
-            &ReadRange,
-            &pMappedData
+        // Sort so that adjacent slots in the same page collapse into a single resolve
+        std::sort(m_PendingResolves.begin(), m_PendingResolves.end(),
+                  [](Slot const& a, Slot const& b) { return std::tie(a.PageIndex, a.Index) < std::tie(b.PageIndex, b.Index); });
+
+        auto pIface = m_pParent->GetGraphicsCommandList();
+        for (size_t i = 0; i < m_PendingResolves.size(); )
+        {
+            size_t RunEnd = i + 1;
+            while (RunEnd < m_PendingResolves.size() &&
+                   m_PendingResolves[RunEnd].PageIndex == m_PendingResolves[i].PageIndex &&
+                   m_PendingResolves[RunEnd].Index == m_PendingResolves[RunEnd - 1].Index + 1)
+            {
+                ++RunEnd;
+            }
+
+            Page& page = m_Pages[m_PendingResolves[i].PageIndex];
+            pIface->ResolveQueryData(
+                page.spQueryHeap.get(),
+                D3D12_QUERY_TYPE_TIMESTAMP,
+                m_PendingResolves[i].Index,
+                (UINT)(RunEnd - i),
+                page.ResultBuffer.GetResource(),
+                page.ResultBuffer.GetOffset() + m_PendingResolves[i].Index * sizeof(UINT64)
             );
-        ThrowFailure(hr);
+            i = RunEnd;
+        }
+        m_PendingResolves.clear();
+    }
 
-        const UINT64* pSrc = reinterpret_cast<const UINT64*>(pMappedData);
-        UINT64 result = *pSrc;
-        CD3DX12_RANGE WrittenRange(0, 0);
-        m_spResultBuffer.Unmap(0, &WrittenRange);
-        return result;
+    //----------------------------------------------------------------------------------------------------------------------------------
+    UINT64 TimestampQueryPool::GetData(Slot slot) noexcept
+    {
+        // Callers only read a slot once its resolve's fence has completed, so
+        // the persistently mapped readback page already holds the value.
+        std::lock_guard lock(m_Lock);
+        Page& page = m_Pages[slot.PageIndex];
+        return reinterpret_cast<const UINT64*>(page.pMappedResults)[slot.Index];
     }
 
     //----------------------------------------------------------------------------------------------------------------------------------
-    TimestampQuery::~TimestampQuery()
+    TimestampQueryPool::~TimestampQueryPool() noexcept
     {
-        AddToDeferredDeletionQueue(m_spQueryHeap);
-        if (m_spResultBuffer.IsInitialized())
+        UINT64 LastCommandListID = m_pParent->GetCommandListIDInterlockedRead();
+        for (auto& page : m_Pages)
         {
-            m_pParent->ReleaseSuballocatedHeap(AllocatorHeapType::Readback, m_spResultBuffer, m_LastUsedCommandListID);
+            m_pParent->AddObjectToDeferredDeletionQueue(page.spQueryHeap.get(), LastCommandListID);
+            page.spQueryHeap.reset();
+            if (page.ResultBuffer.IsInitialized())
+            {
+                // Readback heaps are shared; drop this page's map refcount
+                // before returning the suballocation.
+                CD3DX12_RANGE WrittenRange(0, 0);
+                page.ResultBuffer.Unmap(0, &WrittenRange);
+                m_pParent->ReleaseSuballocatedHeap(AllocatorHeapType::Readback, page.ResultBuffer, LastCommandListID);
+            }
         }
     }
-};
\ No newline at end of file
+
+    //----------------------------------------------------------------------------------------------------------------------------------
+    TimestampQuery::TimestampQuery(ImmediateContext* pDevice) noexcept(false)
+        : DeviceChild(pDevice)
+        , m_Slot(pDevice->GetTimestampQueryPool().AcquireSlot())
+    {
+    }
+
+    //----------------------------------------------------------------------------------------------------------------------------------
+    void TimestampQuery::End() noexcept
+    {
+        m_pParent->GetTimestampQueryPool().EndQuery(m_Slot);
+        m_LastUsedCommandListID = m_pParent->GetCommandListID();
+    }
+
+    //----------------------------------------------------------------------------------------------------------------------------------
+    UINT64 TimestampQuery::GetData() noexcept
+    {
+        return m_pParent->GetTimestampQueryPool().GetData(m_Slot);
+    }
+
+    //----------------------------------------------------------------------------------------------------------------------------------
+    TimestampQuery::~TimestampQuery()
+    {
+        m_pParent->GetTimestampQueryPool().ReleaseSlot(m_Slot, m_LastUsedCommandListID);
+    }
+};
@@ -20,6 +20,18 @@ void Internal::LRUCache::TrimToSyncPointInclusive(INT64 CurrentUsage, INT64 Curr
         {
             return;
         }
+
+        // Members of a persistent residency set count as used at the set's
+        // last submission - the incremental paging walk doesn't re-stamp them
+        // per submit, so their per-object stamps (and LRU positions) go stale.
+        // Skip them like pinned objects rather than early-out.
+        if (pObject->pPersistentSet &&
+            pObject->pPersistentSet->LastSubmittedFenceValue > FenceValue)
+        {
+            pResourceEntry = pResourceEntry->Flink;
+            continue;
+        }
+
         if (pObject->LastUsedFenceValue > FenceValue)
         {
             return;
@@ -50,6 +62,17 @@ void Internal::LRUCache::TrimAgedAllocations(UINT64 FenceValue, std::vector<ID3D
     {
         ManagedObject* pObject = CONTAINING_RECORD(pResourceEntry, ManagedObject, ListEntry);
 
+        // Persistent-set members are effectively used every time their set is
+        // submitted; consult the set's stamps and skip (not early-out, since
+        // their LRU positions no longer reflect that freshness).
+        if (pObject->pPersistentSet &&
+            (CurrentTimeStamp - pObject->pPersistentSet->LastSubmittedTimestamp <= MinDelta ||
+             pObject->pPersistentSet->LastSubmittedFenceValue > FenceValue))
+        {
+            pResourceEntry = pResourceEntry->Flink;
+            continue;
+        }
+
         if (CurrentTimeStamp - pObject->LastUsedTimestamp <= MinDelta) // Don't evict things which have been used recently
         {
             return;
@@ -94,10 +117,38 @@ HRESULT ResidencyManager::Initialize(IDXCoreAdapter *ParentAdapterDXCore)
 
     HRESULT hr = S_OK;
     hr = AsyncThreadFence.Initialize(Device);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    // Subscribe to budget-change notifications so that when the OS shrinks
+    // this process's budget (e.g. another process spikes), trimming happens
+    // immediately on DXCore's notification thread rather than synchronously
+    // on the next submission. Registration failure just means we fall back
+    // to the polling-based trim in ProcessPagingWork.
+    if (SUCCEEDED(AdapterDXCore->GetFactory(IID_PPV_ARGS(&AdapterFactory))))
+    {
+        BudgetNotificationRegistered = SUCCEEDED(AdapterFactory->RegisterEventNotification(
+            AdapterDXCore,
+            DXCoreNotificationType::AdapterBudgetChange,
+            &ResidencyManager::BudgetChangeCallback,
+            this,
+            &BudgetNotificationCookie));
+    }
 
     return hr;
 }
 
+ResidencyManager::~ResidencyManager()
+{
+    if (BudgetNotificationRegistered)
+    {
+        // Blocks until any in-flight callback has returned.
+        (void)AdapterFactory->UnregisterEventNotification(BudgetNotificationCookie);
+    }
+}
+
 HRESULT ResidencyManager::ProcessPagingWork(UINT CommandListIndex, ResidencySet *pMasterSet)
 {
     // the size of all the objects which will need to be made resident in order to execute this set.
@@ -111,11 +162,9 @@ HRESULT ResidencyManager::ProcessPagingWork(UINT CommandListIndex, ResidencySet
         // A lock must be taken here as the state of the objects will be altered
         std::lock_guard Lock(Mutex);
 
-        MakeResidentList.reserve(pMasterSet->Set.size());
         EvictionList.reserve(LRU.NumResidentObjects);
 
-        // Mark the objects used by this command list to be made resident
-        for (auto pObject : pMasterSet->Set)
+        auto MarkObject = [&](ManagedObject* pObject)
         {
             // If it's evicted we need to make it resident again
             if (pObject->ResidencyStatus == ManagedObject::RESIDENCY_STATUS::EVICTED)
@@ -133,6 +182,43 @@ HRESULT ResidencyManager::ProcessPagingWork(UINT CommandListIndex, ResidencySet
 
             pObject->LastUsedTimestamp = CurrentTime.QuadPart;
             LRU.ObjectReferenced(pObject);
+        };
+
+        if (pMasterSet->bPersistent && !pMasterSet->bNeedsFullWalk)
+        {
+            // Incremental: membership carried over from previous submissions
+            // is still marked used (via the set's stamps, consulted by the
+            // trim paths), so only walk what changed since the last submit -
+            // new members plus members that were evicted in the meantime. An
+            // object can appear in both lists; the second visit just
+            // re-stamps it.
+            MakeResidentList.reserve(pMasterSet->Delta.size() + pMasterSet->EvictedMembers.size());
+            for (auto pObject : pMasterSet->Delta)
+            {
+                MarkObject(pObject);
+            }
+            for (auto pObject : pMasterSet->EvictedMembers)
+            {
+                MarkObject(pObject);
+            }
+        }
+        else
+        {
+            // Mark the objects used by this command list to be made resident
+            MakeResidentList.reserve(pMasterSet->Set.size());
+            for (auto pObject : pMasterSet->Set)
+            {
+                MarkObject(pObject);
+            }
+            pMasterSet->bNeedsFullWalk = false;
+        }
+
+        if (pMasterSet->bPersistent)
+        {
+            pMasterSet->Delta.clear();
+            pMasterSet->EvictedMembers.clear();
+            pMasterSet->LastSubmittedFenceValue = ImmCtx.GetCommandListID();
+            pMasterSet->LastSubmittedTimestamp = CurrentTime.QuadPart;
         }
 
         DXCoreAdapterMemoryBudget LocalMemory;
@@ -201,10 +287,23 @@ HRESULT ResidencyManager::ProcessPagingWork(UINT CommandListIndex, ResidencySet
 
                 if (FAILED(hr) || ObjectsMadeResident != MakeResidentList.size())
                 {
-                    ManagedObject *pResidentHead = LRU.GetResidentListHead();
-                    while (pResidentHead && pResidentHead->IsPinned())
+                    // Find the first object that could actually be trimmed:
+                    // not pinned, and not effectively in use as a member of a
+                    // freshly submitted persistent set.
+                    ManagedObject *pResidentHead = nullptr;
+                    for (LIST_ENTRY *pEntry = LRU.ResidentObjectListHead.Flink;
+                         pEntry != &LRU.ResidentObjectListHead;
+                         pEntry = pEntry->Flink)
                     {
-                        pResidentHead = CONTAINING_RECORD(pResidentHead->ListEntry.Flink, ManagedObject, ListEntry);
+                        ManagedObject *pCandidate = CONTAINING_RECORD(pEntry, ManagedObject, ListEntry);
+                        if (pCandidate->IsPinned() ||
+                            (pCandidate->pPersistentSet &&
+                             pCandidate->pPersistentSet->LastSubmittedFenceValue > LastSubmittedFenceValue))
+                        {
+                            continue;
+                        }
+                        pResidentHead = pCandidate;
+                        break;
                     }
 
                     // If there is nothing to trim OR the only objects 'Resident' are the ones about to be used by this execute.
@@ -284,4 +383,45 @@ void ResidencyManager::GetCurrentBudget(UINT64 Timestamp, DXCoreAdapterMemoryBud
     }
     *InfoOut = CachedBudget;
 }
+
+void STDMETHODCALLTYPE ResidencyManager::BudgetChangeCallback(DXCoreNotificationType, IUnknown*, void* pContext)
+{
+    static_cast<ResidencyManager*>(pContext)->TrimOnBudgetChange();
+}
+
+void ResidencyManager::TrimOnBudgetChange()
+{
+    LARGE_INTEGER CurrentTime;
+    QueryPerformanceCounter(&CurrentTime);
+
+    DXCoreAdapterMemoryBudget Local, Nonlocal;
+    GetDXCoreBudget(AdapterDXCore, &Local, DXCoreSegmentGroup::Local);
+    GetDXCoreBudget(AdapterDXCore, &Nonlocal, DXCoreSegmentGroup::NonLocal);
+
+    // Use a local eviction list: the members are scratch space for
+    // ProcessPagingWork, which can run concurrently on another thread.
+    std::vector<ID3D12Pageable*> BudgetEvictionList;
+
+    std::lock_guard Lock(Mutex);
+    CachedBudget.currentUsage = Local.currentUsage + Nonlocal.currentUsage;
+    CachedBudget.budget = Local.budget + Nonlocal.budget;
+    LastBudgetTimestamp = CurrentTime.QuadPart;
+
+    // Only objects whose last use the GPU has already completed are eligible;
+    // this thread never waits on the fence, it just takes what's safely
+    // evictable now. Anything still in flight is handled by the trim on the
+    // next submission as before.
+    UINT64 CompletedFenceValue = ImmCtx.GetCompletedFenceValue();
+    if (INT64(CachedBudget.currentUsage) > INT64(CachedBudget.budget))
+    {
+        LRU.TrimToSyncPointInclusive(CachedBudget.currentUsage, CachedBudget.budget, BudgetEvictionList, CompletedFenceValue);
+    }
+    LRU.TrimAgedAllocations(CompletedFenceValue, BudgetEvictionList, CurrentTime.QuadPart, GetCurrentEvictionGracePeriod(&CachedBudget));
+
+    if (!BudgetEvictionList.empty())
+    {
+        [[maybe_unused]] HRESULT hrEvict = Device->Evict((UINT)BudgetEvictionList.size(), BudgetEvictionList.data());
+        assert(SUCCEEDED(hrEvict));
+    }
+}
 }
@@ -191,6 +191,7 @@ namespace D3D12TranslationLayer
             m_Identity.reset(nullptr);
         }
         m_pParent->ReturnAllBuffersToPool(*this);
+        m_pParent->GetResourceStateManager().ResourceDestroyed(this);
 
         // If this resource was ever valid, ensure that it either still has its owned heap/resource, or that it returned its borrowed resource
         assert(m_Identity.get() == nullptr || // The identity is deleted early in the case of failed initialization
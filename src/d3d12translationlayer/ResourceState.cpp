@@ -157,6 +157,7 @@ namespace D3D12TranslationLayer
     void ResourceStateManager::ApplyResourceTransitionsPreamble() noexcept
     {
         m_vResourceBarriers.clear();
+        m_bInsertUAVBarrier = false;
     }
 
     //----------------------------------------------------------------------------------------------------------------------------------
@@ -198,6 +199,34 @@ namespace D3D12TranslationLayer
                                                                 UINT NumTotalSubresources,
                                                                 UINT64 CurrentFenceValue) noexcept(false)
     {
+        // A use of a resource with an in-flight split transition ends the split
+        // first; the tracked state then reflects the begin's after-state and
+        // the loop below handles any further change this use requires. Fence
+        // values are left alone - the END is not an access, and the UAV-barrier
+        // fold below keys off the fence of the real last write.
+        for (auto iter = m_vPendingSplitBarriers.begin(); iter != m_vPendingSplitBarriers.end(); ++iter)
+        {
+            if (iter->pOwner != static_cast<Resource*>(&TransitionableResource))
+            {
+                continue;
+            }
+            D3D12_RESOURCE_BARRIER EndDesc;
+            ZeroMemory(&EndDesc, sizeof(EndDesc));
+            EndDesc.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            EndDesc.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+            EndDesc.Transition.pResource = pTransitioningResource;
+            EndDesc.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            EndDesc.Transition.StateBefore = iter->StateBefore;
+            EndDesc.Transition.StateAfter = iter->StateAfter;
+            m_vResourceBarriers.push_back(EndDesc); // throw( bad_alloc )
+
+            CCurrentResourceState::SubresourceState NewState = CurrentState.GetSubresourceState(0);
+            NewState.State = iter->StateAfter;
+            CurrentState.SetResourceState(NewState);
+            m_vPendingSplitBarriers.erase(iter);
+            break;
+        }
+
         // Figure out the set of subresources that are transitioning
         auto& DestinationState = TransitionableResource.m_DesiredState;
         bool bAllSubresourcesAtOnce = CurrentState.AreAllSubresourcesSame() && DestinationState.AreAllSubresourcesSame();
@@ -224,10 +253,13 @@ namespace D3D12TranslationLayer
 
 #if DBG
             // This subresource should not already be in any transition list
+            // (an END_ONLY for the same resource is fine - it retires a split
+            // begun earlier in the command list).
             for (auto &desc : m_vResourceBarriers)
             {
                 assert(!(desc.Transition.pResource == pTransitioningResource &&
-                         desc.Transition.Subresource == TransitionDesc.Transition.Subresource));
+                         desc.Transition.Subresource == TransitionDesc.Transition.Subresource &&
+                         desc.Flags == D3D12_RESOURCE_BARRIER_FLAG_NONE));
             }
 #endif
 
@@ -247,6 +279,14 @@ namespace D3D12TranslationLayer
 
                     bUsedInCommandList = true;
                 }
+                else if ((after & D3D12_RESOURCE_STATE_UNORDERED_ACCESS) != 0 &&
+                         CurrentSubresourceState.WriteFenceValue == CurrentFenceValue)
+                {
+                    // Back-to-back UAV accesses in the same command list: the state
+                    // matches so no transition is emitted, but the accesses still
+                    // need ordering. One UAV barrier covers all such resources.
+                    m_bInsertUAVBarrier = true;
+                }
             }
             else if (CurrentState.SupportsSimultaneousAccess())
             {
@@ -293,11 +333,19 @@ namespace D3D12TranslationLayer
     {
         pManager->GetGraphicsCommandList()->ResourceBarrier(Count, pBarriers);
         pManager->AdditionalCommandsAdded();
+        m_ImmCtx.m_PerfCounters.m_ResourceBarriers.fetch_add(Count, std::memory_order_relaxed);
     }
 
     //----------------------------------------------------------------------------------------------------------------------------------
     void ResourceStateManager::SubmitResourceTransitions(CommandListManager *pManager) noexcept(false)
     {
+        if (m_bInsertUAVBarrier)
+        {
+            D3D12_RESOURCE_BARRIER UAVBarrier;
+            ZeroMemory(&UAVBarrier, sizeof(UAVBarrier));
+            UAVBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+            m_vResourceBarriers.push_back(UAVBarrier); // throw( bad_alloc )
+        }
         if (!m_vResourceBarriers.empty())
         {
             SubmitResourceBarriers(m_vResourceBarriers.data(), (UINT)m_vResourceBarriers.size(), pManager);
@@ -325,6 +373,101 @@ namespace D3D12TranslationLayer
         ResourceStateManager::TransitionSubresource(*pResource, SubresourceIndex, DesiredState);
     }
 
+    //----------------------------------------------------------------------------------------------------------------------------------
+    void ResourceStateManager::BeginTransition(Resource* pResource, D3D12_RESOURCE_STATES State) noexcept
+    {
+        CCurrentResourceState& CurrentState = pResource->GetIdentity()->m_currentState;
+        // Only the simple whole-resource case benefits: a pending desired state
+        // means the resource is about to transition anyway, per-subresource
+        // tracking makes "last use" ambiguous, and simultaneous-access
+        // resources need no transitions at all.
+        if (pResource->IsTransitionPending() ||
+            !CurrentState.AreAllSubresourcesSame() ||
+            CurrentState.SupportsSimultaneousAccess())
+        {
+            return;
+        }
+        for (auto const& Pending : m_vPendingSplitBarriers)
+        {
+            if (Pending.pOwner == pResource)
+            {
+                return;
+            }
+        }
+
+        D3D12_RESOURCE_STATES Before = CurrentState.GetSubresourceState(0).State;
+        D3D12_RESOURCE_STATES After = State;
+        if (!TransitionRequired(Before, /*inout*/ After, SubresourceTransitionFlags::None))
+        {
+            return;
+        }
+
+        D3D12_RESOURCE_BARRIER BeginDesc;
+        ZeroMemory(&BeginDesc, sizeof(BeginDesc));
+        BeginDesc.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        BeginDesc.Flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+        BeginDesc.Transition.pResource = pResource->GetUnderlyingResource();
+        BeginDesc.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        BeginDesc.Transition.StateBefore = Before;
+        BeginDesc.Transition.StateAfter = After;
+
+        try
+        {
+            m_vPendingSplitBarriers.push_back(
+                PendingSplitBarrier{ pResource, BeginDesc.Transition.pResource, Before, After });
+        }
+        catch (std::bad_alloc&)
+        {
+            // Only a hint - the next use just pays a full barrier.
+            return;
+        }
+
+        SubmitResourceBarriers(&BeginDesc, 1, m_ImmCtx.GetCommandListManager());
+        // Tracked state deliberately stays at Before; it advances when the END
+        // retires at the next use or at submission. Stamp the read fence so the
+        // underlying allocation outlives the list the END lands in.
+        pResource->UsedInCommandList(m_ImmCtx.GetCommandListID());
+    }
+
+    //----------------------------------------------------------------------------------------------------------------------------------
+    void ResourceStateManager::FlushPendingSplitBarriers(CommandListManager* pManager) noexcept
+    {
+        for (auto const& Pending : m_vPendingSplitBarriers)
+        {
+            D3D12_RESOURCE_BARRIER EndDesc;
+            ZeroMemory(&EndDesc, sizeof(EndDesc));
+            EndDesc.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            EndDesc.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+            EndDesc.Transition.pResource = Pending.pResource;
+            EndDesc.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            EndDesc.Transition.StateBefore = Pending.StateBefore;
+            EndDesc.Transition.StateAfter = Pending.StateAfter;
+            SubmitResourceBarriers(&EndDesc, 1, pManager);
+
+            if (Pending.pOwner)
+            {
+                CCurrentResourceState& CurrentState = Pending.pOwner->GetIdentity()->m_currentState;
+                CCurrentResourceState::SubresourceState NewState = CurrentState.GetSubresourceState(0);
+                NewState.State = Pending.StateAfter;
+                CurrentState.SetResourceState(NewState);
+            }
+        }
+        m_vPendingSplitBarriers.clear();
+    }
+
+    //----------------------------------------------------------------------------------------------------------------------------------
+    void ResourceStateManager::ResourceDestroyed(Resource* pResource) noexcept
+    {
+        for (auto& Pending : m_vPendingSplitBarriers)
+        {
+            if (Pending.pOwner == pResource)
+            {
+                Pending.pOwner = nullptr;
+                break;
+            }
+        }
+    }
+
     //----------------------------------------------------------------------------------------------------------------------------------
     void ResourceStateManager::ApplyAllResourceTransitions() noexcept(false)
     {
@@ -21,4 +21,26 @@ namespace D3D12TranslationLayer
 
         ThrowFailure(m_pParent->m_pDevice12->CreateRootSignature(1, pBlob, BlobSize, IID_PPV_ARGS(GetForCreate())));
     }
+    ID3D12CommandSignature* RootSignature::GetDispatchCommandSignature(UINT WorkPropertiesRootParam) noexcept(false)
+    {
+        // Recording is single-threaded per context, so no lock is needed for
+        // the lazy creation.
+        if (!m_spDispatchCommandSignature)
+        {
+            D3D12_INDIRECT_ARGUMENT_DESC Arguments[2] = {};
+            Arguments[0].Type = D3D12_INDIRECT_ARGUMENT_TYPE_CONSTANT_BUFFER_VIEW;
+            Arguments[0].ConstantBufferView.RootParameterIndex = WorkPropertiesRootParam;
+            Arguments[1].Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH;
+
+            D3D12_COMMAND_SIGNATURE_DESC Desc = {};
+            Desc.ByteStride = sizeof(DispatchIndirectCommand);
+            Desc.NumArgumentDescs = _countof(Arguments);
+            Desc.pArgumentDescs = Arguments;
+            Desc.NodeMask = 1;
+
+            ThrowFailure(m_pParent->m_pDevice12->CreateCommandSignature(
+                &Desc, GetForImmediateUse(), IID_PPV_ARGS(&m_spDispatchCommandSignature))); // throw( _com_error )
+        }
+        return m_spDispatchCommandSignature.get();
+    }
 };
\ No newline at end of file
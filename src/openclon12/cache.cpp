@@ -6,6 +6,7 @@
 #include "cache.hpp"
 #include "compiler.hpp"
 #include <numeric>
+#include <vector>
 
 #pragma warning(disable: 4100)
 
@@ -23,7 +24,7 @@ ShaderCache::ShaderCache(ID3D12Device* d, bool driverVersioned)
     Desc.Flags = driverVersioned ? D3D12_SHADER_CACHE_FLAG_DRIVER_VERSIONED : D3D12_SHADER_CACHE_FLAG_NONE;
 
     auto pCompiler = g_Platform->GetCompiler();
-    Desc.Version = pCompiler->GetVersionForCache();
+    Desc.Version = pCompiler->GetVersionForCache() ^ ((UINT64)c_LayerCacheVersion << 32);
 
     (void)device9->CreateShaderCacheSession(&Desc, IID_PPV_ARGS(&m_pSession));
 #endif
@@ -34,7 +35,26 @@ void ShaderCache::Store(const void* key, size_t keySize, const void* value, size
 #ifdef __ID3D12ShaderCacheSession_INTERFACE_DEFINED__
     if (m_pSession)
     {
-        (void)m_pSession->StoreValue(key, (UINT)keySize, value, (UINT)valueSize);
+        try
+        {
+            // Copy the key and value and let the write trickle out on the
+            // idle-priority cache-write thread; StoreValue's disk I/O would
+            // otherwise land on the tail of every compile and specialization.
+            // The lambda holds its own session reference so Close() resetting
+            // m_pSession can't pull it out from under a pending write.
+            std::vector<byte> data(keySize + valueSize);
+            memcpy(data.data(), key, keySize);
+            memcpy(data.data() + keySize, value, valueSize);
+            g_Platform->QueueCacheWrite([session = m_pSession, data = std::move(data), keySize]()
+            {
+                (void)session->StoreValue(data.data(), (UINT)keySize,
+                                          data.data() + keySize, (UINT)(data.size() - keySize));
+            });
+        }
+        catch (std::bad_alloc&)
+        {
+            (void)m_pSession->StoreValue(key, (UINT)keySize, value, (UINT)valueSize);
+        }
     }
 #endif
 }
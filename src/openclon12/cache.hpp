@@ -10,6 +10,11 @@
 class ShaderCache
 {
 public:
+    // Folded into the session version alongside the compiler version. Bump
+    // whenever the layer changes how keys are derived (e.g. the chunked
+    // hashing scheme in hashing.cpp) so stale entries are discarded.
+    static constexpr UINT c_LayerCacheVersion = 1;
+
     ShaderCache(ID3D12Device*, bool driverVersioned);
 
     bool HasCache() const
@@ -73,9 +73,19 @@ public:
     const std::vector<Kernel> &GetKernelInfo() const;
     const SpecConstantInfo *GetSpecConstantInfo(uint32_t ID) const;
 
+    // Flat serialization of the parsed metadata tables (kernels, args, spec
+    // constants, plus a string table). Program binaries append this after the
+    // SPIR-V so loading one rebuilds the tables with a validate-and-copy
+    // instead of a SPIR-V parse. Deserialize returns false (leaving the
+    // tables untouched) if the blob is malformed.
+    std::vector<uint8_t> SerializeKernelInfo() const;
+    bool DeserializeKernelInfo(const void* data, size_t size);
+
 protected:
     std::vector<Kernel> m_KernelInfo;
     std::unordered_map<uint32_t, SpecConstantInfo> m_SpecConstants;
+    // Backing store for strings referenced by deserialized kernel info.
+    std::vector<char> m_KernelInfoStrings;
 };
 
 // An abstraction over DXIL + metadata
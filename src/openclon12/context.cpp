@@ -675,6 +675,10 @@ Context::~Context()
         callback.m_pfn(this, callback.m_userData);
     }
 
+    for (auto& [device, d3dDevice] : m_DedicatedDevices)
+    {
+        device->ReleaseD3D(*d3dDevice);
+    }
     for (auto& [device, d3dDevice] : m_AssociatedDevices)
     {
         device->ReleaseD3D(*d3dDevice);
@@ -703,6 +707,25 @@ D3DDevice& Context::GetD3DDevice(cl_uint i) const noexcept
     return *m_AssociatedDevices[i].second;
 }
 
+D3DDevice &Context::CreateDedicatedD3DDevice(Device &device, D3DDevice &sharedDevice,
+                                             D3D12_COMMAND_QUEUE_PRIORITY QueuePriority)
+{
+    // Same ID3D12Device as the context's shared D3DDevice, so the dedicated
+    // queue's resources live on the same adapter and migrate without leaving it.
+    auto &d3dDevice = device.InitD3D(sharedDevice.GetDevice(), nullptr, true /* bDedicated */, QueuePriority);
+    try
+    {
+        std::lock_guard Lock(m_DedicatedDeviceLock);
+        m_DedicatedDevices.emplace_back(D3DDeviceAndRef{ &device, &d3dDevice });
+    }
+    catch (...)
+    {
+        device.ReleaseD3D(d3dDevice);
+        throw;
+    }
+    return d3dDevice;
+}
+
 D3DDevice *Context::D3DDeviceForContext(Device& device) const noexcept
 {
     auto iter = std::find_if(m_AssociatedDevices.begin(), m_AssociatedDevices.end(),
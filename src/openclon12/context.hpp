@@ -6,6 +6,7 @@
 #include "device.hpp"
 #include "gl_tokens.hpp"
 
+class Resource;
 struct GLProperties;
 struct d3d12_interop_device_info;
 struct mesa_glinterop_device_info;
@@ -22,6 +23,33 @@ public:
     virtual bool AcquireResources(std::vector<mesa_glinterop_export_in> &resources, GLsync *sync) = 0;
     virtual bool IsAppContextBoundToThread() = 0;
     bool SyncWait(GLsync fence, bool deleteSync);
+
+    // Runs fn on a single persistent waiter thread shared by all GLsync waits
+    // from this interop context. Waiting on a sync used to spawn and tear down
+    // a std::thread per call, which is measurable when an app creates a GL
+    // event every frame; the thread is started on first use instead.
+    template <typename Fn> void QueueSyncWait(Fn&& fn)
+    {
+        {
+            std::lock_guard lock(m_SyncWaitLock);
+            if (!m_SyncWaitThreadStarted)
+            {
+                m_SyncWaitScheduler.SetSchedulingMode({ 1u, BackgroundTaskScheduler::Priority::Normal });
+                m_SyncWaitThreadStarted = true;
+            }
+        }
+        struct Context { Fn m_fn; };
+        std::unique_ptr<Context> context(new Context{ std::forward<Fn>(fn) });
+        m_SyncWaitScheduler.QueueTask({
+            [](void* pContext)
+            {
+                std::unique_ptr<Context> context(static_cast<Context*>(pContext));
+                context->m_fn();
+            },
+            [](void* pContext) { delete static_cast<Context*>(pContext); },
+            context.get() });
+        context.release();
+    }
 protected:
     void PrepQueryDeviceInfo(mesa_glinterop_device_info &mesaDevInfo,
                              d3d12_interop_device_info &d3d12DevInfo);
@@ -34,6 +62,10 @@ protected:
     XPlatHelpers::unique_module m_hMod;
     decltype(&glWaitSync) m_WaitSync;
     decltype(&glDeleteSync) m_DeleteSync;
+
+    std::mutex m_SyncWaitLock;
+    bool m_SyncWaitThreadStarted = false;
+    BackgroundTaskScheduler::Scheduler m_SyncWaitScheduler;
 };
 
 class Context : public CLChildBase<Context, Platform, cl_context>
@@ -64,8 +96,29 @@ private:
     std::unique_ptr<GLInteropManager> m_GLInteropManager;
     ID3D12CommandQueue *m_GLCommandQueue = nullptr; // weak
 
+    // Dedicated per-queue D3DDevices (cl_msft_dedicated_queue). The context
+    // owns their InitD3D reference rather than the command queue: resources
+    // cache underlying allocations per D3DDevice for as long as they live,
+    // and every resource keeps the context alive, so the dedicated device
+    // must outlive the context's last resource, not just its queue.
+    std::mutex m_DedicatedDeviceLock;
+    std::vector<D3DDeviceAndRef> m_DedicatedDevices;
+
+    // Small plain buffers are carved out of shared slab buffers rather than
+    // each getting a committed D3D12 resource. The pool holds no references:
+    // the carved-out buffers keep their slab alive through their parent
+    // pointers, and an entry is dropped when its last range comes back.
+    struct BufferSlab
+    {
+        Resource* m_pResource;
+        std::vector<std::pair<size_t, size_t>> m_FreeRanges; // offset, size; sorted by offset
+    };
+    std::mutex m_BufferSlabLock;
+    std::vector<BufferSlab> m_BufferSlabs;
+
     static void CL_CALLBACK DummyCallback(const char*, const void*, size_t, void*) {}
 
+    friend class Resource;
     friend cl_int CL_API_CALL clGetContextInfo(cl_context, cl_context_info, size_t, void*, size_t*);
 
 public:
@@ -103,6 +156,10 @@ public:
     Device& GetDevice(cl_uint index) const noexcept;
     D3DDevice &GetD3DDevice(cl_uint index) const noexcept;
     D3DDevice *D3DDeviceForContext(Device &device) const noexcept;
+    // Creates a D3DDevice with its own D3D12 command queue and fence timeline
+    // for one command queue; released with the context (see m_DedicatedDevices).
+    D3DDevice &CreateDedicatedD3DDevice(Device &device, D3DDevice &sharedDevice,
+                                        D3D12_COMMAND_QUEUE_PRIORITY QueuePriority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL);
     GLInteropManager *GetGLManager() const noexcept { return m_GLInteropManager.get(); }
     void InsertGLWait(ID3D12Fence *fence, UINT64 value) const noexcept { m_GLCommandQueue->Wait(fence, value); }
     std::vector<D3DDeviceAndRef> GetDevices() const noexcept { return m_AssociatedDevices; }
@@ -7,7 +7,12 @@
 #include <wil/resource.h>
 #include <directx/d3d12compatibility.h>
 
+#include "spookyv2.h"
+
+#include <cstdlib>
+
 #include "ImmediateContext.inl"
+#include "View.inl"
 
 extern CL_API_ENTRY cl_int CL_API_CALL
 clGetDeviceIDs(cl_platform_id   platform,
@@ -40,6 +45,9 @@ clGetDeviceIDs(cl_platform_id   platform,
                 if (output < num_entries)
                 {
                     devices[output++] = device;
+                    // The caller is likely about to create a context here;
+                    // start driver initialization in the background now.
+                    device->PrewarmD3D();
                 }
             }
         }
@@ -231,7 +239,11 @@ clGetDeviceInfo(cl_device_id    device,
                 "cl_khr_byte_addressable_store "
                 "cl_khr_il_program "
                 "cl_khr_gl_sharing "
-                "cl_khr_gl_event ";
+                "cl_khr_gl_event "
+                "cl_msft_split_ndrange "
+                "cl_msft_batch_ndrange "
+                "cl_msft_dedicated_queue "
+                "cl_msft_queue_priority ";
             constexpr char imagesSupported[] = "cl_khr_3d_image_writes ";
             cl_int ret = RetValue(alwaysSupported);
             if (ret == CL_SUCCESS && !pDevice->IsMCDM())
@@ -249,6 +261,10 @@ clGetDeviceInfo(cl_device_id    device,
                 { CL_MAKE_VERSION(1, 0, 0), "cl_khr_il_program" },
                 { CL_MAKE_VERSION(1, 0, 0), "cl_khr_gl_sharing" },
                 { CL_MAKE_VERSION(1, 0, 0), "cl_khr_gl_event" },
+                { CL_MAKE_VERSION(1, 0, 0), "cl_msft_split_ndrange" },
+                { CL_MAKE_VERSION(1, 0, 0), "cl_msft_batch_ndrange" },
+                { CL_MAKE_VERSION(1, 0, 0), "cl_msft_dedicated_queue" },
+                { CL_MAKE_VERSION(1, 0, 0), "cl_msft_queue_priority" },
             };
             constexpr cl_name_version imagesSupported[] = {
                 { CL_MAKE_VERSION(1, 0, 0), "cl_khr_3d_image_writes" },
@@ -335,21 +351,53 @@ Device::Device(Platform& parent, IDXCoreAdapter* pAdapter)
     pAdapter->GetProperty(DXCoreAdapterProperty::HardwareID, sizeof(m_HWIDs), &m_HWIDs);
 }
 
-Device::~Device() = default;
+Device::~Device()
+{
+    // Joins the prewarm thread if ~Platform didn't already; a joinable
+    // std::thread member would otherwise terminate the process here.
+    ReleasePrewarmedD3D();
+}
 
-static ImmCtx::CreationArgs GetImmCtxCreationArgs()
+static ImmCtx::CreationArgs GetImmCtxCreationArgs(D3D12_COMMAND_QUEUE_PRIORITY QueuePriority)
 {
     ImmCtx::CreationArgs Args = {};
     Args.CreatorID = __uuidof(OpenCLOn12CreatorID);
+    Args.CommandQueuePriority = QueuePriority;
+    // Pre-size the shader-visible descriptor rings for workloads whose
+    // descriptor footprint is known up front, instead of growing through
+    // mid-command-list rollovers.
+    if (const char* Override = getenv("CLON12_VIEW_HEAP_SIZE"))
+    {
+        Args.ViewHeapStartingCountHint = (UINT32)strtoul(Override, nullptr, 10);
+    }
+    if (const char* Override = getenv("CLON12_SAMPLER_HEAP_SIZE"))
+    {
+        Args.SamplerHeapStartingCountHint = (UINT32)strtoul(Override, nullptr, 10);
+    }
+    // Retention policy for the upload/readback staging pools: the idle age
+    // (in fence values) before a pooled buffer is freed, and a cap in MB on
+    // the bytes each pool may keep parked. Long-running services tune these
+    // per deployment; either way the pools drain while the OS reports the
+    // process over its memory budget.
+    if (const char* Override = getenv("CLON12_POOL_TRIM_AGE"))
+    {
+        Args.BufferPoolTrimFenceAge = strtoull(Override, nullptr, 10);
+    }
+    if (const char* Override = getenv("CLON12_POOL_RETAIN_MB"))
+    {
+        Args.BufferPoolMaxRetainedBytes = strtoull(Override, nullptr, 10) * 1024 * 1024;
+    }
     return Args;
 }
 
 D3DDevice::D3DDevice(Device &parent, ID3D12Device *pDevice, ID3D12CommandQueue *pQueue,
-                     D3D12_FEATURE_DATA_D3D12_OPTIONS &options, bool IsImportedDevice)
+                     D3D12_FEATURE_DATA_D3D12_OPTIONS &options, bool IsImportedDevice,
+                     D3D12_COMMAND_QUEUE_PRIORITY QueuePriority)
     : m_IsImportedDevice(IsImportedDevice)
+    , m_bLowLatency(QueuePriority != D3D12_COMMAND_QUEUE_PRIORITY_NORMAL)
     , m_Parent(parent)
     , m_spDevice(pDevice)
-    , m_ImmCtx(options, pDevice, pQueue, GetImmCtxCreationArgs())
+    , m_ImmCtx(options, pDevice, pQueue, GetImmCtxCreationArgs(QueuePriority))
     , m_RecordingSubmission(new Submission)
     , m_ShaderCache(pDevice, false)
     , m_DriverShaderCache(pDevice, true)
@@ -357,6 +405,17 @@ D3DDevice::D3DDevice(Device &parent, ID3D12Device *pDevice, ID3D12CommandQueue *
     BackgroundTaskScheduler::SchedulingMode mode{ 1u, BackgroundTaskScheduler::Priority::Normal };
     m_ExecutionScheduler.SetSchedulingMode(mode);
     m_CompletionScheduler.SetSchedulingMode(mode);
+    m_CompletionWaitEvent.create();
+
+    // Seed the command allocator recycling ring so steady-state submission
+    // never creates an allocator mid-stream. Four covers the submissions
+    // typically in flight before the completion thread retires the oldest.
+    UINT AllocatorRingDepth = 4;
+    if (const char* Override = getenv("CLON12_COMMAND_ALLOCATOR_RING"))
+    {
+        AllocatorRingDepth = (UINT)atoi(Override);
+    }
+    m_ImmCtx.GetCommandListManager()->PreallocateCommandAllocators(AllocatorRingDepth);
 
     auto commandQueue = m_ImmCtx.GetCommandQueue();
     (void)commandQueue->GetTimestampFrequency(&m_TimestampFrequency);
@@ -370,16 +429,26 @@ D3DDevice::D3DDevice(Device &parent, ID3D12Device *pDevice, ID3D12CommandQueue *
         (INT64)Task::TimestampToNanoseconds(GPUTimestamp, m_TimestampFrequency);
 }
 
-D3DDevice &Device::InitD3D(ID3D12Device *pDevice, ID3D12CommandQueue *pQueue)
+D3DDevice &Device::InitD3D(ID3D12Device *pDevice, ID3D12CommandQueue *pQueue, bool bDedicated,
+                           D3D12_COMMAND_QUEUE_PRIORITY QueuePriority)
 {
+    assert(QueuePriority == D3D12_COMMAND_QUEUE_PRIORITY_NORMAL || bDedicated);
     std::lock_guard Lock(m_InitLock);
     for (auto &dev : m_D3DDevices)
     {
         bool deviceAndQueueMatches = pDevice == dev->GetDevice() &&
             (!pQueue || pQueue == dev->ImmCtx().GetCommandQueue());
-        if ((pDevice && deviceAndQueueMatches) ||
-            (!pDevice && !dev->m_IsImportedDevice))
+        if (!bDedicated && !dev->m_bDedicated &&
+            ((pDevice && deviceAndQueueMatches) ||
+             (!pDevice && !dev->m_IsImportedDevice)))
         {
+            if (dev == m_PrewarmedDevice)
+            {
+                // Hand the speculative prewarm reference to this context
+                // instead of counting a new one.
+                m_PrewarmedDevice = nullptr;
+                return *dev;
+            }
             ++dev->m_ContextCount;
             return *dev;
         }
@@ -395,7 +464,9 @@ D3DDevice &Device::InitD3D(ID3D12Device *pDevice, ID3D12CommandQueue *pQueue)
     try
     {
         m_D3DDevices.back() = new D3DDevice(*this, spD3D12Device.Get(),
-                                            pQueue, m_D3D12Options, pDevice != nullptr);
+                                            pQueue, m_D3D12Options, pDevice != nullptr && !bDedicated,
+                                            QueuePriority);
+        m_D3DDevices.back()->m_bDedicated = bDedicated;
     }
     catch (...) { m_D3DDevices.pop_back(); throw; }
 
@@ -419,6 +490,92 @@ void Device::ReleaseD3D(D3DDevice &device)
     m_D3DDevices.pop_back();
 }
 
+void Device::PrewarmD3D() noexcept
+{
+    static bool Enabled = []()
+    {
+        const char* Override = getenv("CLON12_PREWARM");
+        return !Override || strtoul(Override, nullptr, 10) != 0;
+    }();
+    if (!Enabled)
+    {
+        return;
+    }
+    std::lock_guard Lock(m_InitLock);
+    if (m_PrewarmQueued || m_PrewarmCancelled || !m_D3DDevices.empty())
+    {
+        return;
+    }
+    try
+    {
+        m_PrewarmThread = std::thread([this]()
+        {
+            {
+                std::lock_guard Lock(m_InitLock);
+                // A context beat us to it (or the platform is going away);
+                // nothing left to hide.
+                if (m_PrewarmCancelled || !m_D3DDevices.empty())
+                {
+                    return;
+                }
+            }
+            try
+            {
+                D3DDevice &device = InitD3D();
+                bool bRelease = false;
+                {
+                    std::lock_guard Lock(m_InitLock);
+                    if (m_PrewarmCancelled)
+                    {
+                        bRelease = true;
+                    }
+                    else
+                    {
+                        m_PrewarmedDevice = &device;
+                    }
+                }
+                if (bRelease)
+                {
+                    ReleaseD3D(device);
+                }
+            }
+            catch (...)
+            {
+                // Speculative only; the first context reports any real error.
+            }
+        });
+        m_PrewarmQueued = true;
+    }
+    catch (...)
+    {
+        // Couldn't start the thread; the first context does the init itself.
+    }
+}
+
+void Device::ReleasePrewarmedD3D() noexcept
+{
+    std::thread thread;
+    {
+        std::lock_guard Lock(m_InitLock);
+        m_PrewarmCancelled = true;
+        thread = std::move(m_PrewarmThread);
+    }
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+    D3DDevice *pDevice = nullptr;
+    {
+        std::lock_guard Lock(m_InitLock);
+        pDevice = m_PrewarmedDevice;
+        m_PrewarmedDevice = nullptr;
+    }
+    if (pDevice)
+    {
+        ReleaseD3D(*pDevice);
+    }
+}
+
 cl_bool Device::IsAvailable() const noexcept
 {
     bool driverUpdateInProgress = true;
@@ -520,6 +677,12 @@ void D3DDevice::SubmitTask(Task* task, TaskPoolLock const& lock)
     // User commands are treated as 'submitted' when they're created
     task->Submit();
 
+    // Collapse dependencies whose epoch has passed: anything covered by a
+    // completed fence value is satisfied whether or not its CPU-side
+    // completion has run yet, and dropping it here frees those tasks without
+    // waiting for the completion thread to walk their waiter sets.
+    task->PruneSatisfiedDependencies(lock);
+
     if (task->m_TasksToWaitOn.empty())
     {
         ReadyTask(task, lock);
@@ -561,6 +724,22 @@ void D3DDevice::ReadyTask(Task* task, TaskPoolLock const& lock)
     task->Ready(lock);
 }
 
+// Number of recorded-but-unsubmitted tasks at which a flush stops deferring
+// and submits even though earlier work is still in flight. Configurable via
+// CLON12_FLUSH_BATCH_SIZE; 0 or 1 submits on every flush.
+static UINT GetFlushBatchThreshold()
+{
+    static const UINT Threshold = []() -> UINT
+    {
+        if (const char* Override = getenv("CLON12_FLUSH_BATCH_SIZE"))
+        {
+            return (UINT)strtoul(Override, nullptr, 10);
+        }
+        return 8;
+    }();
+    return Threshold;
+}
+
 void D3DDevice::Flush(TaskPoolLock const&)
 {
     if (m_RecordingSubmission->empty())
@@ -568,6 +747,22 @@ void D3DDevice::Flush(TaskPoolLock const&)
         return;
     }
 
+    // Adaptive batching: while a previous submission is still in flight, let
+    // small submissions accumulate rather than paying ExecuteCommandLists
+    // overhead per clFlush - some apps flush after nearly every enqueue. The
+    // completion handler in ExecuteTasks re-flushes all devices, so anything
+    // deferred here is submitted as soon as the in-flight work drains, and
+    // blocking waits are delayed by at most that submission's latency.
+    // Low-latency devices (non-normal cl_msft_queue_priority) skip the
+    // batching entirely - they exist to hit frame deadlines, not to amortize
+    // submission overhead.
+    if (!m_bLowLatency &&
+        m_SubmissionsInFlight > 0 &&
+        m_RecordingSubmission->size() < GetFlushBatchThreshold())
+    {
+        return;
+    }
+
     struct ExecutionHandler
     {
         D3DDevice& m_Device;
@@ -589,7 +784,191 @@ void D3DDevice::Flush(TaskPoolLock const&)
     });
     spHandler.release();
 
+    ++m_SubmissionsInFlight;
     m_RecordingSubmission.reset(new Submission);
+    // The batch travels with the submission that owns it; the next initial
+    // data upload starts a fresh one.
+    m_PendingUploadBatch = nullptr;
+}
+
+std::shared_ptr<D3D12TranslationLayer::RootSignature> D3DDevice::GetRootSignature(ID3DBlob* pSerializedBlob)
+{
+    std::pair<uint64_t, uint64_t> hash;
+    SpookyHash::Hash128(pSerializedBlob->GetBufferPointer(), pSerializedBlob->GetBufferSize(), &hash.first, &hash.second);
+
+    std::lock_guard lock(m_RootSignatureCacheLock);
+    auto& entry = m_RootSignatureCache[hash];
+    auto spRS = entry.lock();
+    if (!spRS)
+    {
+        spRS = std::make_shared<D3D12TranslationLayer::RootSignature>(&m_ImmCtx);
+        spRS->Create(pSerializedBlob->GetBufferPointer(), pSerializedBlob->GetBufferSize());
+        entry = spRS;
+    }
+    return spRS;
+}
+
+D3DDevice::PrintfBuffer D3DDevice::AcquirePrintfBuffer(UINT BufferSize)
+{
+    PrintfBuffer Buffer;
+    {
+        std::lock_guard lock(m_PrintfBufferPoolLock);
+        if (!m_PrintfBufferPool.empty())
+        {
+            Buffer = std::move(m_PrintfBufferPool.back());
+            m_PrintfBufferPool.pop_back();
+        }
+    }
+
+    if (!Buffer.spResource)
+    {
+        D3D12TranslationLayer::ResourceCreationArgs Args = {};
+        Args.m_bManageResidency = true;
+        Args.m_appDesc.m_Subresources = 1;
+        Args.m_appDesc.m_SubresourcesPerPlane = 1;
+        Args.m_appDesc.m_NonOpaquePlaneCount = 1;
+        Args.m_appDesc.m_MipLevels = 1;
+        Args.m_appDesc.m_ArraySize = 1;
+        Args.m_appDesc.m_Depth = 1;
+        Args.m_appDesc.m_Width = BufferSize;
+        Args.m_appDesc.m_Height = 1;
+        Args.m_appDesc.m_Format = DXGI_FORMAT_UNKNOWN;
+        Args.m_appDesc.m_Samples = 1;
+        Args.m_appDesc.m_Quality = 0;
+        Args.m_appDesc.m_resourceDimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        Args.m_appDesc.m_usage = D3D12TranslationLayer::RESOURCE_USAGE_DEFAULT;
+        Args.m_appDesc.m_bindFlags = D3D12TranslationLayer::RESOURCE_BIND_UNORDERED_ACCESS;
+        Args.m_appDesc.m_cpuAcess = D3D12TranslationLayer::RESOURCE_CPU_ACCESS_READ | D3D12TranslationLayer::RESOURCE_CPU_ACCESS_WRITE;
+        Args.m_desc12 = CD3DX12_RESOURCE_DESC::Buffer(BufferSize, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        Args.m_heapDesc = CD3DX12_HEAP_DESC(0, CD3DX12_HEAP_PROPERTIES(D3D12_CPU_PAGE_PROPERTY_WRITE_COMBINE, D3D12_MEMORY_POOL_L0), D3D12_HEAP_FLAG_CREATE_NOT_RESIDENT);
+
+        Buffer.spResource = D3D12TranslationLayer::Resource::CreateResource(
+            &m_ImmCtx, Args, D3D12TranslationLayer::ResourceAllocationContext::FreeThread); // throw( _com_error )
+
+        constexpr D3D12_RANGE EmptyRange = {};
+        D3D12TranslationLayer::ThrowFailure(
+            Buffer.spResource->GetUnderlyingResource()->Map(0, &EmptyRange, &Buffer.pMappedData));
+
+        D3D12_UNORDERED_ACCESS_VIEW_DESC UAVDesc = {};
+        UAVDesc.ViewDimension = D3D12_UAV_DIMENSION_BUFFER;
+        UAVDesc.Format = DXGI_FORMAT_R32_TYPELESS;
+        UAVDesc.Buffer.Flags = D3D12_BUFFER_UAV_FLAG_RAW;
+        UAVDesc.Buffer.FirstElement = 0;
+        UAVDesc.Buffer.NumElements = BufferSize / 4;
+        Buffer.spUAV.reset(new D3D12TranslationLayer::UAV(&m_ImmCtx, UAVDesc, *Buffer.spResource.get())); // throw( bad_alloc, _com_error )
+    }
+
+    // Reset just the two-uint header: the next write offset and the buffer
+    // size. Stale payload beyond the offset is never parsed, and fresh D3D12
+    // heap memory is zero-initialized, so the rest needs no clearing.
+    const uint32_t Header[2] = { sizeof(uint32_t) * 2, BufferSize };
+    memcpy(Buffer.pMappedData, Header, sizeof(Header));
+    return Buffer;
+}
+
+void D3DDevice::ReleasePrintfBuffer(PrintfBuffer Buffer) noexcept
+{
+    std::lock_guard lock(m_PrintfBufferPoolLock);
+    try
+    {
+        m_PrintfBufferPool.push_back(std::move(Buffer));
+    }
+    catch (std::bad_alloc&)
+    {
+        // The buffer is simply destroyed instead of pooled.
+    }
+}
+
+D3D12TranslationLayer::Sampler& D3DDevice::GetCachedSampler(
+    cl_bool NormalizedCoords, cl_addressing_mode AddressingMode,
+    cl_filter_mode FilterMode, D3D12_SAMPLER_DESC const& Desc12)
+{
+    std::lock_guard lock(m_SamplerCacheLock);
+    auto ret = m_SamplerCache.try_emplace(
+        std::make_tuple(NormalizedCoords, AddressingMode, FilterMode),
+        &m_ImmCtx, Desc12);
+    return ret.first->second;
+}
+
+D3D12_FEATURE_DATA_FORMAT_SUPPORT const& D3DDevice::GetFormatSupport(DXGI_FORMAT Format)
+{
+    assert((size_t)Format < std::extent_v<decltype(m_FormatSupport)>);
+    std::call_once(m_FormatSupportOnce, [this]()
+    {
+        for (UINT i = 0; i < std::extent_v<decltype(m_FormatSupport)>; ++i)
+        {
+            m_FormatSupport[i].Format = (DXGI_FORMAT)i;
+            if (FAILED(m_spDevice->CheckFeatureSupport(
+                D3D12_FEATURE_FORMAT_SUPPORT, &m_FormatSupport[i], sizeof(m_FormatSupport[i]))))
+            {
+                m_FormatSupport[i].Support1 = D3D12_FORMAT_SUPPORT1_NONE;
+                m_FormatSupport[i].Support2 = D3D12_FORMAT_SUPPORT2_NONE;
+            }
+        }
+    });
+    return m_FormatSupport[Format];
+}
+
+void D3DDevice::SetComputeState(ID3D12RootSignature* pRS, ID3D12PipelineState* pPSO)
+{
+    ID3D12GraphicsCommandList* pCmdList = m_ImmCtx.GetGraphicsCommandList();
+    UINT64 CommandListID = m_ImmCtx.GetCommandListID();
+    if (CommandListID != m_ComputeStateCommandListID)
+    {
+        m_pLastComputeRootSignature = nullptr;
+        m_pLastComputePipelineState = nullptr;
+        m_ComputeStateCommandListID = CommandListID;
+    }
+    if (m_pLastComputeRootSignature != pRS)
+    {
+        pCmdList->SetComputeRootSignature(pRS);
+        m_pLastComputeRootSignature = pRS;
+    }
+    if (m_pLastComputePipelineState != pPSO)
+    {
+        pCmdList->SetPipelineState(pPSO);
+        m_pLastComputePipelineState = pPSO;
+    }
+}
+
+void D3DDevice::SetComputeDescriptorTable(UINT RootParam, bool bSamplerHeap,
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> const& SrcDescriptors)
+{
+    auto& Heap = bSamplerHeap ? m_ImmCtx.m_SamplerHeap : m_ImmCtx.m_ViewHeap;
+    auto& Shadow = bSamplerHeap ? m_LastSamplerTable : m_LastViewTable;
+    auto HeapType = bSamplerHeap ? D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER : D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    ID3D12GraphicsCommandList* pCmdList = m_ImmCtx.GetGraphicsCommandList();
+    const UINT64 CommandListID = m_ImmCtx.GetCommandListID();
+
+    // Ring slots reserved earlier in this command list aren't handed out
+    // again until the list's fence retires, so a staged copy only goes stale
+    // when the list or the heap itself changes.
+    bool bStagedCopyValid = CommandListID == Shadow.CommandListID &&
+        Heap.m_pDescriptorHeap.get() == Shadow.pHeap &&
+        SrcDescriptors == Shadow.SrcDescriptors;
+    if (!bStagedCopyValid)
+    {
+        UINT NumDescriptors = (UINT)SrcDescriptors.size();
+        UINT Slot = m_ImmCtx.ReserveSlots(Heap, NumDescriptors); // Can roll the heap over
+        m_ImmCtx.m_pDevice12->CopyDescriptors(1, &Heap.CPUHandle(Slot), &NumDescriptors,
+                                              NumDescriptors, SrcDescriptors.data(), nullptr, HeapType);
+        Shadow.CommandListID = CommandListID;
+        Shadow.pHeap = Heap.m_pDescriptorHeap.get();
+        Shadow.pBoundRootSignature = nullptr;
+        Shadow.SrcDescriptors = SrcDescriptors; // throw( bad_alloc )
+        Shadow.Table = Heap.GPUHandle(Slot);
+    }
+    else if (Shadow.pBoundRootSignature == m_pLastComputeRootSignature &&
+             Shadow.RootParam == RootParam)
+    {
+        // Same table already bound at the same parameter of the currently
+        // bound root signature - nothing to record. Address reuse isn't a
+        // concern for the same reason as the compute state shadow above.
+        return;
+    }
+    pCmdList->SetComputeRootDescriptorTable(RootParam, Shadow.Table);
+    Shadow.pBoundRootSignature = m_pLastComputeRootSignature;
+    Shadow.RootParam = RootParam;
 }
 
 void Device::FlushAllDevices(TaskPoolLock const& Lock)
@@ -604,47 +983,107 @@ void Device::FlushAllDevices(TaskPoolLock const& Lock)
 void D3DDevice::ExecuteTasks(std::unique_ptr<Submission> spTasks)
 {
     auto &tasks = *spTasks;
-    for (cl_uint i = 0; i < tasks.size(); ++i)
+    // Record the whole submission back-to-back before touching the task pool lock.
+    // All recording is serialized onto the single ImmediateContext anyway, and for
+    // large flushes the per-task lock acquire/release was a measurable fraction of
+    // the recording thread's time, stalling API threads that wanted the same lock.
+    size_t NumRecorded = 0;
+    try
     {
-        try
+        for (; NumRecorded < tasks.size(); ++NumRecorded)
         {
-            auto& task = tasks[i];
-            task->Record();
-            auto Lock = g_Platform->GetTaskPoolLock();
-            task->Started(Lock);
+            tasks[NumRecorded]->Record();
         }
-        catch (...)
+    }
+    catch (...)
+    {
+        auto Lock = g_Platform->GetTaskPoolLock();
+        if ((cl_int)tasks[NumRecorded]->GetState() > 0)
         {
-            auto Lock = g_Platform->GetTaskPoolLock();
-            if ((cl_int)tasks[i]->GetState() > 0)
-            {
-                tasks[i]->Complete(CL_OUT_OF_RESOURCES, Lock);
-            }
-            for (size_t j = i + 1; j < tasks.size(); ++j)
+            tasks[NumRecorded]->Complete(CL_OUT_OF_RESOURCES, Lock);
+        }
+        for (size_t j = NumRecorded + 1; j < tasks.size(); ++j)
+        {
+            tasks[j]->Complete(CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST, Lock);
+        }
+        tasks.erase(tasks.begin() + NumRecorded, tasks.end());
+    }
+    // Submit the whole batch behind one fence value. Every task in this
+    // submission is covered by the same monotonically increasing value, so
+    // completion needs a single fence wait rather than per-task machinery.
+    try
+    {
+        ImmCtx().Flush();
+    }
+    catch (...)
+    {
+        // The recorded work never reached ExecuteCommandLists, so the fence
+        // value below names the *previous* submission - stamping these tasks
+        // with it would signal their events while their commands still sit in
+        // the open command list. Fail them like the record path instead; the
+        // completion handler still runs (against the already-submitted fence)
+        // to keep the in-flight count and deferred-flush bookkeeping intact.
+        auto Lock = g_Platform->GetTaskPoolLock();
+        for (auto& task : tasks)
+        {
+            if ((cl_int)task->GetState() > 0)
             {
-                auto& task = tasks[j];
-                task->Complete(CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST, Lock);
+                task->Complete(CL_OUT_OF_RESOURCES, Lock);
             }
-            tasks.erase(tasks.begin() + i, tasks.end());
+        }
+        tasks.clear();
+    }
+    const UINT64 CoveringFenceValue = ImmCtx().GetCommandListID() - 1;
+
+    {
+        // Transition everything that recorded successfully in one lock acquisition.
+        auto Lock = g_Platform->GetTaskPoolLock();
+        for (auto& task : tasks)
+        {
+            task->m_CoveringFenceValue = CoveringFenceValue;
+            task->Started(Lock);
         }
     }
 
     struct CompletionHandler
     {
-        XPlatHelpers::unique_event m_Event;
+        D3DDevice* m_Device;
+        UINT64 m_FenceValue;
         std::unique_ptr<Submission> m_Tasks;
     };
     std::unique_ptr<CompletionHandler> spHandler(new CompletionHandler);
-    spHandler->m_Event.create();
+    spHandler->m_Device = this;
+    spHandler->m_FenceValue = CoveringFenceValue;
     spHandler->m_Tasks = std::move(spTasks);
-    ImmCtx().EnqueueSetEvent(spHandler->m_Event.get());
     m_CompletionScheduler.QueueTask({
         [](void* pContext)
         {
             std::unique_ptr<CompletionHandler> spHandler(static_cast<CompletionHandler*>(pContext));
-            spHandler->m_Event.wait();
+            // The completion scheduler is single-threaded and submissions are
+            // queued in submission order, so the device's wait event can be
+            // reused here without ever having two waiters on it. If the fence
+            // already passed the covering value there's nothing to wait for.
+            auto pFence = spHandler->m_Device->ImmCtx().GetFence();
+            if (pFence->GetCompletedValue() < spHandler->m_FenceValue)
+            {
+                auto& Event = spHandler->m_Device->m_CompletionWaitEvent;
+                if (SUCCEEDED(pFence->SetEventOnCompletion(spHandler->m_FenceValue, Event.get())))
+                {
+                    Event.wait();
+                }
+                else
+                {
+                    while (pFence->GetCompletedValue() < spHandler->m_FenceValue)
+                    {
+                        Sleep(1);
+                    }
+                }
+            }
 
             auto Lock = g_Platform->GetTaskPoolLock();
+            // This submission is done: anything the batching policy in Flush
+            // deferred behind it is free to go in the FlushAllDevices below.
+            --spHandler->m_Device->m_SubmissionsInFlight;
             for (auto& task : *spHandler->m_Tasks)
             {
                 task->Complete(CL_SUCCESS, Lock);
@@ -3,11 +3,17 @@
 #pragma once
 #include "platform.hpp"
 #include "cache.hpp"
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
+#include <thread>
+#include <tuple>
 
 #include "ImmediateContext.hpp"
+#include "RootSignature.hpp"
+#include "Sampler.hpp"
 using ImmCtx = D3D12TranslationLayer::ImmediateContext;
 
 class Task;
@@ -23,6 +29,7 @@ public:
     ShaderCache &GetDriverShaderCache() const noexcept { return m_DriverShaderCache; }
 
     ImmCtx& ImmCtx() noexcept { return m_ImmCtx; }
+    bool IsImportedDevice() const noexcept { return m_IsImportedDevice; }
     UINT64 GetTimestampFrequency() const noexcept { return m_TimestampFrequency; }
     INT64 GPUToQPCTimestampOffset() const noexcept { return m_GPUToQPCTimestampOffset; }
 
@@ -30,12 +37,77 @@ public:
     void ReadyTask(Task*, TaskPoolLock const&);
     void Flush(TaskPoolLock const&);
 
+    // Returns a root signature for the given serialized blob, deduplicated
+    // against every other layout created on this device: most kernels share
+    // a handful of layouts, and identical blobs map to one shared object.
+    std::shared_ptr<D3D12TranslationLayer::RootSignature> GetRootSignature(ID3DBlob* pSerializedBlob);
+
+    // Pooled printf output buffers, reused across enqueues so each launch of a
+    // printf-enabled kernel doesn't allocate and initialize a fresh buffer.
+    // Entries live on a CPU-visible heap and stay persistently mapped so the
+    // header can be reset on acquire and the output parsed after completion
+    // without going through the immediate context.
+    struct PrintfBuffer
+    {
+        D3D12TranslationLayer::unique_comptr<D3D12TranslationLayer::Resource> spResource;
+        std::unique_ptr<D3D12TranslationLayer::UAV> spUAV;
+        void* pMappedData = nullptr;
+    };
+    PrintfBuffer AcquirePrintfBuffer(UINT BufferSize); // throw( bad_alloc, _com_error )
+    void ReleasePrintfBuffer(PrintfBuffer Buffer) noexcept;
+
+    // Binds the compute root signature and PSO, skipping whichever is already
+    // recorded on the current command list: long runs of identical kernel
+    // launches otherwise re-bind the same state once per enqueue. Kernel
+    // record is the only path that sets compute state on this context, and
+    // recording happens on the single execution thread.
+    void SetComputeState(ID3D12RootSignature* pRS, ID3D12PipelineState* pPSO);
+
+    // Stages kernel argument descriptors into the online view or sampler heap
+    // and binds them as a compute root descriptor table, shadowing the last
+    // table of each type: back-to-back launches of the same kernel present an
+    // identical source descriptor list, and the copy staged for the previous
+    // launch stays valid for the rest of the command list, so repeats skip
+    // the ring-buffer reservation, the descriptor copy, and - when the root
+    // signature didn't change in between - the root binding itself. View and
+    // sampler descriptors are written once and never rewritten in this layer,
+    // so source-handle equality implies identical contents. Same threading
+    // contract as SetComputeState.
+    void SetComputeDescriptorTable(UINT RootParam, bool bSamplerHeap,
+        std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> const& SrcDescriptors);
+
+    // Samplers deduplicated by their CL creation parameters. The full space is
+    // only ~20 combinations, so every app sampler and every kernel's constant
+    // samplers with the same config share one descriptor, and entries live for
+    // the lifetime of the device. Desc12 is the D3D12 translation of the same
+    // tuple; it's passed in so this header doesn't depend on the CL sampler.
+    D3D12TranslationLayer::Sampler& GetCachedSampler(
+        cl_bool NormalizedCoords, cl_addressing_mode AddressingMode,
+        cl_filter_mode FilterMode, D3D12_SAMPLER_DESC const& Desc12);
+
+    // Format support for every DXGI format that can map to a CL image format,
+    // queried once per device on first use: clGetSupportedImageFormats
+    // otherwise issues one CheckFeatureSupport per format on every call.
+    // Formats that fail the query read back as unsupported.
+    D3D12_FEATURE_DATA_FORMAT_SUPPORT const& GetFormatSupport(DXGI_FORMAT Format);
+
     //std::unique_ptr<D3D12TranslationLayer::PipelineState> CreatePSO(D3D12TranslationLayer::COMPUTE_PIPELINE_STATE_DESC const& Desc);
     Device &GetParent() const noexcept { return m_Parent; }
 
+    // The coalesced initial-data upload task in the submission currently
+    // being recorded, if any. Buffer initial data (CL_MEM_COPY_HOST_PTR) is
+    // appended to this task instead of spawning one task per resource, so
+    // creating thousands of initialized buffers records one grouped copy
+    // rather than one task and staging allocation each. Guarded by the task
+    // pool lock; Flush clears it when the submission is handed off so later
+    // uploads start a new batch.
+    class BatchedUploadTask* GetPendingUploadBatch(TaskPoolLock const&) const noexcept { return m_PendingUploadBatch; }
+    void SetPendingUploadBatch(class BatchedUploadTask* p, TaskPoolLock const&) noexcept { m_PendingUploadBatch = p; }
+
 protected:
     D3DDevice(Device &parent, ID3D12Device *pDevice, ID3D12CommandQueue *pQueue,
-              D3D12_FEATURE_DATA_D3D12_OPTIONS &options, bool IsImportedDevice);
+              D3D12_FEATURE_DATA_D3D12_OPTIONS &options, bool IsImportedDevice,
+              D3D12_COMMAND_QUEUE_PRIORITY QueuePriority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL);
     ~D3DDevice() = default;
 
     friend class Device;
@@ -43,20 +115,94 @@ protected:
     void ExecuteTasks(std::unique_ptr<Submission> spTasks);
     unsigned m_ContextCount = 1;
     const bool m_IsImportedDevice;
+    // Created for exactly one command queue (cl_msft_dedicated_queue) and
+    // never coalesced onto by InitD3D's sharing logic.
+    bool m_bDedicated = false;
+    // Set for queues created at non-normal D3D12 priority
+    // (cl_msft_queue_priority): Flush submits eagerly instead of letting
+    // small submissions accumulate behind in-flight work, trading
+    // ExecuteCommandLists overhead for latency.
+    const bool m_bLowLatency;
 
     Device &m_Parent;
     const ComPtr<ID3D12Device> m_spDevice;
+    // TODO: Transfers currently share this single direct-queue context with
+    // dispatches, so large reads/writes serialize behind compute. A dedicated
+    // D3D12_COMMAND_LIST_TYPE_COPY engine would let DMA overlap compute, but
+    // the trimmed translation layer assumes one queue throughout: resource
+    // state tracking, residency, and the upload/readback pools are all keyed
+    // to the one CommandListManager fence. Adding a copy engine means either
+    // restoring multi-queue support in the layer or a parallel recording path
+    // with its own pools plus cross-queue fences in the task model.
     ::ImmCtx m_ImmCtx;
 
     std::unique_ptr<Submission> m_RecordingSubmission;
+    // Weak pointer into m_RecordingSubmission, which owns the task.
+    class BatchedUploadTask* m_PendingUploadBatch = nullptr;
+
+    // Guarded by the task pool lock; counts submissions handed to the
+    // execution scheduler whose completion handlers haven't run yet.
+    UINT m_SubmissionsInFlight = 0;
 
+    // Single-threaded recording worker: Flush hands each submission to this
+    // scheduler and returns without recording anything, so clFlush stays
+    // cheap even when the batch contains heavy dispatch recording. The
+    // worker's ExecuteTasks records into the immediate context and submits;
+    // the completion scheduler's one thread then waits out the covering
+    // fence value and runs completion handlers.
     BackgroundTaskScheduler::Scheduler m_ExecutionScheduler;
     BackgroundTaskScheduler::Scheduler m_CompletionScheduler;
+    // Auto-reset event used by the single completion thread to wait for a
+    // submission's covering fence value; reused across submissions.
+    XPlatHelpers::unique_event m_CompletionWaitEvent;
     mutable ShaderCache m_ShaderCache;
     mutable ShaderCache m_DriverShaderCache;
 
     UINT64 m_TimestampFrequency = 0;
     INT64 m_GPUToQPCTimestampOffset = 0;
+
+    // Keyed by the 128-bit hash of the serialized root signature blob. The
+    // cache holds weak references: entries go away with the last kernel
+    // specialization that uses them, and stale slots are reused on lookup.
+    std::mutex m_RootSignatureCacheLock;
+    std::map<std::pair<uint64_t, uint64_t>, std::weak_ptr<D3D12TranslationLayer::RootSignature>> m_RootSignatureCache;
+
+    std::mutex m_PrintfBufferPoolLock;
+    std::vector<PrintfBuffer> m_PrintfBufferPool;
+
+    std::mutex m_SamplerCacheLock;
+    std::map<std::tuple<cl_bool, cl_addressing_mode, cl_filter_mode>, D3D12TranslationLayer::Sampler> m_SamplerCache;
+
+    // Sized to cover every DXGI format with a CL mapping (the reverse
+    // translation table in formats.hpp ends at B8G8R8A8_UNORM).
+    std::once_flag m_FormatSupportOnce;
+    D3D12_FEATURE_DATA_FORMAT_SUPPORT m_FormatSupport[DXGI_FORMAT_B8G8R8A8_UNORM + 1] = {};
+
+    // Compute state last recorded into the command list identified by
+    // m_ComputeStateCommandListID; weak pointers, only compared for identity.
+    // Objects referenced by an open command list are kept alive through the
+    // deferred deletion queue, so an address can't be reused within one list.
+    UINT64 m_ComputeStateCommandListID = 0;
+    ID3D12RootSignature* m_pLastComputeRootSignature = nullptr;
+    ID3D12PipelineState* m_pLastComputePipelineState = nullptr;
+
+    // Shadow of the last descriptor table of each type staged by
+    // SetComputeDescriptorTable. The heap pointer is compared for identity
+    // only, to detect a mid-list rollover swapping the online heap out from
+    // under the staged copy; the root signature records which signature the
+    // table was last bound against, since rebinding a signature clears its
+    // root arguments.
+    struct ShadowedDescriptorTable
+    {
+        UINT64 CommandListID = 0;
+        ID3D12DescriptorHeap* pHeap = nullptr;
+        ID3D12RootSignature* pBoundRootSignature = nullptr;
+        UINT RootParam = 0;
+        std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> SrcDescriptors;
+        D3D12_GPU_DESCRIPTOR_HANDLE Table = {};
+    };
+    ShadowedDescriptorTable m_LastViewTable;
+    ShadowedDescriptorTable m_LastSamplerTable;
 };
 
 class Device : public CLChildBase<Device, Platform, cl_device_id>
@@ -86,7 +232,14 @@ public:
         return { m_D3D12Options1.WaveLaneCountMin, m_D3D12Options1.WaveLaneCountMax };
     }
 
-    D3DDevice &InitD3D(ID3D12Device *device = nullptr, ID3D12CommandQueue *queue = nullptr);
+    // With bDedicated, always creates a fresh D3DDevice - its own D3D12
+    // command queue, fence timeline, and execution/completion threads - that
+    // later InitD3D calls never share. Pass the context's ID3D12Device so the
+    // dedicated queue lives on the same device and resources migrate between
+    // queues without leaving the adapter. QueuePriority requires bDedicated;
+    // the shared queue's priority serves every queue on the device.
+    D3DDevice &InitD3D(ID3D12Device *device = nullptr, ID3D12CommandQueue *queue = nullptr, bool bDedicated = false,
+                       D3D12_COMMAND_QUEUE_PRIORITY QueuePriority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL);
     void ReleaseD3D(D3DDevice &device);
     void SetDefaultDevice() { m_DefaultDevice = true; }
 
@@ -94,6 +247,20 @@ public:
     void CloseCaches();
     void FlushAllDevices(TaskPoolLock const& Lock);
 
+    // Speculative InitD3D on a short-lived background thread: apps almost
+    // always create a context on the device they just queried, and the first
+    // clCreateContext otherwise absorbs the full driver initialization. A
+    // dedicated thread rather than a scheduler task because the background
+    // pools sit at zero threads until a device is active and would cancel
+    // the work. The prewarm reference is handed to the first context that
+    // coalesces onto the warm device. Best-effort - failures are swallowed
+    // and the first context just does the init itself. CLON12_PREWARM=0
+    // disables this for enumeration-only tools that never create a context.
+    void PrewarmD3D() noexcept;
+    // Joins the prewarm thread and drops the speculative reference. Called
+    // from ~Platform while the schedulers a release may touch are alive.
+    void ReleasePrewarmedD3D() noexcept;
+
 protected:
     void CacheCaps(std::lock_guard<std::mutex> const&, ComPtr<ID3D12Device> spDevice = {});
 
@@ -105,6 +272,10 @@ protected:
     std::mutex m_InitLock;
     bool m_CapsValid = false;
     bool m_DefaultDevice = false;
+    bool m_PrewarmQueued = false;
+    bool m_PrewarmCancelled = false;
+    D3DDevice* m_PrewarmedDevice = nullptr;
+    std::thread m_PrewarmThread;
     D3D12_FEATURE_DATA_D3D12_OPTIONS m_D3D12Options = {};
     D3D12_FEATURE_DATA_D3D12_OPTIONS1 m_D3D12Options1 = {};
     D3D12_FEATURE_DATA_D3D12_OPTIONS4 m_D3D12Options4 = {};
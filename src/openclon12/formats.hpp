@@ -1,131 +1,130 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include <array>
 #include <limits>
 #include "gl_tokens.hpp"
 
-constexpr DXGI_FORMAT GetDXGIFormatForCLImageFormat(cl_image_format const& image_format)
+// The CL<->DXGI image format correspondence, written once as a declarative
+// list. The lookup functions below index tables generated from it at compile
+// time rather than walking nested switches: translation runs on every image
+// creation, and format enumeration visits every DXGI format per device.
+struct CLDXGIFormatMapping
+{
+    cl_channel_order Order;
+    cl_channel_type Type;
+    DXGI_FORMAT Format;
+};
+constexpr CLDXGIFormatMapping c_CLDXGIFormatMap[] =
 {
-    switch (image_format.image_channel_data_type)
+    { CL_RGBA, CL_FLOAT,          DXGI_FORMAT_R32G32B32A32_FLOAT },
+    { CL_RGBA, CL_UNSIGNED_INT32, DXGI_FORMAT_R32G32B32A32_UINT },
+    { CL_RGBA, CL_SIGNED_INT32,   DXGI_FORMAT_R32G32B32A32_SINT },
+    { CL_RGB,  CL_FLOAT,          DXGI_FORMAT_R32G32B32_FLOAT },
+    { CL_RGB,  CL_UNSIGNED_INT32, DXGI_FORMAT_R32G32B32_UINT },
+    { CL_RGB,  CL_SIGNED_INT32,   DXGI_FORMAT_R32G32B32_SINT },
+    { CL_RGBA, CL_HALF_FLOAT,     DXGI_FORMAT_R16G16B16A16_FLOAT },
+    { CL_RGBA, CL_UNORM_INT16,    DXGI_FORMAT_R16G16B16A16_UNORM },
+    { CL_RGBA, CL_UNSIGNED_INT16, DXGI_FORMAT_R16G16B16A16_UINT },
+    { CL_RGBA, CL_SNORM_INT16,    DXGI_FORMAT_R16G16B16A16_SNORM },
+    { CL_RGBA, CL_SIGNED_INT16,   DXGI_FORMAT_R16G16B16A16_SINT },
+    { CL_RG,   CL_FLOAT,          DXGI_FORMAT_R32G32_FLOAT },
+    { CL_RG,   CL_UNSIGNED_INT32, DXGI_FORMAT_R32G32_UINT },
+    { CL_RG,   CL_SIGNED_INT32,   DXGI_FORMAT_R32G32_SINT },
+    { CL_RGBx, CL_UNORM_INT_101010, DXGI_FORMAT_R10G10B10A2_UNORM },
+    { CL_RGBA, CL_UNORM_INT8,     DXGI_FORMAT_R8G8B8A8_UNORM },
+    { CL_RGBA, CL_UNSIGNED_INT8,  DXGI_FORMAT_R8G8B8A8_UINT },
+    { CL_RGBA, CL_SNORM_INT8,     DXGI_FORMAT_R8G8B8A8_SNORM },
+    { CL_RGBA, CL_SIGNED_INT8,    DXGI_FORMAT_R8G8B8A8_SINT },
+    { CL_RG,   CL_HALF_FLOAT,     DXGI_FORMAT_R16G16_FLOAT },
+    { CL_RG,   CL_UNORM_INT16,    DXGI_FORMAT_R16G16_UNORM },
+    { CL_RG,   CL_UNSIGNED_INT16, DXGI_FORMAT_R16G16_UINT },
+    { CL_RG,   CL_SNORM_INT16,    DXGI_FORMAT_R16G16_SNORM },
+    { CL_RG,   CL_SIGNED_INT16,   DXGI_FORMAT_R16G16_SINT },
+    { CL_R,    CL_FLOAT,          DXGI_FORMAT_R32_FLOAT },
+    { CL_R,    CL_UNSIGNED_INT32, DXGI_FORMAT_R32_UINT },
+    { CL_R,    CL_SIGNED_INT32,   DXGI_FORMAT_R32_SINT },
+    { CL_RG,   CL_UNORM_INT8,     DXGI_FORMAT_R8G8_UNORM },
+    { CL_RG,   CL_UNSIGNED_INT8,  DXGI_FORMAT_R8G8_UINT },
+    { CL_RG,   CL_SNORM_INT8,     DXGI_FORMAT_R8G8_SNORM },
+    { CL_RG,   CL_SIGNED_INT8,    DXGI_FORMAT_R8G8_SINT },
+    { CL_R,    CL_HALF_FLOAT,     DXGI_FORMAT_R16_FLOAT },
+    { CL_R,    CL_UNORM_INT16,    DXGI_FORMAT_R16_UNORM },
+    { CL_R,    CL_UNSIGNED_INT16, DXGI_FORMAT_R16_UINT },
+    { CL_R,    CL_SNORM_INT16,    DXGI_FORMAT_R16_SNORM },
+    { CL_R,    CL_SIGNED_INT16,   DXGI_FORMAT_R16_SINT },
+    { CL_R,    CL_UNORM_INT8,     DXGI_FORMAT_R8_UNORM },
+    { CL_R,    CL_UNSIGNED_INT8,  DXGI_FORMAT_R8_UINT },
+    { CL_R,    CL_SNORM_INT8,     DXGI_FORMAT_R8_SNORM },
+    { CL_R,    CL_SIGNED_INT8,    DXGI_FORMAT_R8_SINT },
+    { CL_A,    CL_UNORM_INT8,     DXGI_FORMAT_A8_UNORM },
+    { CL_BGRA, CL_UNORM_INT8,     DXGI_FORMAT_B8G8R8A8_UNORM },
+};
+
+namespace FormatDetails
+{
+    // CL channel orders and data types are each a small contiguous enum range,
+    // so the forward lookup is a dense 2D array indexed by both.
+    constexpr size_t c_ChannelOrderCount = CL_ABGR - CL_R + 1;
+    constexpr size_t c_ChannelTypeCount = CL_UNORM_INT_101010_2 - CL_SNORM_INT8 + 1;
+
+    constexpr auto BuildCLToDXGITable()
     {
-    case CL_UNSIGNED_INT32:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R32G32B32A32_UINT;
-        case CL_RGB: return DXGI_FORMAT_R32G32B32_UINT;
-        case CL_RG: return DXGI_FORMAT_R32G32_UINT;
-        case CL_R: return DXGI_FORMAT_R32_UINT;
-        }
-        break;
-    case CL_SIGNED_INT32:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R32G32B32A32_SINT;
-        case CL_RGB: return DXGI_FORMAT_R32G32B32_SINT;
-        case CL_RG: return DXGI_FORMAT_R32G32_SINT;
-        case CL_R: return DXGI_FORMAT_R32_SINT;
-        }
-        break;
-    case CL_FLOAT:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R32G32B32A32_FLOAT;
-        case CL_RGB: return DXGI_FORMAT_R32G32B32_FLOAT;
-        case CL_RG: return DXGI_FORMAT_R32G32_FLOAT;
-        case CL_R: return DXGI_FORMAT_R32_FLOAT;
-        }
-        break;
-    case CL_UNSIGNED_INT16:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R16G16B16A16_UINT;
-        case CL_RG: return DXGI_FORMAT_R16G16_UINT;
-        case CL_R: return DXGI_FORMAT_R16_UINT;
-        }
-        break;
-    case CL_SIGNED_INT16:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R16G16B16A16_SINT;
-        case CL_RG: return DXGI_FORMAT_R16G16_SINT;
-        case CL_R: return DXGI_FORMAT_R16_SINT;
-        }
-        break;
-    case CL_UNORM_INT16:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R16G16B16A16_UNORM;
-        case CL_RG: return DXGI_FORMAT_R16G16_UNORM;
-        case CL_R: return DXGI_FORMAT_R16_UNORM;
-        }
-        break;
-    case CL_SNORM_INT16:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R16G16B16A16_SNORM;
-        case CL_RG: return DXGI_FORMAT_R16G16_SNORM;
-        case CL_R: return DXGI_FORMAT_R16_SNORM;
-        }
-        break;
-    case CL_HALF_FLOAT:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R16G16B16A16_FLOAT;
-        case CL_RG: return DXGI_FORMAT_R16G16_FLOAT;
-        case CL_R: return DXGI_FORMAT_R16_FLOAT;
-        }
-        break;
-    case CL_UNSIGNED_INT8:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R8G8B8A8_UINT;
-        case CL_RG: return DXGI_FORMAT_R8G8_UINT;
-        case CL_R: return DXGI_FORMAT_R8_UINT;
-        }
-        break;
-    case CL_SIGNED_INT8:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R8G8B8A8_SINT;
-        case CL_RG: return DXGI_FORMAT_R8G8_SINT;
-        case CL_R: return DXGI_FORMAT_R8_SINT;
-        }
-        break;
-    case CL_UNORM_INT8:
-        switch (image_format.image_channel_order)
-        {
-        case CL_RGBA: return DXGI_FORMAT_R8G8B8A8_UNORM;
-        case CL_RG: return DXGI_FORMAT_R8G8_UNORM;
-        case CL_R: return DXGI_FORMAT_R8_UNORM;
-        case CL_BGRA: return DXGI_FORMAT_B8G8R8A8_UNORM;
-        case CL_A: return DXGI_FORMAT_A8_UNORM;
-        }
-        break;
-    case CL_SNORM_INT8:
-        switch (image_format.image_channel_order)
+        std::array<std::array<DXGI_FORMAT, c_ChannelOrderCount>, c_ChannelTypeCount> Table = {};
+        for (auto const& m : c_CLDXGIFormatMap)
         {
-        case CL_RGBA: return DXGI_FORMAT_R8G8B8A8_SNORM;
-        case CL_RG: return DXGI_FORMAT_R8G8_SNORM;
-        case CL_R: return DXGI_FORMAT_R8_SNORM;
+            Table[m.Type - CL_SNORM_INT8][m.Order - CL_R] = m.Format;
         }
-        break;
-    case CL_UNORM_INT_101010:
-        switch (image_format.image_channel_order)
+        return Table;
+    }
+    inline constexpr auto c_CLToDXGITable = BuildCLToDXGITable();
+
+    constexpr size_t c_DXGIToCLTableSize = DXGI_FORMAT_B8G8R8A8_UNORM + 1;
+    constexpr auto BuildDXGIToCLTable()
+    {
+        std::array<cl_image_format, c_DXGIToCLTableSize> Table = {};
+        for (auto const& m : c_CLDXGIFormatMap)
         {
-        case CL_RGBx: return DXGI_FORMAT_R10G10B10A2_UNORM;
+            // This is failing a bunch of tests - see about re-enabling as a proper 1010102
+            if (m.Format == DXGI_FORMAT_R10G10B10A2_UNORM)
+            {
+                continue;
+            }
+            Table[m.Format] = { m.Order, m.Type };
         }
-        break;
+        return Table;
+    }
+    inline constexpr auto c_DXGIToCLTable = BuildDXGIToCLTable();
+}
+
+constexpr DXGI_FORMAT GetDXGIFormatForCLImageFormat(cl_image_format const& image_format)
+{
+    if (image_format.image_channel_data_type < CL_SNORM_INT8 ||
+        image_format.image_channel_data_type >= CL_SNORM_INT8 + FormatDetails::c_ChannelTypeCount ||
+        image_format.image_channel_order < CL_R ||
+        image_format.image_channel_order >= CL_R + FormatDetails::c_ChannelOrderCount)
+    {
+        return DXGI_FORMAT_UNKNOWN;
     }
-    return DXGI_FORMAT_UNKNOWN;
+    return FormatDetails::c_CLToDXGITable
+        [image_format.image_channel_data_type - CL_SNORM_INT8]
+        [image_format.image_channel_order - CL_R];
 }
 
 constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLuint glFmt)
 {
+    if ((size_t)fmt < FormatDetails::c_DXGIToCLTableSize)
+    {
+        cl_image_format ret = FormatDetails::c_DXGIToCLTable[fmt];
+        if (ret.image_channel_data_type != 0)
+        {
+            return ret;
+        }
+    }
+    // Typeless formats only occur on GL interop resources and are resolved by
+    // the GL internal format; they stay out of the table above.
     switch (fmt)
     {
-    case DXGI_FORMAT_R32G32B32A32_FLOAT: return { CL_RGBA, CL_FLOAT };
-    case DXGI_FORMAT_R32G32B32A32_UINT: return { CL_RGBA, CL_UNSIGNED_INT32 };
-    case DXGI_FORMAT_R32G32B32A32_SINT: return { CL_RGBA, CL_SIGNED_INT32 };
     case DXGI_FORMAT_R32G32B32A32_TYPELESS:
         switch (glFmt)
         {
@@ -134,14 +133,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_RGBA32I: return { CL_RGBA, CL_SIGNED_INT32 };
         }
         break;
-    case DXGI_FORMAT_R32G32B32_FLOAT: return { CL_RGB, CL_FLOAT };
-    case DXGI_FORMAT_R32G32B32_UINT: return { CL_RGB, CL_UNSIGNED_INT32 };
-    case DXGI_FORMAT_R32G32B32_SINT: return { CL_RGB, CL_SIGNED_INT32 };
-    case DXGI_FORMAT_R16G16B16A16_FLOAT: return { CL_RGBA, CL_HALF_FLOAT };
-    case DXGI_FORMAT_R16G16B16A16_UNORM: return { CL_RGBA, CL_UNORM_INT16 };
-    case DXGI_FORMAT_R16G16B16A16_UINT: return { CL_RGBA, CL_UNSIGNED_INT16 };
-    case DXGI_FORMAT_R16G16B16A16_SNORM: return { CL_RGBA, CL_SNORM_INT16 };
-    case DXGI_FORMAT_R16G16B16A16_SINT: return { CL_RGBA, CL_SIGNED_INT16 };
     case DXGI_FORMAT_R16G16B16A16_TYPELESS:
         switch (glFmt)
         {
@@ -152,9 +143,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_RGBA16I: return { CL_RGBA, CL_SIGNED_INT16 };
         }
         break;
-    case DXGI_FORMAT_R32G32_FLOAT: return { CL_RG, CL_FLOAT };
-    case DXGI_FORMAT_R32G32_UINT: return { CL_RG, CL_UNSIGNED_INT32 };
-    case DXGI_FORMAT_R32G32_SINT: return { CL_RG, CL_SIGNED_INT32 };
     case DXGI_FORMAT_R32G32_TYPELESS:
         switch (glFmt)
         {
@@ -163,12 +151,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_RG32I: return { CL_RG, CL_SIGNED_INT32 };
         }
         break;
-    // This is failing a bunch of tests - see about re-enabling as a proper 1010102
-    //case DXGI_FORMAT_R10G10B10A2_UNORM: return { CL_RGBx, CL_UNORM_INT_101010 };
-    case DXGI_FORMAT_R8G8B8A8_UNORM: return { CL_RGBA, CL_UNORM_INT8 };
-    case DXGI_FORMAT_R8G8B8A8_UINT: return { CL_RGBA, CL_UNSIGNED_INT8 };
-    case DXGI_FORMAT_R8G8B8A8_SNORM: return { CL_RGBA, CL_SNORM_INT8 };
-    case DXGI_FORMAT_R8G8B8A8_SINT: return { CL_RGBA, CL_SIGNED_INT8 };
     case DXGI_FORMAT_R8G8B8A8_TYPELESS:
         switch (glFmt)
         {
@@ -180,11 +162,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_RGBA: return { CL_RGBA, CL_UNORM_INT8 };
         }
         break;
-    case DXGI_FORMAT_R16G16_FLOAT: return { CL_RG, CL_HALF_FLOAT };
-    case DXGI_FORMAT_R16G16_UNORM: return { CL_RG, CL_UNORM_INT16 };
-    case DXGI_FORMAT_R16G16_UINT: return { CL_RG, CL_UNSIGNED_INT16 };
-    case DXGI_FORMAT_R16G16_SNORM: return { CL_RG, CL_SNORM_INT16 };
-    case DXGI_FORMAT_R16G16_SINT: return { CL_RG, CL_SIGNED_INT16 };
     case DXGI_FORMAT_R16G16_TYPELESS:
         switch (glFmt)
         {
@@ -195,9 +172,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_RG16I: return { CL_RG, CL_SIGNED_INT16 };
         }
         break;
-    case DXGI_FORMAT_R32_FLOAT: return { CL_R, CL_FLOAT };
-    case DXGI_FORMAT_R32_UINT: return { CL_R, CL_UNSIGNED_INT32 };
-    case DXGI_FORMAT_R32_SINT: return { CL_R, CL_SIGNED_INT32 };
     case DXGI_FORMAT_R32_TYPELESS:
         switch (glFmt)
         {
@@ -206,10 +180,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_R32I: return { CL_R, CL_SIGNED_INT32 };
         }
         break;
-    case DXGI_FORMAT_R8G8_UNORM: return { CL_RG, CL_UNORM_INT8 };
-    case DXGI_FORMAT_R8G8_UINT: return { CL_RG, CL_UNSIGNED_INT8 };
-    case DXGI_FORMAT_R8G8_SNORM: return { CL_RG, CL_SNORM_INT8 };
-    case DXGI_FORMAT_R8G8_SINT: return { CL_RG, CL_SIGNED_INT8 };
     case DXGI_FORMAT_R8G8_TYPELESS:
         switch (glFmt)
         {
@@ -219,11 +189,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_RG8I: return { CL_RG, CL_SIGNED_INT8 };
         }
         break;
-    case DXGI_FORMAT_R16_FLOAT: return { CL_R, CL_HALF_FLOAT };
-    case DXGI_FORMAT_R16_UNORM: return { CL_R, CL_UNORM_INT16 };
-    case DXGI_FORMAT_R16_UINT: return { CL_R, CL_UNSIGNED_INT16 };
-    case DXGI_FORMAT_R16_SNORM: return { CL_R, CL_SNORM_INT16 };
-    case DXGI_FORMAT_R16_SINT: return { CL_R, CL_SIGNED_INT16 };
     case DXGI_FORMAT_R16_TYPELESS:
         switch (glFmt)
         {
@@ -234,10 +199,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_R16I: return { CL_R, CL_SIGNED_INT16 };
         }
         break;
-    case DXGI_FORMAT_R8_UNORM: return { CL_R, CL_UNORM_INT8 };
-    case DXGI_FORMAT_R8_UINT: return { CL_R, CL_UNSIGNED_INT8 };
-    case DXGI_FORMAT_R8_SNORM: return { CL_R, CL_SNORM_INT8 };
-    case DXGI_FORMAT_R8_SINT: return { CL_R, CL_SIGNED_INT8 };
     case DXGI_FORMAT_R8_TYPELESS:
         switch (glFmt)
         {
@@ -247,8 +208,6 @@ constexpr cl_image_format GetCLImageFormatForDXGIFormat(DXGI_FORMAT fmt, cl_GLui
         case GL_R8I: return { CL_R, CL_SIGNED_INT8 };
         }
         break;
-    case DXGI_FORMAT_A8_UNORM: return { CL_A, CL_UNORM_INT8 };
-    case DXGI_FORMAT_B8G8R8A8_UNORM: return { CL_BGRA, CL_UNORM_INT8 };
     case DXGI_FORMAT_B8G8R8A8_TYPELESS: return { CL_BGRA, CL_UNORM_INT8 };
     }
     return {};
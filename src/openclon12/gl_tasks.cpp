@@ -21,12 +21,12 @@ public:
         if (!command_queue)
         {
             Submit();
-            std::thread([ref_this = AcquireFromGLTask::ref_ptr_int(this)]()
+            Parent.GetGLManager()->QueueSyncWait([ref_this = AcquireFromGLTask::ref_ptr_int(this)]()
                        {
                            ref_this->Record();
                            auto TaskPoolLock = g_Platform->GetTaskPoolLock();
                            static_cast<AcquireFromGLTask*>(ref_this.Get())->Complete(CL_SUCCESS, TaskPoolLock);
-                       }).detach();
+                       });
         }
     }
 
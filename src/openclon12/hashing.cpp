@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "platform.hpp"
+#include "hashing.hpp"
+#include "spookyv2.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace BlobHash
+{
+
+// Chunks are claimed from a shared counter, so however many helpers actually
+// get scheduled, every chunk is hashed exactly once and the calling thread
+// always makes progress on its own - if the compile/link pool is saturated
+// the caller simply hashes the whole blob itself, which is no worse than the
+// scalar path. Chunk geometry is baked into the resulting keys; see the
+// header about versioning.
+static constexpr size_t ChunkSize = 1024 * 1024;
+static constexpr size_t ParallelThreshold = 4 * ChunkSize;
+static constexpr uint32_t MaxHelpers = 7;
+
+namespace
+{
+struct HashJob
+{
+    const uint8_t* m_Data;
+    size_t m_Size;
+    uint32_t m_NumChunks;
+    std::atomic<uint32_t> m_NextChunk{ 0 };
+    std::atomic<uint32_t> m_ChunksRemaining;
+    // Checked out of the process-wide event pool only if the caller actually
+    // has to block; in the common case where the caller drains every chunk
+    // itself no OS handle is touched. Seq-cst ordering on the publish flag
+    // and the remaining-count re-check closes the store-buffer race between
+    // the caller publishing the event and the last finisher looking for it.
+    std::atomic<bool> m_DonePublished{ false };
+    XPlatHelpers::pooled_event m_Done;
+    // Two qwords per chunk, written by whichever thread claims the chunk and
+    // only read by the caller after m_Done signals.
+    std::unique_ptr<uint64_t[]> m_Digests;
+
+    void Drain() noexcept
+    {
+        for (uint32_t i; (i = m_NextChunk.fetch_add(1, std::memory_order_relaxed)) < m_NumChunks;)
+        {
+            size_t Offset = (size_t)i * ChunkSize;
+            // Seed with the chunk index so identical chunks at different
+            // positions produce distinct digests.
+            m_Digests[2 * i] = i;
+            m_Digests[2 * i + 1] = 0;
+            SpookyHash::Hash128(m_Data + Offset, std::min(ChunkSize, m_Size - Offset),
+                                &m_Digests[2 * i], &m_Digests[2 * i + 1]);
+            if (m_ChunksRemaining.fetch_sub(1) == 1)
+            {
+                if (m_DonePublished.load())
+                {
+                    m_Done.set();
+                }
+            }
+        }
+    }
+};
+}
+
+void Hash128(const void* data, size_t size, uint64_t* hash1, uint64_t* hash2)
+{
+    if (size < ParallelThreshold || !g_Platform)
+    {
+        SpookyHash::Hash128(data, size, hash1, hash2);
+        return;
+    }
+
+    std::shared_ptr<HashJob> job;
+    try
+    {
+        job = std::make_shared<HashJob>();
+        job->m_Data = static_cast<const uint8_t*>(data);
+        job->m_Size = size;
+        job->m_NumChunks = (uint32_t)((size + ChunkSize - 1) / ChunkSize);
+        job->m_ChunksRemaining = job->m_NumChunks;
+        job->m_Digests.reset(new uint64_t[2 * (size_t)job->m_NumChunks]);
+
+        uint32_t NumHelpers = std::min(
+            { MaxHelpers, job->m_NumChunks - 1,
+              std::max(1u, std::thread::hardware_concurrency()) - 1 });
+        for (uint32_t i = 0; i < NumHelpers; ++i)
+        {
+            // Each helper holds its own reference; a helper that runs (or is
+            // cancelled at shutdown) after the caller already drained every
+            // chunk just finds nothing to claim.
+            g_Platform->QueueProgramOp([job]() { job->Drain(); });
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        SpookyHash::Hash128(data, size, hash1, hash2);
+        return;
+    }
+
+    job->Drain();
+    if (job->m_ChunksRemaining.load(std::memory_order_acquire) != 0)
+    {
+        job->m_Done.checkout();
+        job->m_DonePublished.store(true);
+        // If the last chunk finished between the check above and the publish,
+        // the finisher may not have seen the event; re-check before parking.
+        // A signal set anyway is drained when the event returns to the pool.
+        if (job->m_ChunksRemaining.load() != 0)
+        {
+            job->m_Done.wait();
+        }
+    }
+
+    // Combine the chunk digests, folding the blob length in through the seed.
+    *hash1 = size;
+    *hash2 = job->m_NumChunks;
+    SpookyHash::Hash128(job->m_Digests.get(), 2 * sizeof(uint64_t) * job->m_NumChunks, hash1, hash2);
+}
+
+}
@@ -0,0 +1,18 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace BlobHash
+{
+    // 128-bit hash for shader and program cache keys. Small inputs hash
+    // exactly like SpookyHash::Hash128; blobs past an internal threshold are
+    // split into fixed-size chunks hashed concurrently (helpers on the
+    // compile/link pool plus the calling thread) and the per-chunk digests
+    // are combined with one more hash pass. The chunking scheme is part of
+    // the on-disk key format: changing the threshold, the chunk size, or the
+    // combining step requires bumping ShaderCache::c_LayerCacheVersion.
+    void Hash128(const void* data, size_t size, uint64_t* hash1, uint64_t* hash2);
+}
@@ -215,20 +215,46 @@ static cl_mem_object_type MemObjectTypeFromName(const char* name)
 static ComPtr<ID3DBlob> SerializeRootSignature(CompiledDxil::Metadata const& metadata)
 {
     CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC RSDesc;
-    CD3DX12_ROOT_PARAMETER1 Params[2];
-    CD3DX12_DESCRIPTOR_RANGE1 ViewRanges[3], SamplerRange;
+    CD3DX12_ROOT_PARAMETER1 Params[4];
+    CD3DX12_DESCRIPTOR_RANGE1 ViewRanges[2], SamplerRange;
+    // The kernel inputs and work properties constant buffers are bound as root
+    // descriptors rather than through the view table. The work properties CBV
+    // is the only binding that changes between the tiled sub-dispatches of a
+    // large NDRange, so keeping both CBVs out of the table means the UAV/SRV
+    // descriptors are staged once per enqueue instead of once per dispatch.
+    cl_uint NumParams = 0;
+    if (UseRootConstantsForKernelInputs(metadata))
+    {
+        // Small argument blocks skip the kernel-inputs CBV entirely: the
+        // values are recorded into the command list as root constants.
+        Params[NumParams++].InitAsConstants(
+            (metadata.kernel_inputs_buf_size + 3) / 4, metadata.kernel_inputs_cbv_id);
+    }
+    else
+    {
+        Params[NumParams++].InitAsConstantBufferView(metadata.kernel_inputs_cbv_id, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
+    }
+    Params[NumParams++].InitAsConstantBufferView(metadata.work_properties_cbv_id, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
     cl_uint NumRanges = 0;
-    ViewRanges[NumRanges++].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 2, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE, 0);
-    ViewRanges[NumRanges++].Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, (UINT)metadata.num_uavs, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE, 2);
+    if (metadata.num_uavs)
+    {
+        ViewRanges[NumRanges++].Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV, (UINT)metadata.num_uavs, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE, 0);
+    }
     if (metadata.num_srvs)
     {
         ViewRanges[NumRanges++].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, (UINT)metadata.num_srvs, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE);
     }
-    SamplerRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, (UINT)metadata.num_samplers, 0);
-    Params[0].InitAsDescriptorTable(NumRanges, ViewRanges);
-    // TODO: Static samplers
-    Params[1].InitAsDescriptorTable(1, &SamplerRange);
-    RSDesc.Init_1_1(metadata.num_samplers ? 2 : 1, Params);
+    if (NumRanges)
+    {
+        Params[NumParams++].InitAsDescriptorTable(NumRanges, ViewRanges);
+    }
+    if (metadata.num_samplers)
+    {
+        SamplerRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, (UINT)metadata.num_samplers, 0);
+        // TODO: Static samplers
+        Params[NumParams++].InitAsDescriptorTable(1, &SamplerRange);
+    }
+    RSDesc.Init_1_1(NumParams, Params);
 
     ComPtr<ID3DBlob> ret;
     D3D12TranslationLayer::ThrowFailure(D3D12SerializeVersionedRootSignature(&RSDesc, &ret, nullptr));
@@ -297,6 +323,28 @@ Kernel::Kernel(Program& Parent, std::string const& name, CompiledDxil const& Dxi
         m_UAVs[constMeta.uav_id] = resource;
     }
 
+    // Fill the precomputed work-group info block; see GetWorkGroupInfo.
+    // The preferred multiple comes from the context's device wave width
+    // rather than a hardcoded guess.
+    m_WorkGroupInfo.MaxGroupSize = D3D12_CS_THREAD_GROUP_MAX_THREADS_PER_GROUP;
+    if (auto ReqDims = GetRequiredLocalDims())
+    {
+        std::copy(ReqDims, ReqDims + 3, m_WorkGroupInfo.CompileSize);
+    }
+    m_WorkGroupInfo.PreferredMultiple = Parent.GetContext().GetDevice(0).GetWaveSizes().first;
+    m_WorkGroupInfo.PrivateMemSize = Dxil.GetMetadata().priv_mem_size;
+    cl_ulong StaticLocal = Dxil.GetMetadata().local_mem_size;
+    for (auto& meta : Dxil.GetMetadata().args)
+    {
+        // Each local pointer argument contributes a 4-byte placeholder to the
+        // compiler's figure; the real sizes arrive via SetArg.
+        if (std::holds_alternative<CompiledDxil::Metadata::Arg::Local>(meta.properties))
+        {
+            StaticLocal -= 4;
+        }
+    }
+    m_WorkGroupInfo.StaticLocalMemSize = StaticLocal;
+
     m_Parent->KernelCreated();
 }
 
@@ -314,6 +362,8 @@ Kernel::Kernel(Kernel const& other)
     , m_InlineConsts(other.m_InlineConsts)
     , m_Meta(other.m_Meta)
     , m_ArgsSet(other.m_ArgsSet)
+    , m_WorkGroupInfo(other.m_WorkGroupInfo)
+    , m_LocalArgMemSize(other.m_LocalArgMemSize.load(std::memory_order_relaxed))
 {
     m_Parent->KernelCreated();
 }
@@ -412,7 +462,11 @@ cl_int Kernel::SetArg(cl_uint arg_index, size_t arg_size, const void* arg_value)
             m_UAVs[memMeta.buffer_id] = resource;
             if (resource)
             {
-                *buffer_val = (uint64_t)memMeta.buffer_id << 32ull;
+                // Buffer views bind the root buffer's UAV and carry their
+                // offset in the pointer's low dword; see BindsThroughRootView.
+                uint64_t viewOffset = resource->BindsThroughRootView() ?
+                    resource->m_Offset - resource->GetRootBuffer()->m_Offset : 0;
+                *buffer_val = ((uint64_t)memMeta.buffer_id << 32ull) | viewOffset;
             }
             else
             {
@@ -459,11 +513,15 @@ cl_int Kernel::SetArg(cl_uint arg_index, size_t arg_size, const void* arg_value)
             return ReportError("Argument value must be null for local arguments", CL_INVALID_ARG_VALUE);
         }
         auto& localConfig = std::get<CompiledDxil::Configuration::Arg::Local>(m_ArgMetadataToCompiler[arg_index].config);
+        // Keep the precomputed local-mem sum current; unsigned wraparound
+        // makes the subtract-then-add safe in a single fetch_add.
+        m_LocalArgMemSize.fetch_add((cl_ulong)arg_size - localConfig.size, std::memory_order_relaxed);
         localConfig.size = (cl_uint)arg_size;
         break;
     }
 
     m_ArgsSet[arg_index] = true;
+    m_ArgGeneration.fetch_add(1, std::memory_order_relaxed);
     return CL_SUCCESS;
 }
 
@@ -486,11 +544,63 @@ uint16_t const* Kernel::GetLocalDimsHint() const
     return nullptr;
 }
 
-std::unique_ptr<D3D12TranslationLayer::RootSignature> Kernel::GetRootSignature(ImmCtx &ImmCtx) const
+std::shared_ptr<D3D12TranslationLayer::RootSignature> Kernel::GetRootSignature(D3DDevice &Device) const
+{
+    return Device.GetRootSignature(m_SerializedRootSignature.Get());
+}
+
+std::optional<Kernel::DispatchConfig> Kernel::FindDispatchConfig(DispatchConfigKey const& key)
+{
+    std::lock_guard Lock(m_DispatchConfigLock);
+    auto iter = m_DispatchConfigs.find(key);
+    if (iter == m_DispatchConfigs.end())
+    {
+        return std::nullopt;
+    }
+    return iter->second;
+}
+
+void Kernel::StoreDispatchConfig(DispatchConfigKey const& key, DispatchConfig const& config) noexcept
+{
+    try
+    {
+        std::lock_guard Lock(m_DispatchConfigLock);
+        m_DispatchConfigs.emplace(key, config);
+    }
+    catch (std::bad_alloc&)
+    {
+        // The result is simply recomputed on the next enqueue.
+    }
+}
+
+std::shared_ptr<Program::SpecializationValue> Kernel::FindLastSpecialization(
+    D3DDevice* device, CompiledDxil::Configuration const& config, uint64_t argGeneration)
+{
+    std::lock_guard Lock(m_DispatchConfigLock);
+    auto& last = m_LastSpecialization;
+    if (last.Value &&
+        last.ArgGeneration == argGeneration &&
+        last.Device == device &&
+        std::equal(std::begin(last.LocalSize), std::end(last.LocalSize), std::begin(config.local_size)) &&
+        last.SupportGlobalOffsets == config.support_global_work_id_offsets &&
+        last.SupportGroupOffsets == config.support_work_group_id_offsets)
+    {
+        return last.Value;
+    }
+    return nullptr;
+}
+
+void Kernel::StoreLastSpecialization(
+    D3DDevice* device, CompiledDxil::Configuration const& config, uint64_t argGeneration,
+    std::shared_ptr<Program::SpecializationValue> value) noexcept
 {
-    auto pRS = std::make_unique<D3D12TranslationLayer::RootSignature>(&ImmCtx);
-    pRS->Create(m_SerializedRootSignature->GetBufferPointer(), m_SerializedRootSignature->GetBufferSize());
-    return pRS;
+    std::lock_guard Lock(m_DispatchConfigLock);
+    m_LastSpecialization.ArgGeneration = argGeneration;
+    m_LastSpecialization.Device = device;
+    std::copy(std::begin(config.local_size), std::end(config.local_size), std::begin(m_LastSpecialization.LocalSize));
+    m_LastSpecialization.SupportGlobalOffsets = config.support_global_work_id_offsets;
+    m_LastSpecialization.SupportGroupOffsets = config.support_work_group_id_offsets;
+    m_LastSpecialization.Value = std::move(value);
 }
 
 extern CL_API_ENTRY cl_int CL_API_CALL
@@ -648,33 +758,17 @@ clGetKernelWorkGroupInfo(cl_kernel                  kernel_,
         return CopyOutParameter(param, param_value_size, param_value, param_value_size_ret);
     };
     auto& kernel = *static_cast<Kernel*>(kernel_);
+    auto& info = kernel.GetWorkGroupInfo();
 
+    // Everything here was precomputed at kernel creation (local mem as a
+    // static base plus a SetArg-maintained sum), so queries are plain reads.
     switch (param_name)
     {
-    case CL_KERNEL_WORK_GROUP_SIZE: return RetValue((size_t)D3D12_CS_THREAD_GROUP_MAX_THREADS_PER_GROUP);
-    case CL_KERNEL_COMPILE_WORK_GROUP_SIZE:
-    {
-        size_t size[3] = {};
-        auto ReqDims = kernel.GetRequiredLocalDims();
-        if (ReqDims)
-            std::copy(ReqDims, ReqDims + 3, size);
-        return RetValue(size);
-    }
-    case CL_KERNEL_LOCAL_MEM_SIZE:
-    {
-        size_t size = kernel.m_Dxil.GetMetadata().local_mem_size;
-        for (cl_uint i = 0; i < kernel.m_Dxil.GetMetadata().args.size(); ++i)
-        {
-            if (kernel.m_Dxil.GetMetadata().program_kernel_info.args[i].address_qualifier == ProgramBinary::Kernel::Arg::AddressSpace::Local)
-            {
-                size -= 4;
-                size += std::get<CompiledDxil::Configuration::Arg::Local>(kernel.m_ArgMetadataToCompiler[i].config).size;
-            }
-        }
-        return RetValue(size);
-    }
-    case CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE: return RetValue((size_t)64);
-    case CL_KERNEL_PRIVATE_MEM_SIZE: return RetValue(kernel.m_Dxil.GetMetadata().priv_mem_size);
+    case CL_KERNEL_WORK_GROUP_SIZE: return RetValue(info.MaxGroupSize);
+    case CL_KERNEL_COMPILE_WORK_GROUP_SIZE: return RetValue(info.CompileSize);
+    case CL_KERNEL_LOCAL_MEM_SIZE: return RetValue((size_t)kernel.GetLocalMemSize());
+    case CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE: return RetValue(info.PreferredMultiple);
+    case CL_KERNEL_PRIVATE_MEM_SIZE: return RetValue(info.PrivateMemSize);
     }
 
     return CL_INVALID_VALUE;
@@ -5,6 +5,20 @@
 #include "program.hpp"
 #include "resources.hpp"
 #include <cstddef>
+#include <array>
+#include <optional>
+
+// Kernel-inputs blocks at or under this many DWORDs are bound as root
+// constants instead of a root CBV. Scalar-heavy kernels usually fit: the
+// argument block rides in the command list itself and the shader sees the
+// same cbuffer binding either way. The budget leaves plenty of the
+// 64-DWORD root signature limit for the other parameters.
+constexpr UINT KernelInputsMaxRootConstantDwords = 32;
+inline bool UseRootConstantsForKernelInputs(CompiledDxil::Metadata const& metadata)
+{
+    return metadata.kernel_inputs_buf_size > 0 &&
+           metadata.kernel_inputs_buf_size <= KernelInputsMaxRootConstantDwords * sizeof(UINT);
+}
 
 class Sampler;
 class Kernel : public CLChildBase<Kernel, Program, cl_kernel>
@@ -45,8 +59,84 @@ public:
 
     uint16_t const* GetRequiredLocalDims() const;
     uint16_t const* GetLocalDimsHint() const;
+
+    // Precomputed clGetKernelWorkGroupInfo block. Autotuners query these in
+    // tight loops for every kernel x device pair, so everything derivable
+    // from the compiled metadata is computed once at kernel creation and
+    // queries become struct reads. The local-mem figure is the one value
+    // SetArg can change, so it's split into the compile-time part here and a
+    // running sum of the local pointer arguments' current sizes.
+    struct WorkGroupInfo
+    {
+        size_t MaxGroupSize;
+        size_t CompileSize[3];
+        size_t PreferredMultiple;
+        cl_ulong PrivateMemSize;
+        cl_ulong StaticLocalMemSize;
+    };
+    WorkGroupInfo const& GetWorkGroupInfo() const noexcept { return m_WorkGroupInfo; }
+    cl_ulong GetLocalMemSize() const noexcept
+    {
+        return m_WorkGroupInfo.StaticLocalMemSize + m_LocalArgMemSize.load(std::memory_order_relaxed);
+    }
     
-    std::unique_ptr<D3D12TranslationLayer::RootSignature> GetRootSignature(ImmCtx &ImmCtx) const;
+    std::shared_ptr<D3D12TranslationLayer::RootSignature> GetRootSignature(D3DDevice &Device) const;
+
+    // Memoized results of the NDRange local-size factorization in
+    // clEnqueueNDRangeKernel. Apps relaunch the same kernel with identical
+    // global sizes millions of times, and the factorization is pure in
+    // (group counts, work_dim, device wave sizes), so repeat enqueues become
+    // a lookup. The cache is not copied by clCloneKernel.
+    struct DispatchConfig
+    {
+        std::array<uint32_t, 3> DispatchDimensions;
+        std::array<uint16_t, 3> LocalSizes;
+    };
+    using DispatchConfigKey = std::array<uint32_t, 6>;
+    std::optional<DispatchConfig> FindDispatchConfig(DispatchConfigKey const& key);
+    void StoreDispatchConfig(DispatchConfigKey const& key, DispatchConfig const& config) noexcept;
+
+    // Memoized result of the previous launch's specialization-cache lookup.
+    // SetArg bumps the argument generation, so a launch that repeats the last
+    // one's device and configuration with unchanged args reuses the cached
+    // value pointer and skips allocating a specialization key and walking the
+    // program's cache. Iterative solvers relaunch like this almost every
+    // enqueue. Not copied by clCloneKernel.
+    uint64_t GetArgGeneration() const noexcept { return m_ArgGeneration.load(std::memory_order_relaxed); }
+    std::shared_ptr<Program::SpecializationValue> FindLastSpecialization(
+        D3DDevice* device, CompiledDxil::Configuration const& config, uint64_t argGeneration);
+    void StoreLastSpecialization(
+        D3DDevice* device, CompiledDxil::Configuration const& config, uint64_t argGeneration,
+        std::shared_ptr<Program::SpecializationValue> value) noexcept;
 
     const ProgramBinary::Kernel m_Meta;
+
+private:
+    WorkGroupInfo m_WorkGroupInfo = {};
+    std::atomic<cl_ulong> m_LocalArgMemSize{ 0 };
+
+    std::mutex m_DispatchConfigLock;
+    std::map<DispatchConfigKey, DispatchConfig> m_DispatchConfigs;
+
+    std::atomic<uint64_t> m_ArgGeneration{ 0 };
+    struct LastSpecialization
+    {
+        uint64_t ArgGeneration = 0;
+        D3DDevice* Device = nullptr;
+        uint16_t LocalSize[3] = {};
+        bool SupportGlobalOffsets = false;
+        bool SupportGroupOffsets = false;
+        std::shared_ptr<Program::SpecializationValue> Value;
+    };
+    // Guarded by m_DispatchConfigLock along with the dispatch config cache.
+    LastSpecialization m_LastSpecialization;
 };
+
+class Task;
+
+// Creates (without queueing) a task that records a dispatch of kernel with
+// the given thread-group counts. Used for internal dispatches, e.g. the
+// buffer-rect repack kernels recorded inline by copy tasks. The kernel's
+// arguments must all be set; the global offset is zero.
+std::unique_ptr<Task> CreateExecuteKernelTask(Kernel& kernel, cl_command_queue queue,
+    std::array<uint32_t, 3> const& groups, std::array<uint16_t, 3> const& localSize, cl_uint workDims);
@@ -18,7 +18,6 @@
 
 extern void SignBlob(void* pBlob, size_t size);
 constexpr uint32_t PrintfBufferSize = 1024 * 1024;
-constexpr uint32_t PrintfBufferInitialData[PrintfBufferSize / sizeof(uint32_t)] = { sizeof(uint32_t) * 2, PrintfBufferSize };
 
 size_t Program::SpecializationKey::AllocatedByteSize(uint32_t NumArgs)
 {
@@ -30,14 +29,20 @@ size_t Program::SpecializationKey::HashByteSize(uint32_t NumArgs)
     return offsetof(SpecializationKey, Args) + sizeof(PackedArgData) * NumArgs;
 }
 
-auto Program::SpecializationKey::Allocate(D3DDevice const* Device, CompiledDxil::Configuration const& conf) -> std::unique_ptr<const SpecializationKey>
+auto Program::SpecializationKey::Allocate(D3DDevice const* Device, CompiledDxil::Configuration const& conf,
+                                          std::vector<CompiledDxil::Configuration::Arg> const& args) -> std::unique_ptr<const SpecializationKey>
 {
-    std::unique_ptr<SpecializationKey> bits(reinterpret_cast<SpecializationKey*>(operator new(AllocatedByteSize((uint32_t)conf.args.size()))));
-    new (bits.get()) SpecializationKey(Device, conf);
+    std::unique_ptr<SpecializationKey> bits(reinterpret_cast<SpecializationKey*>(operator new(AllocatedByteSize((uint32_t)args.size()))));
+    new (bits.get()) SpecializationKey(Device, conf, args);
     return bits;
 }
 
-Program::SpecializationKey::SpecializationKey(D3DDevice const* Device, CompiledDxil::Configuration const& conf)
+// The args are taken separately from the rest of the configuration so that the
+// enqueue path can build a key straight from the kernel's argument metadata
+// without copying that vector into the config; the copy only happens when a
+// new specialization actually needs to be compiled.
+Program::SpecializationKey::SpecializationKey(D3DDevice const* Device, CompiledDxil::Configuration const& conf,
+                                              std::vector<CompiledDxil::Configuration::Arg> const& args)
 {
     this->Device = Device;
     ConfigData.Bits.LocalSize[0] = conf.local_size[0];
@@ -49,15 +54,15 @@ Program::SpecializationKey::SpecializationKey(D3DDevice const* Device, CompiledD
     ConfigData.Bits.LowerInt16 = conf.lower_int64;
     ConfigData.Bits.Padding = 0;
 
-    NumArgs = (uint32_t)conf.args.size();
+    NumArgs = (uint32_t)args.size();
     for (uint32_t i = 0; i < NumArgs; ++i)
     {
         memset(&Args[i], 0, sizeof(Args[i]));
-        if (auto localConfig = std::get_if<CompiledDxil::Configuration::Arg::Local>(&conf.args[i].config); localConfig)
+        if (auto localConfig = std::get_if<CompiledDxil::Configuration::Arg::Local>(&args[i].config); localConfig)
         {
             Args[i].LocalArgSize = localConfig->size;
         }
-        else if (auto samplerConfig = std::get_if<CompiledDxil::Configuration::Arg::Sampler>(&conf.args[i].config); samplerConfig)
+        else if (auto samplerConfig = std::get_if<CompiledDxil::Configuration::Arg::Sampler>(&args[i].config); samplerConfig)
         {
             Args[i].SamplerArgData.AddressingMode = samplerConfig->addressingMode;
             Args[i].SamplerArgData.LinearFiltering = samplerConfig->linearFiltering;
@@ -90,6 +95,19 @@ bool Program::SpecializationKeyEqual::operator()(std::unique_ptr<const Specializ
     return memcmp(a.get(), b.get(), size) == 0;
 }
 
+size_t Program::KernelData::MaxSpecializations()
+{
+    static const size_t Cap = []() -> size_t
+    {
+        if (const char* Override = getenv("CLON12_SPECIALIZATION_CACHE_SIZE"))
+        {
+            return strtoul(Override, nullptr, 10);
+        }
+        return 64;
+    }();
+    return Cap;
+}
+
 auto Program::GetSpecializationData(
     Device* device, std::string const& kernelName, std::unique_ptr<const SpecializationKey> key) ->
     SpecializationData
@@ -104,7 +122,29 @@ auto Program::GetSpecializationData(
 
     std::lock_guard specializationCacheLock(buildData->m_SpecializationCacheLock);
     auto [iter, success] = kernel.m_SpecializationCache.try_emplace(std::move(key));
-    return { iter->first.get(), &iter->second, success, { buildData->m_Hash[0], buildData->m_Hash[1] }};
+    if (success)
+    {
+        iter->second = std::make_shared<SpecializationValue>();
+        const size_t Cap = KernelData::MaxSpecializations();
+        if (Cap != 0 && kernel.m_SpecializationCache.size() > Cap)
+        {
+            // Evict the least-recently-used entry (never the one just
+            // inserted). Holders of the shared value are unaffected; a later
+            // launch with the evicted configuration simply recompiles.
+            auto evict = kernel.m_SpecializationCache.end();
+            for (auto i = kernel.m_SpecializationCache.begin(); i != kernel.m_SpecializationCache.end(); ++i)
+            {
+                if (i != iter &&
+                    (evict == kernel.m_SpecializationCache.end() || i->second->m_LastUse < evict->second->m_LastUse))
+                {
+                    evict = i;
+                }
+            }
+            kernel.m_SpecializationCache.erase(evict);
+        }
+    }
+    iter->second->m_LastUse = ++kernel.m_SpecializationUseCounter;
+    return { iter->first.get(), iter->second, success, { buildData->m_Hash[0], buildData->m_Hash[1] }};
 }
 
 class ExecuteKernel : public Task
@@ -115,14 +155,22 @@ public:
 
     Resource::UnderlyingResourcePtr m_KernelArgsCb;
     std::vector<std::byte> m_KernelArgsCbData;
+    // Non-empty when the argument block is small enough for root constants
+    // (see UseRootConstantsForKernelInputs): it is recorded straight into the
+    // command list and the upload buffer only carries the work properties.
+    std::vector<std::byte> m_RootConstantData;
     size_t m_WorkPropertiesOffset;
-    Resource::ref_ptr m_PrintfUAV;
+    // Nonzero when the tiled sub-dispatches are recorded as one
+    // ExecuteIndirect: offset of the argument array at the tail of the
+    // kernel args buffer.
+    size_t m_IndirectArgsOffset = 0;
+    D3DDevice::PrintfBuffer m_PrintfBuffer;
 
     std::vector<Resource::ref_ptr_int> m_KernelArgUAVs;
     std::vector<Resource::ref_ptr_int> m_KernelArgSRVs;
     std::vector<Sampler::ref_ptr_int> m_KernelArgSamplers;
     
-    Program::SpecializationValue *m_Specialized = nullptr;
+    std::shared_ptr<Program::SpecializationValue> m_Specialized;
 
     void MigrateResources() final
     {
@@ -139,6 +187,7 @@ public:
     }
     void RecordImpl() final;
     void OnComplete() final;
+    void ProcessPrintfBuffer();
 
     ExecuteKernel(Kernel& kernel, cl_command_queue queue, std::array<uint32_t, 3> const& dims, std::array<uint32_t, 3> const& offset, std::array<uint16_t, 3> const& localSize, cl_uint workDims)
         : Task(kernel.m_Parent->GetContext(), CL_COMMAND_NDRANGE_KERNEL, queue)
@@ -166,14 +215,33 @@ public:
         cl_uint numIterations = numXIterations * numYIterations * numZIterations;
 
         size_t KernelInputsCbSize = kernel.m_Dxil.GetMetadata().kernel_inputs_buf_size;
+        if (UseRootConstantsForKernelInputs(kernel.m_Dxil.GetMetadata()))
+        {
+            m_RootConstantData.resize(D3D12TranslationLayer::Align<size_t>(kernel.m_KernelArgsCbData.size(), sizeof(UINT)));
+            memcpy(m_RootConstantData.data(), kernel.m_KernelArgsCbData.data(), kernel.m_KernelArgsCbData.size());
+            KernelInputsCbSize = 0;
+        }
         m_WorkPropertiesOffset = D3D12TranslationLayer::Align<size_t>(KernelInputsCbSize, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
         auto pCompiler = g_Platform->GetCompiler();
         size_t WorkPropertiesSize = pCompiler->GetWorkPropertiesChunkSize() * numIterations;
         KernelInputsCbSize = m_WorkPropertiesOffset + WorkPropertiesSize;
 
+        // Huge NDRanges split into many sub-dispatches; past a handful it is
+        // cheaper to record one ExecuteIndirect over a prefilled argument
+        // array (riding at the tail of this same upload buffer) than to loop
+        // root-constant updates and Dispatch calls on the CPU.
+        constexpr cl_uint MaxDispatchChunksRecordedDirectly = 8;
+        if (numIterations > MaxDispatchChunksRecordedDirectly)
+        {
+            m_IndirectArgsOffset = KernelInputsCbSize;
+            KernelInputsCbSize += D3D12TranslationLayer::Align<size_t>(
+                numIterations * sizeof(D3D12TranslationLayer::DispatchIndirectCommand),
+                D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+        }
+
         m_KernelArgsCbData.resize(KernelInputsCbSize);
-        if (!kernel.m_KernelArgsCbData.empty())
+        if (m_RootConstantData.empty() && !kernel.m_KernelArgsCbData.empty())
         {
             memcpy(m_KernelArgsCbData.data(), kernel.m_KernelArgsCbData.data(), kernel.m_KernelArgsCbData.size());
         }
@@ -223,8 +291,7 @@ public:
 
         if (kernel.m_Dxil.GetMetadata().printf_uav_id >= 0)
         {
-            m_PrintfUAV.Attach(static_cast<Resource*>(clCreateBuffer(&m_Parent.get(), CL_MEM_ALLOC_HOST_PTR | CL_MEM_COPY_HOST_PTR, PrintfBufferSize, (void*)PrintfBufferInitialData, nullptr)));
-            m_PrintfUAV->EnqueueMigrateResource(&m_CommandQueue->GetD3DDevice(), this, 0);
+            m_PrintfBuffer = Device.AcquirePrintfBuffer(PrintfBufferSize);
         }
 
         CompiledDxil::Configuration config = {};
@@ -234,14 +301,31 @@ public:
         config.support_global_work_id_offsets = std::any_of(std::begin(offset), std::end(offset), [](cl_uint v) { return v != 0; });
         config.support_work_group_id_offsets = numIterations != 1;
         std::copy(std::begin(localSize), std::end(localSize), config.local_size);
-        config.args = kernel.m_ArgMetadataToCompiler;
-        auto SpecKey = Program::SpecializationKey::Allocate(m_D3DDevice, config);
-        
+
+        // Fast path: a relaunch with unchanged args and the same device and
+        // configuration resolves to the same specialization as last time, so
+        // reuse the memoized shared value (which stays valid even if the
+        // cache has since evicted the entry) instead of allocating a key and
+        // searching the cache. Any compile queued by the launch that
+        // populated the memo is waited on in RecordImpl as usual.
+        const uint64_t ArgGeneration = kernel.GetArgGeneration();
+        m_Specialized = kernel.FindLastSpecialization(m_D3DDevice, config, ArgGeneration);
+        if (m_Specialized)
+        {
+            return;
+        }
+
+        auto SpecKey = Program::SpecializationKey::Allocate(m_D3DDevice, config, kernel.m_ArgMetadataToCompiler);
+
         auto SpecializationData = kernel.m_Parent->GetSpecializationData(m_Device.Get(), kernel.m_Name, std::move(SpecKey));
         m_Specialized = SpecializationData.Value;
+        kernel.StoreLastSpecialization(m_D3DDevice, config, ArgGeneration, SpecializationData.Value);
 
         if (SpecializationData.NeedToCreate)
         {
+            // Only the compile below needs the full argument metadata; steady-state
+            // enqueues that hit the specialization cache skip this copy.
+            config.args = kernel.m_ArgMetadataToCompiler;
             g_Platform->QueueProgramOp([this, &Device,
                                               config = std::move(config),
                                               kernel = this->m_Kernel,
@@ -308,7 +392,7 @@ public:
                         Cache.Store(finalHash, sizeof(finalHash), specialized->GetBinary(), specialized->GetBinarySize());
                     }
 
-                    auto RS = kernel->GetRootSignature(Device.ImmCtx());
+                    auto RS = kernel->GetRootSignature(Device);
 
                     auto &DriverCache = m_D3DDevice->GetDriverShaderCache();
                     auto CachedBlob = DriverCache.Find(finalHash, sizeof(finalHash));
@@ -321,8 +405,11 @@ public:
                     auto PSO = std::make_unique<D3D12TranslationLayer::PipelineState>(
                         &Device.ImmCtx(), D3D12_SHADER_BYTECODE{ specialized->GetBinary(), specialized->GetBinarySize() }, RS.get(), CachedDesc);
 
-                    if (!CachedBlob.first)
+                    if (!CachedBlob.first || !PSO->UsedCachedBlob())
                     {
+                        // Either there was no cached blob, or the one we had was stale
+                        // (e.g. driver update) and the PSO was recompiled - store the
+                        // fresh blob so the next launch gets a warm start again.
                         D3D12TranslationLayer::unique_comptr<ID3DBlob> blob;
                         if (SUCCEEDED(PSO->GetForImmediateUse()->GetCachedBlob(&blob)))
                         {
@@ -331,8 +418,12 @@ public:
                     }
 
                     {
+                        // Field-wise rather than whole-struct assignment: the
+                        // LRU stamp is guarded by the cache lock, not this one.
                         auto lock = kernel->m_Parent->GetSpecializationUpdateLock();
-                        *m_Specialized = Program::SpecializationValue(std::move(specialized), std::move(RS), std::move(PSO));
+                        m_Specialized->m_Dxil = std::move(specialized);
+                        m_Specialized->m_RS = std::move(RS);
+                        m_Specialized->m_PSO = std::move(PSO);
                     }
                     kernel->m_Parent->SpecializationComplete();
                 }
@@ -349,40 +440,28 @@ public:
     }
 };
 
-extern CL_API_ENTRY cl_int CL_API_CALL
-clEnqueueNDRangeKernel(cl_command_queue command_queue,
-    cl_kernel        kernel_,
-    cl_uint          work_dim,
+std::unique_ptr<Task> CreateExecuteKernelTask(Kernel& kernel, cl_command_queue queue,
+    std::array<uint32_t, 3> const& groups, std::array<uint16_t, 3> const& localSize, cl_uint workDims)
+{
+    return std::unique_ptr<Task>(new ExecuteKernel(kernel, queue, groups, { 0, 0, 0 }, localSize, workDims));
+}
+
+// Shared validation and dispatch-shape computation for the NDRange enqueue
+// entry points: checks the work dimensions against the kernel and device
+// limits, and picks (or looks up) thread group sizes when the app leaves
+// local_work_size null. On success the out-params describe the dispatch;
+// on failure returns the CL error through ReportError.
+template <typename TReportError>
+static cl_int PrepareNDRangeDispatch(CommandQueue& queue, Kernel& kernel,
+    cl_uint work_dim,
     const size_t* global_work_offset,
     const size_t* global_work_size,
     const size_t* local_work_size,
-    cl_uint          num_events_in_wait_list,
-    const cl_event* event_wait_list,
-    cl_event* event) CL_API_SUFFIX__VERSION_1_0
+    TReportError&& ReportError,
+    std::array<uint32_t, 3>& DispatchDimensions,
+    std::array<uint16_t, 3>& LocalSizes,
+    std::array<uint32_t, 3>& GlobalWorkItemOffsets)
 {
-    if (!command_queue)
-    {
-        return CL_INVALID_COMMAND_QUEUE;
-    }
-    if (!kernel_)
-    {
-        return CL_INVALID_KERNEL;
-    }
-    CommandQueue& queue = *static_cast<CommandQueue*>(command_queue);
-    Context& context = queue.GetContext();
-    auto ReportError = context.GetErrorReporter();
-    Kernel& kernel = *static_cast<Kernel*>(kernel_);
-
-    if (&kernel.m_Parent->GetContext() != &context)
-    {
-        return ReportError("Kernel was not created on the same context as the command queue.", CL_INVALID_CONTEXT);
-    }
-
-    if ((event_wait_list == nullptr) != (num_events_in_wait_list == 0))
-    {
-        return ReportError("If event_wait_list is null, then num_events_in_wait_list mut be zero, and vice versa.", CL_INVALID_EVENT_WAIT_LIST);
-    }
-
     if (work_dim == 0 || work_dim > 3)
     {
         return ReportError("work_dim must be between 1 and 3.", CL_INVALID_WORK_DIMENSION);
@@ -393,7 +472,7 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
         return ReportError("global_work_size must be specified.", CL_INVALID_GLOBAL_WORK_SIZE);
     }
 
-    std::array<uint32_t, 3> GlobalWorkItemOffsets = {};
+    GlobalWorkItemOffsets = {};
     if (global_work_offset != nullptr)
     {
         for (cl_uint i = 0; i < work_dim; ++i)
@@ -411,8 +490,8 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
         return ReportError("Cannot enqueue a kernel before all args are set.", CL_INVALID_KERNEL_ARGS);
     }
 
-    std::array<uint32_t, 3> DispatchDimensions = { 1, 1, 1 };
-    std::array<uint16_t, 3> LocalSizes = { 1, 1, 1 };
+    DispatchDimensions = { 1, 1, 1 };
+    LocalSizes = { 1, 1, 1 };
     auto RequiredDims = kernel.GetRequiredLocalDims();
     const std::array<uint16_t, 3> MaxDims =
     {
@@ -456,12 +535,22 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
             return ReportError("local_work_size exceeds max work items per group.", CL_INVALID_WORK_GROUP_SIZE);
         }
     }
+    else if (std::pair<cl_uint, cl_uint> WaveSizes = queue.GetDevice().GetWaveSizes();
+             auto CachedConfig = kernel.FindDispatchConfig(
+                 { DispatchDimensions[0], DispatchDimensions[1], DispatchDimensions[2],
+                   work_dim, WaveSizes.first, WaveSizes.second }))
+    {
+        DispatchDimensions = CachedConfig->DispatchDimensions;
+        LocalSizes = CachedConfig->LocalSizes;
+    }
     else
     {
+        const Kernel::DispatchConfigKey ConfigKey =
+            { DispatchDimensions[0], DispatchDimensions[1], DispatchDimensions[2],
+              work_dim, WaveSizes.first, WaveSizes.second };
         // Try to partition this thread count into groups that fall between the min and max wave size.
         // Don't overshoot the max wave size, since threads in a group need to be scheduled together,
         // which can limit how many groups can run in parallel.
-        std::pair<cl_uint, cl_uint> WaveSizes = queue.GetDevice().GetWaveSizes();
         cl_uint ThreadsInGroup = 1;
         // No device has a wave size > 128
         static constexpr uint16_t Primes[] =
@@ -481,7 +570,7 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
                 {
                     uint16_t Factor = *FactorizationProgress[dimension];
                     if (DispatchDimensions[dimension] < Factor ||
-                        // Allow thread group size to increase past the max only if we're already at the minimum 
+                        // Allow thread group size to increase past the max only if we're already at the minimum
                         // and it will help to decrease how many dispatches we need to loop
                         (ThreadsInGroup * Factor > WaveSizes.second &&
                          ThreadsInGroup < WaveSizes.first &&
@@ -514,8 +603,15 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
                 DispatchDimensions[dimension] /= Factor;
                 Progress = true;
 
-                // Stop if we hit the minimum wave size exactly, or once we exceed the min/max size
-                if ((ThreadsInGroup == WaveSizes.first || ThreadsInGroup > WaveSizes.second) &&
+                // Stop once the group fills a maximum-width wave, or once we exceed the min/max size.
+                // On devices with a wave size range (wave32/wave64 parts), a group sized to only the
+                // minimum runs half-empty whenever the driver picks the wider mode, so keep growing
+                // until a full maximum-width wave when the factorization allows it. Fixed-width
+                // devices stop in the same place as before since min == max. Each resulting local
+                // size is its own DXIL specialization, keyed per device, so the wave-size-matched
+                // variant is compiled once and every later launch hits the dispatch-config and
+                // specialization caches.
+                if (ThreadsInGroup >= WaveSizes.second &&
                     DispatchDimensions[dimension] <= D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION)
                 {
                     Progress = false;
@@ -538,6 +634,55 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
                 DispatchDimensions[dimension] = 1;
             }
         }
+
+        kernel.StoreDispatchConfig(ConfigKey, { DispatchDimensions, LocalSizes });
+    }
+
+    return CL_SUCCESS;
+}
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clEnqueueNDRangeKernel(cl_command_queue command_queue,
+    cl_kernel        kernel_,
+    cl_uint          work_dim,
+    const size_t* global_work_offset,
+    const size_t* global_work_size,
+    const size_t* local_work_size,
+    cl_uint          num_events_in_wait_list,
+    const cl_event* event_wait_list,
+    cl_event* event) CL_API_SUFFIX__VERSION_1_0
+{
+    if (!command_queue)
+    {
+        return CL_INVALID_COMMAND_QUEUE;
+    }
+    if (!kernel_)
+    {
+        return CL_INVALID_KERNEL;
+    }
+    CommandQueue& queue = *static_cast<CommandQueue*>(command_queue);
+    Context& context = queue.GetContext();
+    auto ReportError = context.GetErrorReporter();
+    Kernel& kernel = *static_cast<Kernel*>(kernel_);
+
+    if (&kernel.m_Parent->GetContext() != &context)
+    {
+        return ReportError("Kernel was not created on the same context as the command queue.", CL_INVALID_CONTEXT);
+    }
+
+    if ((event_wait_list == nullptr) != (num_events_in_wait_list == 0))
+    {
+        return ReportError("If event_wait_list is null, then num_events_in_wait_list mut be zero, and vice versa.", CL_INVALID_EVENT_WAIT_LIST);
+    }
+
+    std::array<uint32_t, 3> DispatchDimensions, GlobalWorkItemOffsets;
+    std::array<uint16_t, 3> LocalSizes;
+    cl_int PrepareResult = PrepareNDRangeDispatch(queue, kernel, work_dim,
+        global_work_offset, global_work_size, local_work_size, ReportError,
+        DispatchDimensions, LocalSizes, GlobalWorkItemOffsets);
+    if (PrepareResult != CL_SUCCESS)
+    {
+        return PrepareResult;
     }
 
     bool IsEmptyDispatch = DispatchDimensions[0] == 0 || DispatchDimensions[1] == 0 || DispatchDimensions[2] == 0;
@@ -586,6 +731,269 @@ clEnqueueTask(cl_command_queue  command_queue,
         event);
 }
 
+// cl_msft_split_ndrange: data-parallel dispatch of one NDRange across several
+// queues, typically one per device in the context. Dimension 0 of the global
+// range is split into one contiguous shard per queue (in units of the local
+// size when one is given), and each shard is enqueued with the matching
+// global offset so get_global_id keeps its single-dispatch meaning. Resource
+// migration happens per shard through the regular task machinery; apps that
+// shard their buffers with per-device sub-buffers move only each device's
+// slice. The returned event is a marker on the first queue gated on every
+// shard.
+extern CL_API_ENTRY cl_int CL_API_CALL
+clEnqueueNDRangeKernelSplitMSFT(cl_uint num_command_queues,
+    const cl_command_queue* command_queues,
+    cl_kernel        kernel_,
+    cl_uint          work_dim,
+    const size_t* global_work_offset,
+    const size_t* global_work_size,
+    const size_t* local_work_size,
+    cl_uint          num_events_in_wait_list,
+    const cl_event* event_wait_list,
+    cl_event* event)
+{
+    if (num_command_queues == 0 || !command_queues || !command_queues[0])
+    {
+        return CL_INVALID_COMMAND_QUEUE;
+    }
+    if (num_command_queues == 1)
+    {
+        return clEnqueueNDRangeKernel(command_queues[0], kernel_, work_dim,
+            global_work_offset, global_work_size, local_work_size,
+            num_events_in_wait_list, event_wait_list, event);
+    }
+
+    Context& context = static_cast<CommandQueue*>(command_queues[0])->GetContext();
+    auto ReportError = context.GetErrorReporter();
+    for (cl_uint i = 1; i < num_command_queues; ++i)
+    {
+        if (!command_queues[i])
+        {
+            return CL_INVALID_COMMAND_QUEUE;
+        }
+        if (&static_cast<CommandQueue*>(command_queues[i])->GetContext() != &context)
+        {
+            return ReportError("All command queues must share one context.", CL_INVALID_CONTEXT);
+        }
+    }
+    if (work_dim == 0 || work_dim > 3)
+    {
+        return ReportError("work_dim must be between 1 and 3.", CL_INVALID_WORK_DIMENSION);
+    }
+    if (!global_work_size)
+    {
+        return ReportError("global_work_size must be specified.", CL_INVALID_GLOBAL_WORK_SIZE);
+    }
+
+    // Shards stay multiples of the local size so each sub-enqueue passes the
+    // divisibility requirement; mismatches surface from the sub-enqueue.
+    const size_t Granularity = (local_work_size && local_work_size[0]) ? local_work_size[0] : 1;
+    if (global_work_size[0] % Granularity != 0)
+    {
+        return ReportError("local_work_size must evenly divide the global_work_size.", CL_INVALID_WORK_GROUP_SIZE);
+    }
+    const size_t NumUnits = global_work_size[0] / Granularity;
+    const size_t UnitsPerShard = NumUnits / num_command_queues;
+    const size_t RemainderUnits = NumUnits % num_command_queues;
+
+    cl_int ret = CL_SUCCESS;
+    std::vector<cl_event> ShardEvents;
+    try
+    {
+        ShardEvents.reserve(num_command_queues);
+        size_t Start = 0;
+        for (cl_uint i = 0; i < num_command_queues && ret == CL_SUCCESS; ++i)
+        {
+            const size_t Units = UnitsPerShard + (i < RemainderUnits ? 1 : 0);
+            if (Units == 0)
+            {
+                continue;
+            }
+            size_t ShardOffset[3] = {}, ShardGlobal[3] = {};
+            for (cl_uint dim = 0; dim < work_dim; ++dim)
+            {
+                ShardOffset[dim] = global_work_offset ? global_work_offset[dim] : 0;
+                ShardGlobal[dim] = global_work_size[dim];
+            }
+            ShardOffset[0] += Start * Granularity;
+            ShardGlobal[0] = Units * Granularity;
+
+            cl_event ShardEvent = nullptr;
+            ret = clEnqueueNDRangeKernel(command_queues[i], kernel_, work_dim,
+                ShardOffset, ShardGlobal, local_work_size,
+                num_events_in_wait_list, event_wait_list, &ShardEvent);
+            if (ret == CL_SUCCESS)
+            {
+                ShardEvents.push_back(ShardEvent);
+                Start += Units;
+            }
+        }
+
+        if (ret == CL_SUCCESS && event)
+        {
+            ret = clEnqueueMarkerWithWaitList(command_queues[0],
+                (cl_uint)ShardEvents.size(), ShardEvents.data(), event);
+        }
+    }
+    catch (std::bad_alloc&) { ret = CL_OUT_OF_HOST_MEMORY; }
+
+    for (cl_event e : ShardEvents)
+    {
+        clReleaseEvent(e);
+    }
+    return ret;
+}
+
+// cl_msft_batch_ndrange: enqueues an array of NDRange launches with one call.
+// Each clEnqueueNDRangeKernel pays the task pool lock, in-order dependency
+// wiring, and queue bookkeeping individually, which dominates for apps that
+// issue thousands of tiny kernels per iteration. Here every launch is
+// validated and its task constructed up front, then all of them are wired and
+// queued under a single lock acquisition. A descriptor can carry arg updates
+// (clSetKernelArg semantics) applied before its launch, so one kernel can be
+// batched with different args per launch. The optional event is a marker
+// gated on every launch in the batch. On error nothing is enqueued.
+typedef struct cl_ndrange_kernel_arg_msft
+{
+    cl_uint arg_index;
+    size_t arg_size;
+    const void* arg_value;
+} cl_ndrange_kernel_arg_msft;
+
+typedef struct cl_ndrange_kernel_desc_msft
+{
+    cl_kernel kernel;
+    cl_uint work_dim;
+    const size_t* global_work_offset;
+    const size_t* global_work_size;
+    const size_t* local_work_size;
+    cl_uint num_args;
+    const cl_ndrange_kernel_arg_msft* args;
+} cl_ndrange_kernel_desc_msft;
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clEnqueueNDRangeKernelBatchMSFT(cl_command_queue command_queue,
+    cl_uint num_kernels,
+    const cl_ndrange_kernel_desc_msft* kernel_descs,
+    cl_uint num_events_in_wait_list,
+    const cl_event* event_wait_list,
+    cl_event* event)
+{
+    if (!command_queue)
+    {
+        return CL_INVALID_COMMAND_QUEUE;
+    }
+    CommandQueue& queue = *static_cast<CommandQueue*>(command_queue);
+    Context& context = queue.GetContext();
+    auto ReportError = context.GetErrorReporter();
+
+    if (num_kernels == 0 || !kernel_descs)
+    {
+        return ReportError("num_kernels must be nonzero and kernel_descs non-null.", CL_INVALID_VALUE);
+    }
+    if ((event_wait_list == nullptr) != (num_events_in_wait_list == 0))
+    {
+        return ReportError("If event_wait_list is null, then num_events_in_wait_list mut be zero, and vice versa.", CL_INVALID_EVENT_WAIT_LIST);
+    }
+
+    try
+    {
+        // Validate every descriptor and construct every task before taking the
+        // task pool lock, so per-launch work (arg snapshots, CB allocation,
+        // specialization lookups) happens outside it and a bad descriptor
+        // fails the whole batch before anything is enqueued.
+        std::vector<std::unique_ptr<Task>> tasks;
+        tasks.reserve(num_kernels);
+        for (cl_uint i = 0; i < num_kernels; ++i)
+        {
+            auto& desc = kernel_descs[i];
+            if (!desc.kernel)
+            {
+                return ReportError("Each descriptor must name a kernel.", CL_INVALID_KERNEL);
+            }
+            Kernel& kernel = *static_cast<Kernel*>(desc.kernel);
+            if (&kernel.m_Parent->GetContext() != &context)
+            {
+                return ReportError("Kernel was not created on the same context as the command queue.", CL_INVALID_CONTEXT);
+            }
+            if (desc.num_args && !desc.args)
+            {
+                return ReportError("num_args must be zero when args is null.", CL_INVALID_VALUE);
+            }
+            for (cl_uint arg = 0; arg < desc.num_args; ++arg)
+            {
+                cl_int SetArgResult = kernel.SetArg(desc.args[arg].arg_index,
+                    desc.args[arg].arg_size, desc.args[arg].arg_value);
+                if (SetArgResult != CL_SUCCESS)
+                {
+                    return SetArgResult;
+                }
+            }
+
+            std::array<uint32_t, 3> DispatchDimensions, GlobalWorkItemOffsets;
+            std::array<uint16_t, 3> LocalSizes;
+            cl_int PrepareResult = PrepareNDRangeDispatch(queue, kernel, desc.work_dim,
+                desc.global_work_offset, desc.global_work_size, desc.local_work_size, ReportError,
+                DispatchDimensions, LocalSizes, GlobalWorkItemOffsets);
+            if (PrepareResult != CL_SUCCESS)
+            {
+                return PrepareResult;
+            }
+
+            bool IsEmptyDispatch = DispatchDimensions[0] == 0 || DispatchDimensions[1] == 0 || DispatchDimensions[2] == 0;
+            tasks.emplace_back(IsEmptyDispatch ?
+                (Task*)(new DummyTask(context, CL_COMMAND_NDRANGE_KERNEL, command_queue)) :
+                (Task*)(new ExecuteKernel(kernel, command_queue, DispatchDimensions, GlobalWorkItemOffsets, LocalSizes, desc.work_dim)));
+        }
+
+        std::unique_ptr<Task> marker;
+        if (event)
+        {
+            marker.reset(new DummyTask(context, CL_COMMAND_MARKER, command_queue));
+        }
+
+        auto Lock = g_Platform->GetTaskPoolLock();
+        for (auto& task : tasks)
+        {
+            task->AddDependencies(event_wait_list, num_events_in_wait_list, Lock);
+        }
+        if (marker)
+        {
+            std::vector<cl_event> BatchEvents;
+            BatchEvents.reserve(tasks.size());
+            for (auto& task : tasks)
+            {
+                BatchEvents.push_back(task.get());
+            }
+            marker->AddDependencies(BatchEvents.data(), (cl_uint)BatchEvents.size(), Lock);
+        }
+        for (auto& task : tasks)
+        {
+            queue.QueueTask(task.get(), Lock);
+            // The queue tracks the task from here on; drop the construction
+            // ref now so a throw later in the batch can't delete a task the
+            // queue already holds.
+            task.release()->Release();
+        }
+        if (marker)
+        {
+            queue.QueueTask(marker.get(), Lock);
+        }
+
+        // No more exceptions
+        if (event)
+        {
+            *event = marker.release();
+        }
+    }
+    catch (std::bad_alloc&) { return ReportError(nullptr, CL_OUT_OF_HOST_MEMORY); }
+    catch (std::exception & e) { return ReportError(e.what(), CL_OUT_OF_RESOURCES); }
+    catch (_com_error&) { return ReportError(nullptr, CL_OUT_OF_RESOURCES); }
+    catch (Task::DependencyException&) { return ReportError("Context mismatch between command_queue and event_wait_list", CL_INVALID_CONTEXT); }
+
+    return CL_SUCCESS;
+}
+
 constexpr UINT c_aUAVAppendOffsets[D3D11_1_UAV_SLOT_COUNT] =
 {
     (UINT)-1,(UINT)-1,(UINT)-1,(UINT)-1,(UINT)-1,(UINT)-1,(UINT)-1,(UINT)-1,
@@ -625,18 +1033,55 @@ void ExecuteKernel::RecordImpl()
 
     // Fill out offsets that'll be read by the kernel for local arg pointers, based on the offsets
     // returned by the compiler for this specialization
+    std::byte* pKernelInputs = !m_RootConstantData.empty() ? m_RootConstantData.data() : m_KernelArgsCbData.data();
     for (UINT i = 0; i < m_Specialized->m_Dxil->GetMetadata().args.size(); ++i)
     {
         if (m_Specialized->m_Dxil->GetMetadata().program_kernel_info.args[i].address_qualifier != ProgramBinary::Kernel::Arg::AddressSpace::Local)
             continue;
 
-        UINT *offsetLocation = reinterpret_cast<UINT*>(&m_KernelArgsCbData[m_Specialized->m_Dxil->GetMetadata().args[i].offset]);
+        UINT *offsetLocation = reinterpret_cast<UINT*>(pKernelInputs + m_Specialized->m_Dxil->GetMetadata().args[i].offset);
         *offsetLocation = std::get<CompiledDxil::Metadata::Arg::Local>(m_Specialized->m_Dxil->GetMetadata().args[i].properties).sharedmem_offset;
     }
 
     auto &Device = m_CommandQueue->GetD3DDevice();
     auto &ImmCtx = Device.ImmCtx();
 
+    auto pCompiler = g_Platform->GetCompiler();
+    cl_uint WorkPropertiesChunkSize = (cl_uint)pCompiler->GetWorkPropertiesChunkSize();
+
+    D3D12_CONSTANT_BUFFER_VIEW_DESC CBVDesc;
+    D3D12TranslationLayer::GetBufferViewDesc(m_KernelArgsCb.get(), CBVDesc, 0);
+    const D3D12_GPU_VIRTUAL_ADDRESS KernelArgsVA = CBVDesc.BufferLocation;
+
+    cl_uint numXIterations = ((m_DispatchDims[0] - 1) / D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION) + 1;
+    cl_uint numYIterations = ((m_DispatchDims[1] - 1) / D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION) + 1;
+    cl_uint numZIterations = ((m_DispatchDims[2] - 1) / D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION) + 1;
+
+    if (m_IndirectArgsOffset != 0)
+    {
+        // Prefill one {work properties CBV, dispatch} entry per tile; they
+        // ride to the GPU in the same upload as the rest of the buffer and
+        // are consumed by the single ExecuteIndirect below.
+        auto* pArgs = reinterpret_cast<D3D12TranslationLayer::DispatchIndirectCommand*>(
+            m_KernelArgsCbData.data() + m_IndirectArgsOffset);
+        size_t WorkPropertiesOffset = m_WorkPropertiesOffset;
+        for (cl_uint x = 0; x < numXIterations; ++x)
+        {
+            for (cl_uint y = 0; y < numYIterations; ++y)
+            {
+                for (cl_uint z = 0; z < numZIterations; ++z)
+                {
+                    pArgs->WorkPropertiesCbv = KernelArgsVA + WorkPropertiesOffset;
+                    pArgs->Dispatch.ThreadGroupCountX = (x == numXIterations - 1) ? (m_DispatchDims[0] - D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION * (numXIterations - 1)) : D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION;
+                    pArgs->Dispatch.ThreadGroupCountY = (y == numYIterations - 1) ? (m_DispatchDims[1] - D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION * (numYIterations - 1)) : D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION;
+                    pArgs->Dispatch.ThreadGroupCountZ = (z == numZIterations - 1) ? (m_DispatchDims[2] - D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION * (numZIterations - 1)) : D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION;
+                    ++pArgs;
+                    WorkPropertiesOffset += WorkPropertiesChunkSize;
+                }
+            }
+        }
+    }
+
     D3D11_SUBRESOURCE_DATA Data = { m_KernelArgsCbData.data() };
     ImmCtx.UpdateSubresources(
         m_KernelArgsCb.get(),
@@ -645,36 +1090,45 @@ void ExecuteKernel::RecordImpl()
         nullptr,
         D3D12TranslationLayer::ImmediateContext::UpdateSubresourcesFlags::ScenarioInitialData);
 
-    ImmCtx.GetResourceStateManager().TransitionResource(m_KernelArgsCb.get(), D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    ImmCtx.GetResourceStateManager().TransitionResource(m_KernelArgsCb.get(),
+        m_IndirectArgsOffset != 0 ?
+            D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER | D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT :
+            D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
 
     std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> SrcDescriptors;
-    UINT NumViewDescriptors = 2 + (UINT)m_KernelArgUAVs.size() + (UINT)m_KernelArgSRVs.size();
+    UINT NumViewDescriptors = (UINT)m_KernelArgUAVs.size() + (UINT)m_KernelArgSRVs.size();
     UINT NumSamplerDescriptors = (UINT)m_KernelArgSamplers.size();
-    SrcDescriptors.reserve(std::max(NumViewDescriptors - 2, NumSamplerDescriptors));
+    SrcDescriptors.reserve(std::max(NumViewDescriptors, NumSamplerDescriptors));
+
+    // Root parameter layout, matching SerializeRootSignature: the kernel
+    // inputs (root constants or a root CBV), the work properties root CBV,
+    // then the UAV/SRV table and sampler table when present.
+    constexpr UINT KernelArgsCbParam = 0, WorkPropertiesCbParam = 1;
+    const UINT ViewTableParam = 2;
+    const UINT SamplerTableParam = NumViewDescriptors ? 3 : 2;
 
     ID3D12GraphicsCommandList *pCmdList = ImmCtx.GetGraphicsCommandList();
-    pCmdList->SetComputeRootSignature(m_Specialized->m_RS->GetForUse());
-    pCmdList->SetPipelineState(m_Specialized->m_PSO->GetForUse());
+    Device.SetComputeState(m_Specialized->m_RS->GetForUse(), m_Specialized->m_PSO->GetForUse());
 
     if (NumSamplerDescriptors)
     {
-        UINT SamplerSlot = ImmCtx.ReserveSlots(ImmCtx.m_SamplerHeap, NumSamplerDescriptors);
         for (auto &samp : m_KernelArgSamplers)
         {
             SrcDescriptors.push_back(samp->GetUnderlying(&Device).m_Descriptor);
         }
-        ImmCtx.m_pDevice12->CopyDescriptors(1, &ImmCtx.m_SamplerHeap.CPUHandle(SamplerSlot), &NumSamplerDescriptors,
-                                            NumSamplerDescriptors, SrcDescriptors.data(), nullptr, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+        Device.SetComputeDescriptorTable(SamplerTableParam, true, SrcDescriptors);
         SrcDescriptors.clear();
-        pCmdList->SetComputeRootDescriptorTable(1, ImmCtx.m_SamplerHeap.GPUHandle(SamplerSlot));
     }
 
     for (auto &UavRes : m_KernelArgUAVs)
     {
         if (UavRes.Get())
         {
-            auto &UAV = UavRes->GetUAV(&Device);
-            Device.ImmCtx().GetResourceStateManager().TransitionSubresources(UavRes->GetUnderlyingResource(&Device),
+            // The view already resolved the underlying resource for this
+            // device when it was created; going through its cached pointer
+            // skips a multi-device map lookup per argument per launch.
+            auto &UAV = UavRes->GetUAVForKernel(&Device);
+            Device.ImmCtx().GetResourceStateManager().TransitionSubresources(UAV.m_pResource,
                                                                              UAV.m_subresources,
                                                                              D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
             SrcDescriptors.push_back(UAV.GetRefreshedDescriptorHandle());
@@ -689,7 +1143,7 @@ void ExecuteKernel::RecordImpl()
         if (SrvRes.Get())
         {
             auto &SRV = SrvRes->GetSRV(&Device);
-            Device.ImmCtx().GetResourceStateManager().TransitionSubresources(SrvRes->GetUnderlyingResource(&Device),
+            Device.ImmCtx().GetResourceStateManager().TransitionSubresources(SRV.m_pResource,
                                                                              SRV.m_subresources,
                                                                              D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
             SrcDescriptors.push_back(SRV.GetRefreshedDescriptorHandle());
@@ -700,47 +1154,53 @@ void ExecuteKernel::RecordImpl()
             SrcDescriptors.push_back(ImmCtx.m_NullUAV);
         }
     }
-    if (m_PrintfUAV.Get())
+    if (m_PrintfBuffer.spResource)
     {
-        auto &UAV = m_PrintfUAV->GetUAV(&Device);
-        Device.ImmCtx().GetResourceStateManager().TransitionSubresources(m_PrintfUAV->GetUnderlyingResource(&Device),
-                                                                         UAV.m_subresources,
+        Device.ImmCtx().GetResourceStateManager().TransitionSubresources(m_PrintfBuffer.spResource.get(),
+                                                                         m_PrintfBuffer.spUAV->m_subresources,
                                                                          D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-        SrcDescriptors[m_Specialized->m_Dxil->GetMetadata().printf_uav_id] = UAV.GetRefreshedDescriptorHandle();
+        SrcDescriptors[m_Specialized->m_Dxil->GetMetadata().printf_uav_id] = m_PrintfBuffer.spUAV->GetRefreshedDescriptorHandle();
     }
 
-    auto pCompiler = g_Platform->GetCompiler();
-    cl_uint WorkPropertiesChunkSize = (cl_uint)pCompiler->GetWorkPropertiesChunkSize();
+    // The UAV/SRV table is invariant across the tiled sub-dispatches below, so
+    // it is staged once here; only the work properties root CBV advances per
+    // dispatch. Work properties chunks are placement-aligned, which satisfies
+    // the root descriptor alignment requirement.
+    if (!m_RootConstantData.empty())
+    {
+        pCmdList->SetComputeRoot32BitConstants(KernelArgsCbParam,
+            (UINT)(m_RootConstantData.size() / sizeof(UINT)), m_RootConstantData.data(), 0);
+    }
+    else
+    {
+        pCmdList->SetComputeRootConstantBufferView(KernelArgsCbParam, KernelArgsVA);
+    }
 
-    auto CopyAndSetViewDescriptors = [&](size_t WorkPropertiesOffset)
+    if (NumViewDescriptors)
     {
-        // The root signature indicates CBVs, then UAVs, then SRVs
-        UINT ViewSlot = ImmCtx.ReserveSlots(ImmCtx.m_ViewHeap, NumViewDescriptors);
-        UINT KernelArgsSlot = ViewSlot + m_Specialized->m_Dxil->GetMetadata().kernel_inputs_cbv_id;
-        UINT WorkPropertiesSlot = ViewSlot + m_Specialized->m_Dxil->GetMetadata().work_properties_cbv_id;
-
-        D3D12_CONSTANT_BUFFER_VIEW_DESC CBVDesc;
-        D3D12TranslationLayer::GetBufferViewDesc(m_KernelArgsCb.get(), CBVDesc, 0, m_WorkPropertiesOffset);
-        ImmCtx.m_pDevice12->CreateConstantBufferView(&CBVDesc, ImmCtx.m_ViewHeap.CPUHandle(KernelArgsSlot));
-        CBVDesc.BufferLocation += WorkPropertiesOffset;
-        CBVDesc.SizeInBytes = WorkPropertiesChunkSize;
-        ImmCtx.m_pDevice12->CreateConstantBufferView(&CBVDesc, ImmCtx.m_ViewHeap.CPUHandle(WorkPropertiesSlot));
-
-        UINT CopyStartSlot = ViewSlot + 2;
-        UINT CopySize = NumViewDescriptors - 2;
-        ImmCtx.m_pDevice12->CopyDescriptors(1, &ImmCtx.m_ViewHeap.CPUHandle(CopyStartSlot), &CopySize,
-                                            CopySize, SrcDescriptors.data(), nullptr, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-        pCmdList->SetComputeRootDescriptorTable(0, ImmCtx.m_ViewHeap.GPUHandle(ViewSlot));
-    };
+        // Identical back-to-back launches reuse the table staged for the
+        // previous one; see SetComputeDescriptorTable.
+        Device.SetComputeDescriptorTable(ViewTableParam, false, SrcDescriptors);
+    }
 
+    // The state manager folds a UAV barrier into the batch when a bound UAV was
+    // already written earlier in this command list, so no unconditional barrier
+    // is needed here.
     ImmCtx.GetResourceStateManager().ApplyAllResourceTransitions();
 
-    // TODO: Optimize this out
-    ImmCtx.UAVBarrier();
+    if (m_IndirectArgsOffset != 0)
+    {
+        // One ExecuteIndirect replaces the whole CPU loop; the prefilled
+        // argument entries advance the work properties root CBV and dispatch
+        // each tile.
+        ImmCtx.DispatchIndirect(
+            m_Specialized->m_RS->GetDispatchCommandSignature(WorkPropertiesCbParam),
+            numXIterations * numYIterations * numZIterations,
+            m_KernelArgsCb->GetUnderlyingResource(),
+            m_KernelArgsCb->GetSubresourcePlacement(0).Offset + m_IndirectArgsOffset);
+        return;
+    }
 
-    cl_uint numXIterations = ((m_DispatchDims[0] - 1) / D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION) + 1;
-    cl_uint numYIterations = ((m_DispatchDims[1] - 1) / D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION) + 1;
-    cl_uint numZIterations = ((m_DispatchDims[2] - 1) / D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION) + 1;
     size_t WorkPropertiesOffset = m_WorkPropertiesOffset;
     for (cl_uint x = 0; x < numXIterations; ++x)
     {
@@ -752,7 +1212,7 @@ void ExecuteKernel::RecordImpl()
                 UINT DimsY = (y == numYIterations - 1) ? (m_DispatchDims[1] - D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION * (numYIterations - 1)) : D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION;
                 UINT DimsZ = (z == numZIterations - 1) ? (m_DispatchDims[2] - D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION * (numZIterations - 1)) : D3D12_CS_DISPATCH_MAX_THREAD_GROUPS_PER_DIMENSION;
 
-                CopyAndSetViewDescriptors(WorkPropertiesOffset);
+                pCmdList->SetComputeRootConstantBufferView(WorkPropertiesCbParam, KernelArgsVA + WorkPropertiesOffset);
                 ImmCtx.Dispatch(DimsX, DimsY, DimsZ);
 
                 WorkPropertiesOffset += WorkPropertiesChunkSize;
@@ -762,33 +1222,51 @@ void ExecuteKernel::RecordImpl()
 }
 
 void ExecuteKernel::OnComplete()
+{
+    if (m_PrintfBuffer.spResource)
+    {
+        // Parsing and formatting printf output can take a while, and OnComplete
+        // runs under the task pool lock - push the work to the callback
+        // scheduler so printf-enabled kernels don't serialize completion of
+        // everything else. It's queued before event notifications fire, so
+        // callback-ordered waiters still observe the output first.
+        try
+        {
+            g_Platform->QueueCallback([this, refThis = Task::ref_int(*this)]()
+            {
+                ProcessPrintfBuffer();
+            });
+            return;
+        }
+        catch (std::bad_alloc&)
+        {
+            ProcessPrintfBuffer();
+            return;
+        }
+    }
+
+    m_Kernel.Release();
+}
+
+void ExecuteKernel::ProcessPrintfBuffer()
 {
     auto Cleanup = wil::scope_exit([this]()
     {
+        m_CommandQueue->GetD3DDevice().ReleasePrintfBuffer(std::move(m_PrintfBuffer));
         m_Kernel.Release();
     });
 
-    if (m_PrintfUAV.Get())
     {
-        auto& Device = m_CommandQueue->GetD3DDevice();
-        auto& ImmCtx = Device.ImmCtx();
-        auto TranslationResource = m_PrintfUAV->GetUnderlyingResource(&Device);
-        D3D12TranslationLayer::MappedSubresource MapRet = {};
-        ImmCtx.Map(TranslationResource, 0, D3D12TranslationLayer::MAP_TYPE_READ, false, nullptr, &MapRet);
-
-        auto Unmap = wil::scope_exit([&]()
-        {
-            ImmCtx.Unmap(TranslationResource, 0, D3D12TranslationLayer::MAP_TYPE_READ, nullptr);
-        });
-
+        // The buffer is persistently mapped and the GPU is done with this
+        // task's fence, so the data can be read directly.
         // The buffer has a two-uint header.
         constexpr uint32_t InitialBufferOffset = sizeof(uint32_t) * 2;
         // The first uint is the offset where the next chunk of data would be written. Alternatively,
         // it's the size of the buffer that's *been* written, including the size of the header.
-        uint32_t NumBytesWritten = *reinterpret_cast<uint32_t*>(MapRet.pData);
+        uint32_t NumBytesWritten = *reinterpret_cast<uint32_t*>(m_PrintfBuffer.pMappedData);
         uint32_t CurOffset = InitialBufferOffset;
 
-        std::byte* ByteStream = reinterpret_cast<std::byte*>(MapRet.pData);
+        std::byte* ByteStream = reinterpret_cast<std::byte*>(m_PrintfBuffer.pMappedData);
         while (CurOffset < NumBytesWritten && CurOffset < PrintfBufferSize)
         {
             uint32_t FormatStringId = *reinterpret_cast<uint32_t*>(ByteStream + CurOffset);
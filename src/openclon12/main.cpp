@@ -20,6 +20,29 @@ struct TraceLoggingRegistration
     ~TraceLoggingRegistration() { TraceLoggingUnregister(g_hOpenCLOn12Provider); }
 } g_TraceLoggingRegistration;
 
+// cl_msft_split_ndrange (kernel_tasks.cpp)
+extern CL_API_ENTRY cl_int CL_API_CALL
+clEnqueueNDRangeKernelSplitMSFT(cl_uint num_command_queues,
+    const cl_command_queue* command_queues,
+    cl_kernel        kernel,
+    cl_uint          work_dim,
+    const size_t* global_work_offset,
+    const size_t* global_work_size,
+    const size_t* local_work_size,
+    cl_uint          num_events_in_wait_list,
+    const cl_event* event_wait_list,
+    cl_event* event);
+
+// cl_msft_batch_ndrange (kernel_tasks.cpp)
+struct cl_ndrange_kernel_desc_msft;
+extern CL_API_ENTRY cl_int CL_API_CALL
+clEnqueueNDRangeKernelBatchMSFT(cl_command_queue command_queue,
+    cl_uint num_kernels,
+    const cl_ndrange_kernel_desc_msft* kernel_descs,
+    cl_uint num_events_in_wait_list,
+    const cl_event* event_wait_list,
+    cl_event* event);
+
 struct ExtensionTableEntry
 {
     const char *name;
@@ -50,6 +73,12 @@ static struct ExtensionTableEntry clExtensions[] =
 
     // cl_khr_il_program
     EXT_FUNC(clCreateProgramWithILKHR),
+
+    // cl_msft_split_ndrange
+    EXT_FUNC(clEnqueueNDRangeKernelSplitMSFT),
+
+    // cl_msft_batch_ndrange
+    EXT_FUNC(clEnqueueNDRangeKernelBatchMSFT),
 };
 
 static const int clExtensionCount = sizeof(clExtensions) / sizeof(clExtensions[0]);
@@ -280,7 +309,6 @@ clIcdGetPlatformIDsKHR(cl_uint           num_entries,
         try
         {
             g_Platform = new Platform(&g_DispatchTable);
-            g_Platform->RemoveInvalidDevices();
         }
         catch (std::bad_alloc&) { return CL_OUT_OF_HOST_MEMORY; }
         catch (std::exception&) { return CL_OUT_OF_RESOURCES; }
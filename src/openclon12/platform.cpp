@@ -63,6 +63,10 @@ clGetPlatformInfo(cl_platform_id   platform,
             { CL_MAKE_VERSION(1, 0, 0), "cl_khr_il_program" },
             { CL_MAKE_VERSION(1, 0, 0), "cl_khr_gl_sharing" },
             { CL_MAKE_VERSION(1, 0, 0), "cl_khr_gl_event" },
+            { CL_MAKE_VERSION(1, 0, 0), "cl_msft_split_ndrange" },
+            { CL_MAKE_VERSION(1, 0, 0), "cl_msft_batch_ndrange" },
+            { CL_MAKE_VERSION(1, 0, 0), "cl_msft_dedicated_queue" },
+            { CL_MAKE_VERSION(1, 0, 0), "cl_msft_queue_priority" },
             // TODO: Maybe loop over devices to see if they're all GPUs?
             // { CL_MAKE_VERSION(1, 0, 0), "cl_khr_3d_image_writes" },
         };
@@ -131,7 +135,32 @@ Platform::Platform(cl_icd_dispatch* dispatch)
     : m_bWarpIsHardware(CheckWarpIsHardware())
 {
     this->dispatch = dispatch;
+}
+
+Platform::~Platform()
+{
+    // Drop speculative prewarm references while the schedulers a release may
+    // still touch are alive; members are destroyed after this body runs, and
+    // the scheduler destructors cancel any prewarm task not yet started.
+    for (auto& device : m_Devices)
+    {
+        device->ReleasePrewarmedD3D();
+    }
+}
 
+void Platform::EnsureDevices()
+{
+    // call_once re-arms on exception, so a transient enumeration failure
+    // surfaces to this caller and the next clGetDeviceIDs retries.
+    std::call_once(m_DeviceEnumerationOnce, [this]()
+    {
+        EnumerateDevices();
+        RemoveInvalidDevices();
+    });
+}
+
+void Platform::EnumerateDevices()
+{
     ComPtr<IDXCoreAdapterFactory> spFactory;
     THROW_IF_FAILED(DXCoreCreateAdapterFactory(IID_PPV_ARGS(&spFactory)));
 
@@ -173,8 +202,6 @@ Platform::Platform(cl_icd_dispatch* dispatch)
     m_Devices[0]->SetDefaultDevice();
 }
 
-Platform::~Platform() = default;
-
 void Platform::RemoveInvalidDevices() noexcept
 {
     for (cl_uint i = 0; i < m_Devices.size(); ++i)
@@ -194,13 +221,15 @@ void Platform::RemoveInvalidDevices() noexcept
     }
 }
 
-cl_uint Platform::GetNumDevices() const noexcept
+cl_uint Platform::GetNumDevices()
 {
+    EnsureDevices();
     return (cl_uint)m_Devices.size();
 }
 
-Device *Platform::GetDevice(cl_uint i) const noexcept
+Device *Platform::GetDevice(cl_uint i)
 {
+    EnsureDevices();
     return m_Devices[i].get();
 }
 
@@ -230,8 +259,14 @@ void Platform::DeviceInit()
     BackgroundTaskScheduler::SchedulingMode mode{ 1u, BackgroundTaskScheduler::Priority::Normal };
     m_CallbackScheduler.SetSchedulingMode(mode);
 
-    mode.NumThreads = std::thread::hardware_concurrency();
-    m_CompileAndLinkScheduler.SetSchedulingMode(mode);
+    // Compile work is bursty: clBuildProgram fan-out wants every core, but a
+    // steady stream of enqueues only needs a thread or two. Let the pool size
+    // itself on demand instead of pinning hardware_concurrency threads.
+    m_CompileAndLinkScheduler.SetAutoscalePolicy(
+        { 1u, std::thread::hardware_concurrency(), BackgroundTaskScheduler::Priority::Normal });
+
+    mode = { 1u, BackgroundTaskScheduler::Priority::Idle };
+    m_CacheWriteScheduler.SetSchedulingMode(mode);
 }
 
 void Platform::DeviceUninit()
@@ -245,6 +280,7 @@ void Platform::DeviceUninit()
     BackgroundTaskScheduler::SchedulingMode mode{ 0u, BackgroundTaskScheduler::Priority::Normal };
     m_CallbackScheduler.SetSchedulingMode(mode);
     m_CompileAndLinkScheduler.SetSchedulingMode(mode);
+    m_CacheWriteScheduler.SetSchedulingMode(mode);
 }
 
 #ifdef _WIN32
@@ -301,6 +337,27 @@ XPlatHelpers::unique_module const& Platform::GetDXIL()
     return m_DXIL;
 }
 
+std::shared_ptr<ProgramBinary> Platform::FindCompiledProgram(const uint64_t hash[2])
+{
+    std::lock_guard lock(m_CompileCacheLock);
+    auto iter = m_CompileCache.find({ hash[0], hash[1] });
+    return iter != m_CompileCache.end() ? iter->second : nullptr;
+}
+
+void Platform::StoreCompiledProgram(const uint64_t hash[2], std::shared_ptr<ProgramBinary> const& program) noexcept
+{
+    if (!program)
+    {
+        return;
+    }
+    try
+    {
+        std::lock_guard lock(m_CompileCacheLock);
+        m_CompileCache.emplace(std::make_pair(hash[0], hash[1]), program);
+    }
+    catch (std::bad_alloc&) {}
+}
+
 void Platform::UnloadCompiler()
 {
     // If we want to actually support unloading the compiler,
@@ -317,6 +374,10 @@ bool Platform::AnyD3DDevicesExist() const noexcept
 
 void Platform::CloseCaches()
 {
+    {
+        std::lock_guard lock(m_CompileCacheLock);
+        m_CompileCache.clear();
+    }
     for (auto& device : m_Devices)
     {
         device->CloseCaches();
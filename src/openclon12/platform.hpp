@@ -26,6 +26,7 @@
 
 #include <type_traits>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <atomic>
 #include <map>
@@ -86,6 +87,7 @@ public:
 
 struct adopt_ref {};
 class Compiler;
+class ProgramBinary;
 
 struct TaskPoolLock
 {
@@ -115,20 +117,34 @@ public:
                                               // Not guaranteed to be supported by all devices
                                               // "cl_khr_3d_image_writes "
                                               "cl_khr_gl_sharing "
-                                              "cl_khr_gl_event ";
+                                              "cl_khr_gl_event "
+                                              "cl_msft_split_ndrange "
+                                              "cl_msft_batch_ndrange "
+                                              "cl_msft_dedicated_queue "
+                                              "cl_msft_queue_priority ";
     static constexpr const char* ICDSuffix = "oclon12";
 
     Platform(cl_icd_dispatch* dispatch);
     ~Platform();
 
-    void RemoveInvalidDevices() noexcept;
-
-    cl_uint GetNumDevices() const noexcept;
-    Device *GetDevice(cl_uint i) const noexcept;
+    // Adapter enumeration is deferred until the first call that actually
+    // needs a device, so clGetPlatformIDs / clGetPlatformInfo don't pay for
+    // DXCore enumeration, Device construction, and MCDM validation probes.
+    // Both of these can throw on the first call if enumeration fails.
+    cl_uint GetNumDevices();
+    Device *GetDevice(cl_uint i);
     Compiler *GetCompiler();
     XPlatHelpers::unique_module const& GetDXIL();
     void UnloadCompiler();
 
+    // In-memory cache of compile results, keyed by the same 128-bit hash of
+    // (source, features, build options) used for the disk-backed shader cache.
+    // A hit skips the clang invocation outright, including on systems where
+    // ID3D12ShaderCacheSession is unavailable. Insertion failure is benign -
+    // the caller just keeps its own copy.
+    std::shared_ptr<ProgramBinary> FindCompiledProgram(const uint64_t hash[2]);
+    void StoreCompiledProgram(const uint64_t hash[2], std::shared_ptr<ProgramBinary> const& program) noexcept;
+
     TaskPoolLock GetTaskPoolLock();
     void FlushAllDevices(TaskPoolLock const& Lock);
 
@@ -160,6 +176,23 @@ public:
         context.release();
     }
 
+    // Disk shader-cache writes trickle out on an idle-priority thread so
+    // StoreValue I/O doesn't land on the tail of compiles and specializations.
+    template <typename Fn> void QueueCacheWrite(Fn&& fn)
+    {
+        struct Context { Fn m_fn; };
+        std::unique_ptr<Context> context(new Context{ std::forward<Fn>(fn) });
+        m_CacheWriteScheduler.QueueTask({
+            [](void* pContext)
+            {
+                std::unique_ptr<Context> context(static_cast<Context*>(pContext));
+                context->m_fn();
+            },
+            [](void* pContext) { delete static_cast<Context*>(pContext); },
+            context.get() });
+        context.release();
+    }
+
     template <typename Fn> void QueueProgramOp(Fn&& fn)
     {
         struct Context { Fn m_fn; };
@@ -181,6 +214,11 @@ public:
     const bool m_bWarpIsHardware;
 
 protected:
+    void EnsureDevices();
+    void EnumerateDevices();
+    void RemoveInvalidDevices() noexcept;
+
+    std::once_flag m_DeviceEnumerationOnce;
     ComPtr<IDXCoreAdapterList> m_spAdapters;
     std::vector<std::unique_ptr<Device>> m_Devices;
 
@@ -191,8 +229,14 @@ protected:
 
     std::recursive_mutex m_TaskLock;
 
+    // Compiled-but-unlinked binaries are immutable raw SPIR-V blobs, so one
+    // instance can safely back any number of programs. Cleared by CloseCaches.
+    std::mutex m_CompileCacheLock;
+    std::map<std::pair<uint64_t, uint64_t>, std::shared_ptr<ProgramBinary>> m_CompileCache;
+
     BackgroundTaskScheduler::Scheduler m_CallbackScheduler;
     BackgroundTaskScheduler::Scheduler m_CompileAndLinkScheduler;
+    BackgroundTaskScheduler::Scheduler m_CacheWriteScheduler;
 };
 extern Platform* g_Platform;
 
@@ -5,16 +5,32 @@
 #include "kernel.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+#include <compressapi.h>
 
 #include "spookyv2.h"
+#include "hashing.hpp"
 
 struct ProgramBinaryHeader
 {
     static constexpr GUID c_ValidHeaderGuid = { /* 8d46c01e-2977-4234-a5b0-292405fc1d34 */
         0x8d46c01e, 0x2977, 0x4234, {0xa5, 0xb0, 0x29, 0x24, 0x05, 0xfc, 0x1d, 0x34} };
+    // Bumped when the blob layout changes. Version 2 appends a flat
+    // serialization of the parsed kernel/arg/spec-constant tables after the
+    // SPIR-V, so loading a binary rebuilds them without a SPIR-V parse.
+    // Deliberately not a small integer: this field occupies what used to be
+    // BinaryType, and version-1 blobs hold small values there.
+    static constexpr uint32_t c_CurrentVersion = 0xC0DE0002;
     const GUID HeaderGuid = c_ValidHeaderGuid;
+    uint32_t Version = c_CurrentVersion;
     cl_program_binary_type BinaryType = CL_PROGRAM_BINARY_TYPE_NONE;
     uint32_t BinarySize = 0;
+    uint32_t MetadataSize = 0;
 
     ProgramBinaryHeader() = default;
     ProgramBinaryHeader(const ProgramBinary* obj, cl_program_binary_type type)
@@ -31,10 +47,12 @@ struct ProgramBinaryHeader
 
     size_t ComputeFullBlobSize() const
     {
-        return sizeof(*this) + BinarySize;
+        return sizeof(*this) + BinarySize + MetadataSize;
     }
     void* GetBinary() { return this + 1; }
     const void* GetBinary() const { return this + 1; }
+    void* GetMetadata() { return reinterpret_cast<byte*>(GetBinary()) + BinarySize; }
+    const void* GetMetadata() const { return reinterpret_cast<const byte*>(GetBinary()) + BinarySize; }
 };
 
 extern CL_API_ENTRY cl_program CL_API_CALL
@@ -135,6 +153,8 @@ clCreateProgramWithBinary(cl_context                     context_,
                     throw std::exception("Binary size too small");
                 if (header->HeaderGuid != header->c_ValidHeaderGuid)
                     throw std::exception("Invalid binary header");
+                if (header->Version != ProgramBinaryHeader::c_CurrentVersion)
+                    throw std::exception("Unsupported binary version");
                 if (lengths[i] < header->ComputeFullBlobSize())
                     throw std::exception("Binary size provided is smaller than expected, binary appears truncated");
             }
@@ -158,6 +178,13 @@ clCreateProgramWithBinary(cl_context                     context_,
         {
             auto header = reinterpret_cast<ProgramBinaryHeader const*>(binaries[i]);
             std::shared_ptr<ProgramBinary> BinaryHolder = g_Platform->GetCompiler()->Load(header->GetBinary(), header->BinarySize);
+            if (header->MetadataSize)
+            {
+                // Pre-populates the kernel/arg/spec-constant tables so program
+                // queries work without a SPIR-V parse. Malformed metadata is
+                // simply ignored; the build path parses authoritatively.
+                (void)BinaryHolder->DeserializeKernelInfo(header->GetMetadata(), header->MetadataSize);
+            }
             NewProgram->StoreBinary(static_cast<Device*>(device_list[i]), std::move(BinaryHolder), header->BinaryType);
 
             if (binary_status) *binary_status = CL_SUCCESS;
@@ -240,7 +267,16 @@ clReleaseProgram(cl_program program) CL_API_SUFFIX__VERSION_1_0
     {
         return CL_INVALID_PROGRAM;
     }
-    static_cast<Program*>(program)->Release();
+    Program& prog = *static_cast<Program*>(program);
+    // Dropping the app's last reference cancels any builds still queued or
+    // running on its behalf. The scheduler ops hold their own internal
+    // references, so the object stays alive until they drain; they just stop
+    // doing work nothing can ever observe.
+    if (prog.GetRefCount() == 1)
+    {
+        prog.CancelOutstandingBuilds();
+    }
+    prog.Release();
     return CL_SUCCESS;
 }
 
@@ -451,7 +487,9 @@ clGetProgramInfo(cl_program         program_,
                 auto& BuildData = program.m_BuildData[program.m_AssociatedDevices[i].first.Get()];
                 if (BuildData && BuildData->m_BinaryType != CL_PROGRAM_BINARY_TYPE_NONE)
                 {
-                    ProgramBinaryHeader header(BuildData->m_OwnedBinary.get(), BuildData->m_BinaryType);
+                    auto pBinary = BuildData->GetBinary();
+                    ProgramBinaryHeader header(pBinary, BuildData->m_BinaryType);
+                    header.MetadataSize = (uint32_t)pBinary->SerializeKernelInfo().size();
                     Out[i] = header.ComputeFullBlobSize();
                 }
             }
@@ -481,7 +519,11 @@ clGetProgramInfo(cl_program         program_,
                 auto& BuildData = program.m_BuildData[program.m_AssociatedDevices[i].first.Get()];
                 if (BuildData && BuildData->m_BinaryType != CL_PROGRAM_BINARY_TYPE_NONE)
                 {
-                    new (Out[i]) ProgramBinaryHeader(BuildData->m_OwnedBinary.get(), BuildData->m_BinaryType, ProgramBinaryHeader::CopyBinaryContentsTag{});
+                    auto pBinary = BuildData->GetBinary();
+                    auto metadata = pBinary->SerializeKernelInfo();
+                    auto header = new (Out[i]) ProgramBinaryHeader(pBinary, BuildData->m_BinaryType, ProgramBinaryHeader::CopyBinaryContentsTag{});
+                    header->MetadataSize = (uint32_t)metadata.size();
+                    memcpy(header->GetMetadata(), metadata.data(), metadata.size());
                 }
             }
         }
@@ -708,7 +750,7 @@ cl_int Program::Build(std::vector<D3DDeviceAndRef> Devices, const char* options,
             for (auto& [device, _] : Devices)
             {
                 auto& BuildData = m_BuildData[device.Get()];
-                assert(BuildData && BuildData->m_OwnedBinary);
+                assert(BuildData && (BuildData->m_OwnedBinary || !BuildData->m_CompressedBinary.empty()));
                 BuildData->m_BuildStatus = CL_BUILD_IN_PROGRESS;
                 BuildData->m_BuildLog.clear();
                 BuildData->m_LastBuildOptions = options ? options : "";
@@ -956,7 +998,124 @@ void Program::StoreBinary(Device *Device, std::shared_ptr<ProgramBinary> OwnedBi
 const ProgramBinary *Program::GetSpirV(Device* device) const
 {
     std::lock_guard Lock(m_Lock);
-    return m_BuildData.find(device)->second->m_OwnedBinary.get();
+    return m_BuildData.find(device)->second->GetBinary();
+}
+
+// Whether built programs spill their linked SPIR-V to a compressed in-memory
+// tier once their last kernel is released. On by default; CLON12_TRIM_SPIRV=0
+// keeps every binary live for apps that respecialize constantly.
+static bool TrimSpirvEnabled()
+{
+    static const bool Enabled = []()
+    {
+        if (const char* Override = getenv("CLON12_TRIM_SPIRV"))
+        {
+            return strtoul(Override, nullptr, 10) != 0;
+        }
+        return true;
+    }();
+    return Enabled;
+}
+
+// XPRESS+Huffman via the Windows compression API: no extra dependency, and
+// decompression speed is what matters since rehydration sits on a build or
+// launch path. Returns empty if compression fails or doesn't shrink the blob.
+static std::vector<uint8_t> CompressBlob(const void* pData, size_t size) noexcept
+{
+    std::vector<uint8_t> Compressed;
+    COMPRESSOR_HANDLE Compressor;
+    if (!CreateCompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &Compressor))
+    {
+        return Compressed;
+    }
+    SIZE_T CompressedSize = 0;
+    if (!Compress(Compressor, const_cast<void*>(pData), size, nullptr, 0, &CompressedSize) &&
+        GetLastError() == ERROR_INSUFFICIENT_BUFFER &&
+        CompressedSize < size)
+    {
+        try
+        {
+            Compressed.resize(CompressedSize);
+            if (Compress(Compressor, const_cast<void*>(pData), size,
+                         Compressed.data(), Compressed.size(), &CompressedSize))
+            {
+                Compressed.resize(CompressedSize);
+                Compressed.shrink_to_fit();
+            }
+            else
+            {
+                Compressed.clear();
+            }
+        }
+        catch (std::bad_alloc&)
+        {
+            Compressed.clear();
+        }
+    }
+    CloseCompressor(Compressor);
+    return Compressed;
+}
+
+static bool DecompressBlob(std::vector<uint8_t> const& compressed, void* pOut, size_t outSize) noexcept
+{
+    DECOMPRESSOR_HANDLE Decompressor;
+    if (!CreateDecompressor(COMPRESS_ALGORITHM_XPRESS_HUFF, nullptr, &Decompressor))
+    {
+        return false;
+    }
+    SIZE_T ActualSize = 0;
+    bool Success = Decompress(Decompressor, const_cast<uint8_t*>(compressed.data()), compressed.size(),
+                              pOut, outSize, &ActualSize) &&
+                   ActualSize == outSize;
+    CloseDecompressor(Decompressor);
+    return Success;
+}
+
+void Program::PerDeviceData::TrimBinary(Program& program) noexcept
+{
+    if (!TrimSpirvEnabled() ||
+        !m_OwnedBinary ||
+        !m_CompressedBinary.empty() ||
+        m_BuildStatus != CL_BUILD_SUCCESS ||
+        m_NumPendingLinks != 0 ||
+        // An IL program without spec constants aliases m_ParsedIL, which
+        // stays live for CL_PROGRAM_IL queries - a compressed copy would
+        // only add memory.
+        m_OwnedBinary == program.m_ParsedIL)
+    {
+        return;
+    }
+    auto Compressed = CompressBlob(m_OwnedBinary->GetBinary(), m_OwnedBinary->GetBinarySize());
+    if (Compressed.empty())
+    {
+        return;
+    }
+    m_UncompressedBinarySize = m_OwnedBinary->GetBinarySize();
+    m_CompressedBinary = std::move(Compressed);
+    m_OwnedBinary.reset();
+}
+
+ProgramBinary* Program::PerDeviceData::GetBinary()
+{
+    if (!m_OwnedBinary && !m_CompressedBinary.empty())
+    {
+        std::vector<uint8_t> Spirv(m_UncompressedBinarySize); // throw( bad_alloc )
+        if (!DecompressBlob(m_CompressedBinary, Spirv.data(), Spirv.size()))
+        {
+            throw std::runtime_error("Failed to rehydrate program binary");
+        }
+        auto Rehydrated = g_Platform->GetCompiler()->Load(Spirv.data(), Spirv.size());
+        if (!Rehydrated || !Rehydrated->Parse(nullptr))
+        {
+            throw std::runtime_error("Failed to rehydrate program binary");
+        }
+        m_OwnedBinary = std::move(Rehydrated);
+        // Drop the compressed copy rather than keeping both tiers resident;
+        // the next trim recompresses.
+        m_CompressedBinary.clear();
+        m_CompressedBinary.shrink_to_fit();
+    }
+    return m_OwnedBinary.get();
 }
 
 void Program::KernelCreated()
@@ -969,6 +1128,21 @@ void Program::KernelFreed()
 {
     std::lock_guard lock(m_Lock);
     --m_NumLiveKernels;
+    // With no kernels left, nothing can be specializing: the SPIR-V is only
+    // needed again if the app creates new kernels, queries binaries, or links
+    // against this program, all of which rehydrate. Outstanding
+    // specialization ops hold a kernel reference, so this can't run under
+    // them; in-flight links are excluded inside TrimBinary.
+    if (m_NumLiveKernels == 0)
+    {
+        for (auto& [device, buildData] : m_BuildData)
+        {
+            if (buildData)
+            {
+                buildData->TrimBinary(*this);
+            }
+        }
+    }
 }
 
 void Program::AddBuiltinOptions(std::vector<D3DDeviceAndRef> const& devices, CommonOptions& optionsStruct)
@@ -1119,8 +1293,32 @@ cl_int Program::ParseOptions(const char* optionsStr, CommonOptions& optionsStruc
     return ValidateAndPushArg();
 }
 
+// Called when a build, compile, or link op notices that the app released its
+// last reference to the program while the op was still queued or running.
+// Records the abandonment in the build log and fires the completion callback,
+// which must run exactly once however the attempt ends.
+cl_int Program::AbandonBuild(CommonOptions const& Options)
+{
+    if (Options.BuildData)
+    {
+        std::lock_guard Lock(m_Lock);
+        Options.BuildData->m_BuildStatus = CL_BUILD_ERROR;
+        Options.BuildData->m_BuildLog +=
+            "Build cancelled: program was released with the build still outstanding.\n";
+    }
+    if (Options.pfn_notify)
+    {
+        Options.pfn_notify(this, Options.CallbackUserData);
+    }
+    return CL_BUILD_PROGRAM_FAILURE;
+}
+
 cl_int Program::BuildImpl(BuildArgs const& Args)
 {
+    if (BuildsCancelled())
+    {
+        return AbandonBuild(Args.Common);
+    }
     cl_int ret = CL_SUCCESS;
     auto pCompiler = g_Platform->GetCompiler();
     if (!m_Source.empty() || m_ParsedIL)
@@ -1134,22 +1332,24 @@ cl_int Program::BuildImpl(BuildArgs const& Args)
 
         if (!m_Source.empty())
         {
-            if (Cache.HasCache())
+            SpookyHash hasher;
+            hasher.Init(BuildData->m_Hash[0], BuildData->m_Hash[1]);
+            hasher.Update(m_Source.c_str(), m_Source.size());
+            hasher.Update(&Args.Common.Features, sizeof(Args.Common.Features));
+            for (auto &def : Args.Common.Args)
             {
-                SpookyHash hasher;
-                hasher.Init(BuildData->m_Hash[0], BuildData->m_Hash[1]);
-                hasher.Update(m_Source.c_str(), m_Source.size());
-                hasher.Update(&Args.Common.Features, sizeof(Args.Common.Features));
-                for (auto &def : Args.Common.Args)
-                {
-                    hasher.Update(def.c_str(), def.size());
-                }
-                hasher.Final(&BuildData->m_Hash[0], &BuildData->m_Hash[1]);
+                hasher.Update(def.c_str(), def.size());
+            }
+            hasher.Final(&BuildData->m_Hash[0], &BuildData->m_Hash[1]);
 
+            compiledObject = g_Platform->FindCompiledProgram(BuildData->m_Hash);
+            if (!compiledObject && Cache.HasCache())
+            {
                 auto Precompiled = Cache.Find(BuildData->m_Hash, sizeof(BuildData->m_Hash));
                 if (Precompiled.first)
                 {
                     compiledObject = pCompiler->Load(Precompiled.first.get(), Precompiled.second);
+                    g_Platform->StoreCompiledProgram(BuildData->m_Hash, compiledObject);
                 }
             }
 
@@ -1166,6 +1366,7 @@ cl_int Program::BuildImpl(BuildArgs const& Args)
 
                 compiledObject = pCompiler->Compile(args, loggers);
                 Cache.Store(BuildData->m_Hash, sizeof(BuildData->m_Hash), compiledObject->GetBinary(), compiledObject->GetBinarySize());
+                g_Platform->StoreCompiledProgram(BuildData->m_Hash, compiledObject);
             }
         }
         else
@@ -1181,10 +1382,17 @@ cl_int Program::BuildImpl(BuildArgs const& Args)
             }
             if (Cache.HasCache())
             {
-                SpookyHash::Hash128(compiledObject->GetBinary(), compiledObject->GetBinarySize(), &BuildData->m_Hash[0], &BuildData->m_Hash[1]);
+                BlobHash::Hash128(compiledObject->GetBinary(), compiledObject->GetBinarySize(), &BuildData->m_Hash[0], &BuildData->m_Hash[1]);
             }
         }
 
+        // Re-check between the compile and link phases: a release that landed
+        // mid-compile still saves the link and the per-kernel DXIL fan-out.
+        if (BuildsCancelled())
+        {
+            return AbandonBuild(Args.Common);
+        }
+
         if (compiledObject)
         {
             Compiler::LinkerArgs link_args = {};
@@ -1217,19 +1425,32 @@ cl_int Program::BuildImpl(BuildArgs const& Args)
             auto& BuildData = m_BuildData[device.Get()];
             Logger loggers(m_Lock, BuildData->m_BuildLog);
 
+            auto pBinary = BuildData->GetBinary();
             if (d3dDevice->GetShaderCache().HasCache())
             {
-                SpookyHash::Hash128(BuildData->m_OwnedBinary->GetBinary(), BuildData->m_OwnedBinary->GetBinarySize(),
-                                    &BuildData->m_Hash[0], &BuildData->m_Hash[1]);
+                BlobHash::Hash128(pBinary->GetBinary(), pBinary->GetBinarySize(),
+                                  &BuildData->m_Hash[0], &BuildData->m_Hash[1]);
             }
 
-            Compiler::LinkerArgs link_args = {};
-            link_args.create_library = Args.Common.CreateLibrary;
-            link_args.objs.push_back(BuildData->m_OwnedBinary.get());
-            auto linkedObject = pCompiler->Link(link_args, loggers);
-            BuildData->m_OwnedBinary = std::move(linkedObject);
+            bool bReady;
+            if (BuildData->m_BinaryType == CL_PROGRAM_BINARY_TYPE_EXECUTABLE)
+            {
+                // An executable binary is already linked; running it through
+                // the linker again only re-derives what the blob carries.
+                // Just make sure the SPIR-V is parsed for DXIL generation.
+                bReady = pBinary->Parse(&loggers);
+            }
+            else
+            {
+                Compiler::LinkerArgs link_args = {};
+                link_args.create_library = Args.Common.CreateLibrary;
+                link_args.objs.push_back(pBinary);
+                auto linkedObject = pCompiler->Link(link_args, loggers);
+                BuildData->m_OwnedBinary = std::move(linkedObject);
+                bReady = BuildData->m_OwnedBinary != nullptr;
+            }
 
-            if (BuildData->m_OwnedBinary)
+            if (bReady)
             {
                 BuildData->m_BinaryType = CL_PROGRAM_BINARY_TYPE_EXECUTABLE;
                 BuildData->m_BuildStatus = CL_BUILD_SUCCESS;
@@ -1251,6 +1472,10 @@ cl_int Program::BuildImpl(BuildArgs const& Args)
 
 cl_int Program::CompileImpl(CompileArgs const& Args)
 {
+    if (BuildsCancelled())
+    {
+        return AbandonBuild(Args.Common);
+    }
     cl_int ret = CL_SUCCESS;
     auto& BuildData = Args.Common.BuildData;
     auto pCompiler = g_Platform->GetCompiler();
@@ -1262,27 +1487,29 @@ cl_int Program::CompileImpl(CompileArgs const& Args)
 
     if (!m_Source.empty())
     {
-        if (Cache.HasCache())
+        SpookyHash hasher;
+        hasher.Init(BuildData->m_Hash[0], BuildData->m_Hash[1]);
+        hasher.Update(m_Source.c_str(), m_Source.size());
+        hasher.Update(&Args.Common.Features, sizeof(Args.Common.Features));
+        for (auto &def : Args.Common.Args)
         {
-            SpookyHash hasher;
-            hasher.Init(BuildData->m_Hash[0], BuildData->m_Hash[1]);
-            hasher.Update(m_Source.c_str(), m_Source.size());
-            hasher.Update(&Args.Common.Features, sizeof(Args.Common.Features));
-            for (auto &def : Args.Common.Args)
-            {
-                hasher.Update(def.c_str(), def.size());
-            }
-            for (auto &header : Args.Headers)
-            {
-                hasher.Update(header.first.c_str(), header.first.size());
-                hasher.Update(header.second->m_Source.c_str(), header.second->m_Source.size());
-            }
-            hasher.Final(&BuildData->m_Hash[0], &BuildData->m_Hash[1]);
+            hasher.Update(def.c_str(), def.size());
+        }
+        for (auto &header : Args.Headers)
+        {
+            hasher.Update(header.first.c_str(), header.first.size());
+            hasher.Update(header.second->m_Source.c_str(), header.second->m_Source.size());
+        }
+        hasher.Final(&BuildData->m_Hash[0], &BuildData->m_Hash[1]);
 
+        object = g_Platform->FindCompiledProgram(BuildData->m_Hash);
+        if (!object && Cache.HasCache())
+        {
             auto Precompiled = Cache.Find(BuildData->m_Hash, sizeof(BuildData->m_Hash));
             if (Precompiled.first)
             {
                 object = pCompiler->Load(Precompiled.first.get(), Precompiled.second);
+                g_Platform->StoreCompiledProgram(BuildData->m_Hash, object);
             }
         }
 
@@ -1304,6 +1531,7 @@ cl_int Program::CompileImpl(CompileArgs const& Args)
 
             object = pCompiler->Compile(args, loggers);
             Cache.Store(BuildData->m_Hash, sizeof(BuildData->m_Hash), object->GetBinary(), object->GetBinarySize());
+            g_Platform->StoreCompiledProgram(BuildData->m_Hash, object);
         }
     }
     else
@@ -1319,7 +1547,7 @@ cl_int Program::CompileImpl(CompileArgs const& Args)
         }
         if (BuildData->m_D3DDevice->GetShaderCache().HasCache())
         {
-            SpookyHash::Hash128(object->GetBinary(), object->GetBinarySize(), &BuildData->m_Hash[0], &BuildData->m_Hash[1]);
+            BlobHash::Hash128(object->GetBinary(), object->GetBinarySize(), &BuildData->m_Hash[0], &BuildData->m_Hash[1]);
         }
     }
 
@@ -1372,7 +1600,7 @@ cl_int Program::LinkImpl(LinkArgs const& Args)
             auto& BuildData = Args.LinkPrograms[i]->m_BuildData[Device.Get()];
             if (BuildData)
             {
-                link_args.objs.push_back(BuildData->m_OwnedBinary.get());
+                link_args.objs.push_back(BuildData->GetBinary());
                 if (Cache.HasCache())
                 {
                     memcpy(singleHash, BuildData->m_Hash, sizeof(singleHash));
@@ -1386,26 +1614,39 @@ cl_int Program::LinkImpl(LinkArgs const& Args)
             auto& BuildData = m_BuildData[Device.Get()];
             if (BuildData->m_BuildStatus == CL_BUILD_IN_PROGRESS)
             {
-                Logger loggers(m_Lock, BuildData->m_BuildLog);
-                std::shared_ptr<ProgramBinary> linkedObject = pCompiler->Link(link_args, loggers);
-
-                if (linkedObject)
+                // Cancellation is handled inside the per-device block rather
+                // than as an early return: the m_NumPendingLinks decrements on
+                // the input programs below must run for every device.
+                if (BuildsCancelled())
                 {
-                    memcpy(BuildData->m_Hash, singleHash, sizeof(singleHash));
-                    if (Cache.HasCache() && Args.LinkPrograms.size() > 1)
-                    {
-                        hasher.Final(&BuildData->m_Hash[0], &BuildData->m_Hash[1]);
-                    }
-                    BuildData->m_OwnedBinary = std::move(linkedObject);
-                    BuildData->m_BinaryType = Args.Common.CreateLibrary ?
-                        CL_PROGRAM_BINARY_TYPE_LIBRARY : CL_PROGRAM_BINARY_TYPE_EXECUTABLE;
-                    BuildData->m_BuildStatus = CL_BUILD_SUCCESS;
-                    BuildData->CreateKernels(*this);
+                    BuildData->m_BuildLog +=
+                        "Build cancelled: program was released with the link still outstanding.\n";
+                    BuildData->m_BuildStatus = CL_BUILD_ERROR;
+                    ret = CL_LINK_PROGRAM_FAILURE;
                 }
                 else
                 {
-                    ret = CL_LINK_PROGRAM_FAILURE;
-                    BuildData->m_BuildStatus = CL_BUILD_ERROR;
+                    Logger loggers(m_Lock, BuildData->m_BuildLog);
+                    std::shared_ptr<ProgramBinary> linkedObject = pCompiler->Link(link_args, loggers);
+
+                    if (linkedObject)
+                    {
+                        memcpy(BuildData->m_Hash, singleHash, sizeof(singleHash));
+                        if (Cache.HasCache() && Args.LinkPrograms.size() > 1)
+                        {
+                            hasher.Final(&BuildData->m_Hash[0], &BuildData->m_Hash[1]);
+                        }
+                        BuildData->m_OwnedBinary = std::move(linkedObject);
+                        BuildData->m_BinaryType = Args.Common.CreateLibrary ?
+                            CL_PROGRAM_BINARY_TYPE_LIBRARY : CL_PROGRAM_BINARY_TYPE_EXECUTABLE;
+                        BuildData->m_BuildStatus = CL_BUILD_SUCCESS;
+                        BuildData->CreateKernels(*this);
+                    }
+                    else
+                    {
+                        ret = CL_LINK_PROGRAM_FAILURE;
+                        BuildData->m_BuildStatus = CL_BUILD_ERROR;
+                    }
                 }
             }
         }
@@ -1425,6 +1666,24 @@ cl_int Program::LinkImpl(LinkArgs const& Args)
     return ret;
 }
 
+// Maximum number of threads that CreateKernels will spread per-kernel DXIL
+// generation across. Defaults to the hardware thread count, and can be capped
+// (or forced serial with a value of 1) via CLON12_KERNEL_COMPILE_THREADS.
+static unsigned GetKernelCompileThreadCap()
+{
+    static const unsigned Cap = []()
+    {
+        if (const char* Override = getenv("CLON12_KERNEL_COMPILE_THREADS"))
+        {
+            unsigned Value = (unsigned)strtoul(Override, nullptr, 10);
+            if (Value != 0)
+                return Value;
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+    }();
+    return Cap;
+}
+
 void Program::PerDeviceData::CreateKernels(Program& program)
 {
     if (m_BinaryType != CL_PROGRAM_BINARY_TYPE_EXECUTABLE)
@@ -1433,17 +1692,122 @@ void Program::PerDeviceData::CreateKernels(Program& program)
     auto pCompiler = g_Platform->GetCompiler();
     pCompiler->Initialize(m_D3DDevice->GetShaderCache());
 
+    // Fill in the kernel map up front so the compile work below only ever
+    // writes through stable pointers to pre-existing entries.
     auto& kernels = m_OwnedBinary->GetKernelInfo();
-    Logger loggers(program.m_Lock, m_BuildLog);
+    std::vector<KernelData*> work;
+    work.reserve(kernels.size());
     for (auto& kernelMeta : kernels)
     {
-        auto name = kernelMeta.name;
-        auto& kernel = m_Kernels.emplace(std::piecewise_construct,
-                                         std::forward_as_tuple(name),
-                                         std::forward_as_tuple(kernelMeta, unique_dxil{})).first->second;
-        kernel.m_GenericDxil = pCompiler->GetKernel(name, *m_OwnedBinary, nullptr /*configuration*/, &loggers);
-        if (kernel.m_GenericDxil)
-            kernel.m_GenericDxil->Sign();
+        work.push_back(&m_Kernels.emplace(std::piecewise_construct,
+                                          std::forward_as_tuple(kernelMeta.name),
+                                          std::forward_as_tuple(kernelMeta, unique_dxil{})).first->second);
+    }
+
+    unsigned Parallelism = (unsigned)std::min<size_t>(GetKernelCompileThreadCap(), work.size());
+    if (Parallelism <= 1)
+    {
+        Logger loggers(program.m_Lock, m_BuildLog);
+        for (auto pKernel : work)
+        {
+            // Abandon the remaining kernels if the app released the program;
+            // empty generic DXIL matches a compiler failure downstream.
+            if (program.BuildsCancelled())
+                break;
+            pKernel->m_GenericDxil = pCompiler->GetKernel(pKernel->m_Meta.name, *m_OwnedBinary, nullptr /*configuration*/, &loggers);
+            if (pKernel->m_GenericDxil)
+                pKernel->m_GenericDxil->Sign();
+        }
+        return;
+    }
+
+    // Fan the per-kernel compiles out across the compile-and-link scheduler so
+    // every kernel's generic DXIL is ready by the time the build reports
+    // completion, instead of serializing them on this one thread. Workers
+    // claim kernels from a shared index: this thread participates too, so it
+    // never blocks waiting on a helper op that the scheduler hasn't started.
+    // Each worker logs into its own buffer, because this thread holds
+    // program.m_Lock (which guards the shared build log) while it waits.
+    struct FanOutState
+    {
+        FanOutState(Program* prog, Compiler* compiler, ProgramBinary* binary, std::vector<KernelData*> kernelWork, unsigned numWorkers)
+            : pProgram(prog), pCompiler(compiler), pBinary(binary), Work(std::move(kernelWork)), Logs(numWorkers) { }
+
+        Program* const pProgram;
+        Compiler* const pCompiler;
+        ProgramBinary* const pBinary;
+        const std::vector<KernelData*> Work;
+
+        std::atomic<unsigned> NextKernel{ 0 };
+        std::mutex Lock;
+        std::condition_variable CompletionEvent;
+        unsigned NumCompleted = 0;
+
+        struct WorkerLog
+        {
+            std::recursive_mutex Lock;
+            std::string Log;
+        };
+        std::vector<WorkerLog> Logs;
+    };
+    auto state = std::make_shared<FanOutState>(&program, pCompiler, m_OwnedBinary.get(), std::move(work), Parallelism);
+
+    auto workerLoop = [](FanOutState& state, unsigned workerIndex) noexcept
+    {
+        Logger loggers(state.Logs[workerIndex].Lock, state.Logs[workerIndex].Log);
+        for (;;)
+        {
+            unsigned i = state.NextKernel.fetch_add(1);
+            if (i >= state.Work.size())
+                break;
+            auto pKernel = state.Work[i];
+            // Skip the compile if the app released the program, but still
+            // count the claimed index below: the waiter requires every kernel
+            // to be accounted for before it stitches the logs back together.
+            if (!state.pProgram->BuildsCancelled())
+            {
+                try
+                {
+                    pKernel->m_GenericDxil = state.pCompiler->GetKernel(pKernel->m_Meta.name, *state.pBinary, nullptr /*configuration*/, &loggers);
+                    if (pKernel->m_GenericDxil)
+                        pKernel->m_GenericDxil->Sign();
+                }
+                catch (...)
+                {
+                    // Leave the generic DXIL empty, matching a compiler failure.
+                }
+            }
+            {
+                std::lock_guard lock(state.Lock);
+                ++state.NumCompleted;
+            }
+            state.CompletionEvent.notify_one();
+        }
+    };
+
+    try
+    {
+        for (unsigned worker = 1; worker < Parallelism; ++worker)
+        {
+            g_Platform->QueueProgramOp([state, worker, workerLoop]() { workerLoop(*state, worker); });
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        // Proceed with however many helpers were queued; this thread picks up the rest.
+    }
+    workerLoop(*state, 0);
+
+    {
+        std::unique_lock lock(state->Lock);
+        state->CompletionEvent.wait(lock, [&]() { return state->NumCompleted == (unsigned)state->Work.size(); });
+    }
+
+    // Stitch the per-worker logs back into the shared build log. All workers
+    // are done at this point, and the caller holds program.m_Lock.
+    for (auto& workerLog : state->Logs)
+    {
+        m_BuildLog += workerLog.Log;
     }
 }
 
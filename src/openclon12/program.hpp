@@ -43,6 +43,14 @@ public:
     void KernelCreated();
     void KernelFreed();
 
+    // Set when the app drops its last reference to the program. Build,
+    // compile, and link jobs still queued or running check it between
+    // compiler phases and abandon the rest of the work: interactive tooling
+    // that rebuilds edited kernels otherwise leaves a trail of dead compiles
+    // burning cores behind every release.
+    void CancelOutstandingBuilds() noexcept { m_BuildsCancelled.store(true, std::memory_order_relaxed); }
+    bool BuildsCancelled() const noexcept { return m_BuildsCancelled.load(std::memory_order_relaxed); }
+
     struct SpecializationKey
     {
         D3DDevice const* Device;
@@ -73,9 +81,11 @@ public:
         } Args[1];
         static size_t AllocatedByteSize(uint32_t NumArgs);
         static size_t HashByteSize(uint32_t NumArgs);
-        static std::unique_ptr<const SpecializationKey> Allocate(D3DDevice const* Device, CompiledDxil::Configuration const& conf);
+        static std::unique_ptr<const SpecializationKey> Allocate(D3DDevice const* Device, CompiledDxil::Configuration const& conf,
+                                                                 std::vector<CompiledDxil::Configuration::Arg> const& args);
     private:
-        SpecializationKey(D3DDevice const* Device, CompiledDxil::Configuration const& conf);
+        SpecializationKey(D3DDevice const* Device, CompiledDxil::Configuration const& conf,
+                          std::vector<CompiledDxil::Configuration::Arg> const& args);
     };
     struct SpecializationKeyHash
     {
@@ -89,19 +99,21 @@ public:
     {
         bool m_Error = false;
         unique_dxil m_Dxil;
-        std::unique_ptr<D3D12TranslationLayer::RootSignature> m_RS;
+        std::shared_ptr<D3D12TranslationLayer::RootSignature> m_RS;
         std::unique_ptr<D3D12TranslationLayer::PipelineState> m_PSO;
+        // LRU stamp for cache eviction; guarded by m_SpecializationCacheLock.
+        uint64_t m_LastUse = 0;
         SpecializationValue() = default;
         SpecializationValue(decltype(m_Dxil) d, decltype(m_RS) rs, decltype(m_PSO) p)
             : m_Dxil(std::move(d)), m_RS(std::move(rs)), m_PSO(std::move(p)) { }
         SpecializationValue(SpecializationValue &&) = default;
         SpecializationValue &operator=(SpecializationValue &&) = default;
     };
-    
+
     struct SpecializationData
     {
         const SpecializationKey *KeyInMap;
-        SpecializationValue *Value;
+        std::shared_ptr<SpecializationValue> Value;
         bool NeedToCreate;
         uint64_t ProgramHash[2];
     };
@@ -117,6 +129,7 @@ private:
     mutable std::mutex m_SpecializationUpdateLock;
     mutable std::condition_variable m_SpecializationEvent;
     uint32_t m_NumLiveKernels = 0;
+    std::atomic<bool> m_BuildsCancelled{ false };
 
     struct KernelData
     {
@@ -124,7 +137,18 @@ private:
 
         ProgramBinary::Kernel m_Meta;
         unique_dxil m_GenericDxil;
-        std::unordered_map<std::unique_ptr<const SpecializationKey>, SpecializationValue,
+        // Values are shared so that LRU eviction can drop a map entry while
+        // in-flight tasks and kernel-local memos still hold theirs. Apps flip
+        // among a handful of configurations per kernel; the cap only keeps
+        // pathological configuration churn from growing the cache unbounded.
+        // It has to clear an autotuner's sweep of candidate local sizes,
+        // though - a cap smaller than the sweep evicts early candidates while
+        // the sweep is still running, so re-measuring or settling on one of
+        // them recompiles it. CLON12_SPECIALIZATION_CACHE_SIZE overrides;
+        // 0 disables the cap.
+        static size_t MaxSpecializations();
+        uint64_t m_SpecializationUseCounter = 0;
+        std::unordered_map<std::unique_ptr<const SpecializationKey>, std::shared_ptr<SpecializationValue>,
             SpecializationKeyHash, SpecializationKeyEqual> m_SpecializationCache;
     };
 
@@ -135,6 +159,17 @@ private:
         cl_build_status m_BuildStatus = CL_BUILD_IN_PROGRESS;
         std::string m_BuildLog;
         std::shared_ptr<ProgramBinary> m_OwnedBinary;
+        // Compressed tier for m_OwnedBinary: when the program's last kernel
+        // is released, the linked SPIR-V is compressed here and the live
+        // object dropped, cutting the steady-state footprint of processes
+        // that keep thousands of built programs resident. GetBinary()
+        // rehydrates (decompress + reparse) on demand - binary queries,
+        // re-links, and respecialization after new kernels are created.
+        // CLON12_TRIM_SPIRV=0 disables trimming. Guarded by the program's
+        // m_Lock like the rest of this struct.
+        std::vector<uint8_t> m_CompressedBinary;
+        size_t m_UncompressedBinarySize = 0;
+
         uint64_t m_Hash[2] = {};
         cl_program_binary_type m_BinaryType = CL_PROGRAM_BINARY_TYPE_NONE;
         std::string m_LastBuildOptions;
@@ -143,6 +178,8 @@ private:
         uint32_t m_NumPendingLinks = 0;
 
         void CreateKernels(Program& program);
+        void TrimBinary(Program& program) noexcept;
+        ProgramBinary* GetBinary();
 
         std::mutex m_SpecializationCacheLock;
     };
@@ -185,4 +222,5 @@ private:
     cl_int BuildImpl(BuildArgs const& Args);
     cl_int CompileImpl(CompileArgs const& Args);
     cl_int LinkImpl(LinkArgs const& Args);
+    cl_int AbandonBuild(CommonOptions const& Options);
 };
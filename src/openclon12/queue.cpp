@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #include "queue.hpp"
+#include "resources.hpp"
+#include "kernel.hpp"
+#include "trace.hpp"
 
 /* Command Queue APIs */
 
@@ -9,7 +12,9 @@ bool ValidateQueueProperties(cl_queue_properties const* properties, TReporter&&
 {
     constexpr cl_queue_properties KnownProperties[] =
     {
-        CL_QUEUE_PROPERTIES
+        CL_QUEUE_PROPERTIES,
+        CL_QUEUE_DEDICATED_D3D12_QUEUE_MSFT,
+        CL_QUEUE_PRIORITY_MSFT
     };
     bool SeenProperties[std::extent_v<decltype(KnownProperties)>] = {};
     for (auto CurProp = properties; properties && *CurProp; CurProp += 2)
@@ -75,8 +80,30 @@ clCreateCommandQueueWithPropertiesImpl(cl_context               context_,
         return ReportError("Invalid properties specified.", CL_INVALID_QUEUE_PROPERTIES);
     }
 
+    D3D12_COMMAND_QUEUE_PRIORITY QueuePriority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
+    if (auto FoundPriority = FindProperty<cl_queue_properties>(properties, CL_QUEUE_PRIORITY_MSFT);
+        FoundPriority != nullptr)
+    {
+        switch (*FoundPriority)
+        {
+        case CL_QUEUE_PRIORITY_NORMAL_MSFT: break;
+        case CL_QUEUE_PRIORITY_HIGH_MSFT: QueuePriority = D3D12_COMMAND_QUEUE_PRIORITY_HIGH; break;
+        case CL_QUEUE_PRIORITY_REALTIME_MSFT: QueuePriority = D3D12_COMMAND_QUEUE_PRIORITY_GLOBAL_REALTIME; break;
+        default: return ReportError("Invalid CL_QUEUE_PRIORITY_MSFT value.", CL_INVALID_QUEUE_PROPERTIES);
+        }
+    }
+
     try
     {
+        auto FoundDedicated = FindProperty<cl_queue_properties>(properties, CL_QUEUE_DEDICATED_D3D12_QUEUE_MSFT);
+        // A non-normal priority needs its own D3D12 queue - the shared one
+        // serves every queue on the device - so it implies the dedicated
+        // path. Imported (GL-interop) queues can't honor either request.
+        if (((FoundDedicated && *FoundDedicated) || QueuePriority != D3D12_COMMAND_QUEUE_PRIORITY_NORMAL) &&
+            !d3dDevice->IsImportedDevice())
+        {
+            d3dDevice = &context.CreateDedicatedD3DDevice(device, *d3dDevice, QueuePriority);
+        }
         if (errcode_ret) *errcode_ret = CL_SUCCESS;
         return new CommandQueue(*d3dDevice, context, properties, synthesized_properties);
     }
@@ -150,6 +177,23 @@ clGetCommandQueueInfo(cl_command_queue      command_queue,
             param_value_size, param_value, param_value_size_ret);
     case CL_QUEUE_SIZE: return ReportError("Queue is not a device queue", CL_INVALID_COMMAND_QUEUE);
     case CL_QUEUE_DEVICE_DEFAULT: return RetValue((cl_command_queue)nullptr);
+    case CL_QUEUE_COUNTERS_MSFT:
+    {
+        auto& DeviceCounters = queue.GetD3DDevice().ImmCtx().m_PerfCounters;
+        cl_queue_counters_msft Counters = {};
+        Counters.tasks_queued = queue.m_TasksQueuedCounter.load(std::memory_order_relaxed);
+        Counters.flushes = queue.m_FlushCounter.load(std::memory_order_relaxed);
+        Counters.command_lists_submitted = DeviceCounters.m_CommandListsSubmitted.load(std::memory_order_relaxed);
+        Counters.resource_barriers = DeviceCounters.m_ResourceBarriers.load(std::memory_order_relaxed);
+        Counters.upload_heap_bytes = DeviceCounters.m_UploadHeapBytesAllocated.load(std::memory_order_relaxed);
+        Counters.pool_buffer_acquisitions = DeviceCounters.m_PoolBufferAcquisitions.load(std::memory_order_relaxed);
+        Counters.pool_buffer_creations = DeviceCounters.m_PoolBufferCreations.load(std::memory_order_relaxed);
+        auto& Ctx = queue.GetD3DDevice().ImmCtx();
+        Counters.pool_retained_bytes =
+            Ctx.GetPoolRetainedBytes(D3D12TranslationLayer::AllocatorHeapType::Upload) +
+            Ctx.GetPoolRetainedBytes(D3D12TranslationLayer::AllocatorHeapType::Readback);
+        return RetValue(Counters);
+    }
     }
 
     return ReportError("Unknown param_name", CL_INVALID_VALUE);
@@ -221,6 +265,9 @@ clFinish(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_0
     }
     status = clWaitForEvents(1, &e);
     clReleaseEvent(e);
+    // clFinish is a natural teardown boundary: process this thread's batched
+    // final mem-object releases now that the work referencing them is done.
+    Resource::FlushPendingReleases();
     return status;
 }
 
@@ -234,6 +281,37 @@ static bool IsProfile(const cl_queue_properties* properties)
     auto prop = FindProperty<cl_queue_properties>(properties, CL_QUEUE_PROPERTIES);
     return prop != nullptr && ((*prop) & CL_QUEUE_PROFILING_ENABLE) != 0;
 }
+// How long a blocking wait on one of this queue's events spins on completion
+// before parking on the OS event. The kernel-mode wait/wake round trip costs
+// tens of microseconds, which dominates waits on very short kernels; 0 (the
+// default) always blocks immediately.
+static cl_uint GetEventSpinBudget()
+{
+    static const cl_uint Budget = []() -> cl_uint
+    {
+        if (const char* Override = getenv("CLON12_EVENT_SPIN_US"))
+        {
+            return (cl_uint)strtoul(Override, nullptr, 10);
+        }
+        return 0;
+    }();
+    return Budget;
+}
+// Whether read maps of write-combined (ALLOC_HOST_PTR) buffers are staged
+// through cached memory with streaming loads; see MapStreamCopyTask.
+static bool GetStreamReadMaps()
+{
+    static const bool bEnabled = []() -> bool
+    {
+        if (const char* Override = getenv("CLON12_STREAM_READ_MAPS"))
+        {
+            return strtoul(Override, nullptr, 10) != 0;
+        }
+        return true;
+    }();
+    return bEnabled;
+}
+
 CommandQueue::CommandQueue(D3DDevice& device, Context& context, const cl_queue_properties* properties, bool synthesizedProperties)
     : CLChildBase(device.GetParent())
     , m_Context(context)
@@ -242,17 +320,106 @@ CommandQueue::CommandQueue(D3DDevice& device, Context& context, const cl_queue_p
     , m_bOutOfOrder(IsOutOfOrder(properties))
     , m_bProfile(IsProfile(properties))
     , m_bPropertiesSynthesized(synthesizedProperties)
+    , m_EventSpinMicroseconds(GetEventSpinBudget())
+    , m_StreamReadMaps(GetStreamReadMaps())
+{
+}
+
+// Out-of-line so the staging pool's Resource references are released where
+// Resource is a complete type.
+CommandQueue::~CommandQueue() = default;
+
+::ref_ptr<Resource> CommandQueue::TryAcquireStagingResource(StagingResourceKey const& key)
 {
+    std::lock_guard lock(m_StagingPoolLock);
+    for (auto iter = m_StagingPool.begin(); iter != m_StagingPool.end(); ++iter)
+    {
+        if (iter->first == key)
+        {
+            auto ret = std::move(iter->second);
+            m_StagingPool.erase(iter);
+            return ret;
+        }
+    }
+    return {};
+}
+
+void CommandQueue::RecycleStagingResource(StagingResourceKey const& key, ::ref_ptr<Resource> resource) noexcept
+{
+    std::lock_guard lock(m_StagingPoolLock);
+    if (m_StagingPool.size() < MaxStagingPoolEntries)
+    {
+        try
+        {
+            m_StagingPool.emplace_back(key, std::move(resource));
+        }
+        catch (std::bad_alloc&)
+        {
+            // The resource is simply released instead of pooled.
+        }
+    }
+    // On overflow the resource is released; deferred destruction keeps the
+    // underlying allocation alive until the GPU is done with it.
+}
+
+// Graph runtimes emit bursts of hundreds of small clEnqueueCopyBuffer calls,
+// many covering adjacent ranges of the same buffers. Merge such runs into one
+// CopyBufferRegion before submission: the absorbed tasks record nothing but
+// still flow through the task machinery, so event order and completion are
+// unchanged. Only immediately-adjacent tasks whose sole ordering is the
+// in-order chain are merged - an explicit wait list could be meant to delay a
+// copy past the head's recording point. Out-of-order queues have no useful
+// adjacency and profiled queues want per-command timestamps, so both skip the
+// pass; so does CLON12_COALESCE_COPIES=0. The non-contiguous remainder of a
+// burst already shares barrier batches, since the lazy state tracker sees the
+// buffers are still in copy states and emits nothing for the repeats.
+void CommandQueue::CoalesceQueuedCopies(TaskPoolLock const&)
+{
+    static const bool bEnabled = []() -> bool
+    {
+        if (const char* Override = getenv("CLON12_COALESCE_COPIES"))
+        {
+            return strtoul(Override, nullptr, 10) != 0;
+        }
+        return true;
+    }();
+    if (!bEnabled || m_bOutOfOrder || m_bProfile || m_QueuedTasks.size() < 2)
+    {
+        return;
+    }
+    for (size_t i = 0; i + 1 < m_QueuedTasks.size(); )
+    {
+        size_t j = i + 1;
+        while (j < m_QueuedTasks.size() &&
+               m_QueuedTasks[j]->SoleDependencyIs(m_QueuedTasks[j - 1].Get()) &&
+               TryCoalesceBufferCopies(*m_QueuedTasks[i], *m_QueuedTasks[j]))
+        {
+            ++j;
+        }
+        i = j;
+    }
 }
 
 void CommandQueue::Flush(TaskPoolLock const& lock, bool flushDevice)
 {
+    m_FlushCounter.fetch_add(1, std::memory_order_relaxed);
+    CoalesceQueuedCopies(lock);
     while (!m_QueuedTasks.empty())
     {
         m_OutstandingTasks.emplace_back(m_QueuedTasks.front().Get());
         m_QueuedTasks.pop_front();
         m_D3DDevice.SubmitTask(m_OutstandingTasks.back().Get(), lock);
     }
+    // Marker proxies ride along with the flush: their predecessors just got
+    // submitted, so they're submitted too (clWaitForEvents keys its flush
+    // pass off the queued state).
+    for (auto& pending : m_PendingMarkers)
+    {
+        if (pending.second->GetState() == Task::State::Queued)
+        {
+            pending.second->Submit();
+        }
+    }
     if (flushDevice)
     {
         m_D3DDevice.Flush(lock);
@@ -273,6 +440,8 @@ void CommandQueue::QueueTask(Task* p, TaskPoolLock const& lock)
     }
 
     m_QueuedTasks.emplace_back(p);
+    m_TasksQueuedCounter.fetch_add(1, std::memory_order_relaxed);
+    CLON12_TRACE_TASK(Queued, p);
 
     if (!m_bOutOfOrder)
     {
@@ -284,7 +453,7 @@ void CommandQueue::QueueTask(Task* p, TaskPoolLock const& lock)
     }
 }
 
-void CommandQueue::NotifyTaskCompletion(Task* p, TaskPoolLock const&)
+void CommandQueue::NotifyTaskCompletion(Task* p, TaskPoolLock const& lock)
 {
     {
         auto newEnd = std::remove_if(m_OutstandingTasks.begin(), m_OutstandingTasks.end(),
@@ -304,10 +473,38 @@ void CommandQueue::NotifyTaskCompletion(Task* p, TaskPoolLock const&)
     {
         m_LastQueuedBarrier = nullptr;
     }
+
+    // Complete any marker proxies snapshotted on this task, propagating its
+    // error state like a real dependency would. Each entry is erased before
+    // the proxy completes: completion re-enters this method for the proxy
+    // itself, which must observe a consistent list (and can't match - proxies
+    // are never predecessors).
+    for (size_t i = 0; i < m_PendingMarkers.size();)
+    {
+        if (m_PendingMarkers[i].first.Get() != p)
+        {
+            ++i;
+            continue;
+        }
+        auto marker = std::move(m_PendingMarkers[i].second);
+        m_PendingMarkers.erase(m_PendingMarkers.begin() + i);
+        marker->Complete(std::min((cl_int)p->GetState(), 0), lock);
+    }
 }
 
 void CommandQueue::AddAllTasksAsDependencies(Task* p, TaskPoolLock const& lock)
 {
+    // In-order queues chain every task to its predecessor as it's queued, so
+    // the last queued task (and barrier), which QueueTask is about to add as
+    // dependencies, transitively cover everything outstanding. Only
+    // out-of-order queues need the full fan-in: there the tasks form a DAG
+    // with no implicit ordering, and a marker or barrier must gather every
+    // leaf individually.
+    if (!m_bOutOfOrder)
+    {
+        return;
+    }
+
     for (auto& task : m_OutstandingTasks)
     {
         if (task.Get() == m_LastQueuedTask || task.Get() == m_LastQueuedBarrier)
@@ -323,3 +520,31 @@ void CommandQueue::AddAllTasksAsDependencies(Task* p, TaskPoolLock const& lock)
         p->AddDependencies(&TaskAsEvent, 1, lock);
     }
 }
+
+Task *CommandQueue::TryQueueMarkerProxy(cl_command_type type, TaskPoolLock const& lock)
+{
+    if (m_bOutOfOrder || m_bProfile)
+    {
+        return nullptr;
+    }
+
+    std::unique_ptr<MarkerProxyTask> marker(new MarkerProxyTask(GetContext(), type, this));
+    Task *predecessor = m_LastQueuedTask;
+    if (!predecessor)
+    {
+        // Everything previously queued on this in-order queue has completed,
+        // so the marker is already satisfied.
+        marker->Submit();
+        marker->Complete(CL_SUCCESS, lock);
+        return marker.release();
+    }
+
+    m_PendingMarkers.emplace_back(predecessor, marker.get());
+    if (predecessor->GetState() != Task::State::Queued)
+    {
+        // The predecessor was already flushed; a later Flush won't see the
+        // proxy's queued state, so submit it now.
+        marker->Submit();
+    }
+    return marker.release();
+}
@@ -6,10 +6,62 @@
 #include "context.hpp"
 #include "task.hpp"
 
+class Resource;
+class Program;
+class Kernel;
+
+// cl_msft_dedicated_queue: a nonzero value for this creation property gives
+// the command queue its own D3D12 command queue and fence timeline (a
+// dedicated D3DDevice), so independent streams of work submit and retire
+// concurrently instead of serializing through the context's shared recording
+// context. Best suited to queues with disjoint working sets: resources
+// touched from several queues are kept coherent by the regular cross-device
+// migration machinery, which copies. Ignored for GL-interop contexts, which
+// must record into the application's imported queue.
+#define CL_QUEUE_DEDICATED_D3D12_QUEUE_MSFT 0x4F81
+
+// cl_msft_queue_counters: clGetCommandQueueInfo param that snapshots the
+// runtime's internal efficiency counters into a cl_queue_counters_msft.
+// The per-queue fields count this queue's activity; the device fields are
+// cumulative totals for the D3D12 device backing it (shared by every queue
+// on that device unless the queue was created with
+// CL_QUEUE_DEDICATED_D3D12_QUEUE_MSFT). Counters are monotonic (except the
+// pool_retained_bytes gauge) and updated with relaxed atomics, so a snapshot
+// is approximate but never perturbs the paths being measured - cheap enough
+// to poll from telemetry.
+#define CL_QUEUE_COUNTERS_MSFT 0x4F82
+
+typedef struct _cl_queue_counters_msft
+{
+    cl_ulong tasks_queued;              // Tasks enqueued to this queue, lifetime
+    cl_ulong flushes;                   // Explicit and implicit flushes of this queue
+    cl_ulong command_lists_submitted;   // Device: command lists executed
+    cl_ulong resource_barriers;         // Device: D3D12 resource barriers recorded
+    cl_ulong upload_heap_bytes;         // Device: bytes suballocated from upload heaps
+    cl_ulong pool_buffer_acquisitions;  // Device: dynamic buffer pool requests
+    cl_ulong pool_buffer_creations;     // Device: requests that missed and allocated
+    cl_ulong pool_retained_bytes;       // Device: bytes currently parked in the buffer pools (gauge)
+} cl_queue_counters_msft;
+
+// cl_msft_queue_priority: creation property selecting the D3D12 priority of
+// the queue feeding the GPU, for interactive work sharing a process with
+// background batch compute. Non-normal priorities imply a dedicated D3D12
+// queue (as if CL_QUEUE_DEDICATED_D3D12_QUEUE_MSFT were set - the shared
+// queue's priority serves every queue on the device), submit eagerly instead
+// of riding the adaptive flush batching, and are ignored for GL-interop
+// contexts, which record into the application's imported queue. Realtime
+// requires elevated process privileges and quietly degrades to high when
+// queue creation at that priority is denied.
+#define CL_QUEUE_PRIORITY_MSFT 0x4F83
+#define CL_QUEUE_PRIORITY_NORMAL_MSFT 0x1
+#define CL_QUEUE_PRIORITY_HIGH_MSFT 0x2
+#define CL_QUEUE_PRIORITY_REALTIME_MSFT 0x4
+
 class CommandQueue : public CLChildBase<CommandQueue, Device, cl_command_queue>
 {
 public:
     CommandQueue(D3DDevice& device, Context& context, const cl_queue_properties* properties, bool synthesizedProperties);
+    ~CommandQueue();
 
     friend cl_int CL_API_CALL clGetCommandQueueInfo(cl_command_queue, cl_command_queue_info, size_t, void*, size_t*);
 
@@ -19,14 +71,77 @@ public:
 
     void Flush(TaskPoolLock const&, bool flushDevice);
     void QueueTask(Task*, TaskPoolLock const&);
+    // Merges runs of queued buffer copies over contiguous ranges of the same
+    // buffers into single copies before they reach the device; run by Flush.
+    void CoalesceQueuedCopies(TaskPoolLock const&);
     void NotifyTaskCompletion(Task*, TaskPoolLock const&);
     void AddAllTasksAsDependencies(Task*, TaskPoolLock const&);
 
+    // Fast path for markers and barriers with no explicit wait list: on an
+    // in-order queue they're satisfied exactly when the last queued task is,
+    // so the returned event is a MarkerProxyTask pinned to that task instead
+    // of a DummyTask flowing through the queue/record machinery. Progress-
+    // tracking frameworks insert these after every logical step, so the
+    // per-marker cost matters. Returns null (caller falls back to the queued
+    // DummyTask) for out-of-order queues and for profiling queues, which
+    // need real recorded commands to produce timestamps. The caller owns the
+    // returned reference.
+    Task *TryQueueMarkerProxy(cl_command_type type, TaskPoolLock const&);
+
+    // Pool of staging resources used by MapCopyTask to shuttle non-mappable
+    // resources through a readback heap. Maps and reads of such resources
+    // otherwise create and destroy a fresh staging resource each time, which
+    // dominates per-frame readback loops. Buffers are keyed by rounded-up
+    // size, images by their exact format and dimensions. The pool lives on
+    // the queue rather than the context so it can't keep the context alive:
+    // pooled resources reference the context, but nothing references the
+    // queue, so releasing the queue releases the pool.
+    struct StagingResourceKey
+    {
+        cl_mem_object_type ImageType;
+        cl_image_format Format;
+        cl_ulong Width;
+        cl_uint Height;
+        cl_uint Depth;
+        cl_uint ArraySize;
+        bool operator==(StagingResourceKey const& o) const
+        {
+            return ImageType == o.ImageType &&
+                Format.image_channel_order == o.Format.image_channel_order &&
+                Format.image_channel_data_type == o.Format.image_channel_data_type &&
+                Width == o.Width && Height == o.Height &&
+                Depth == o.Depth && ArraySize == o.ArraySize;
+        }
+    };
+    ::ref_ptr<Resource> TryAcquireStagingResource(StagingResourceKey const& key);
+    void RecycleStagingResource(StagingResourceKey const& key, ::ref_ptr<Resource> resource) noexcept;
+
+    // Internal compute kernels that repack buffer rects on the GPU (see
+    // CopyBufferRectTask in resource_tasks.cpp). Built lazily from embedded
+    // OpenCL C through the normal program pipeline, once per queue; returns
+    // null if the build fails, in which case copies fall back to the per-row
+    // copy loop. Owned by the queue for the same reason as the staging pool:
+    // the program references the context, so the context must not own it.
+    Kernel *GetRepackKernel(bool bDwordGranularity);
+
     const bool m_bOutOfOrder;
     const bool m_bProfile;
     const bool m_bPropertiesSynthesized;
+    // Budget for spinning on event completion before falling back to a
+    // blocking wait, in microseconds. Defaults from CLON12_EVENT_SPIN_US.
+    const cl_uint m_EventSpinMicroseconds;
+    // Whether read maps of CL_MEM_ALLOC_HOST_PTR buffers return a cached
+    // shadow copy instead of a pointer into the write-combined heap. On by
+    // default; CLON12_STREAM_READ_MAPS=0 restores the zero-copy pointer for
+    // apps that map large ranges but only touch a few bytes.
+    const bool m_StreamReadMaps;
     std::vector<cl_queue_properties> const m_Properties;
 
+    // Per-queue halves of CL_QUEUE_COUNTERS_MSFT; the device-wide halves
+    // live on ImmediateContext::m_PerfCounters.
+    std::atomic<cl_ulong> m_TasksQueuedCounter{ 0 };
+    std::atomic<cl_ulong> m_FlushCounter{ 0 };
+
 protected:
     Context::ref_int m_Context;
     D3DDevice &m_D3DDevice;
@@ -35,4 +150,18 @@ protected:
     std::vector<Task::ref_ptr_int> m_OutstandingTasks;
     Task* m_LastQueuedTask = nullptr;
     Task* m_LastQueuedBarrier = nullptr;
+
+    // Marker proxies waiting on their snapshotted predecessor (first), kept
+    // out of m_QueuedTasks so they never reach the device. Predecessors can't
+    // themselves be proxies - proxies don't update m_LastQueuedTask.
+    std::vector<std::pair<Task::ref_ptr_int, ::ref_ptr_int<MarkerProxyTask>>> m_PendingMarkers;
+
+    std::mutex m_StagingPoolLock;
+    std::vector<std::pair<StagingResourceKey, ::ref_ptr<Resource>>> m_StagingPool;
+    static constexpr size_t MaxStagingPoolEntries = 8;
+
+    std::mutex m_RepackKernelLock;
+    ::ref_ptr<Program> m_RepackProgram;
+    ::ref_ptr<Kernel> m_RepackKernels[2];
+    bool m_RepackBuildAttempted = false;
 };
@@ -5,6 +5,8 @@
 #include "queue.hpp"
 #include "wil/resource.h"
 
+#include <algorithm>
+
 #include "ImmediateContext.inl"
 
 template <typename T>
@@ -13,22 +15,37 @@ using unique_comptr = D3D12TranslationLayer::unique_comptr<T>;
 class CopyCrossAdapter : public Task
 {
     Resource& m_Resource;
-    unique_comptr<ID3D12Resource> m_CrossAdapterBuffer;
+    ComPtr<ID3D12Resource> m_CrossAdapterBuffer;
     ImmCtx& m_ImmCtx;
     bool m_ToCrossAdapter;
+    // Destination-side copies of a full migration make the resource active
+    // on their device; sub-range copies leave the active device alone.
+    bool m_SetActiveDevice;
+    // Byte range of a buffer migration handled by this task; large buffers
+    // are split into chunks so both adapters can work on the transfer at
+    // the same time, and sub-range migrations move a slice of the resource
+    // through a staging buffer sized to the slice. Unused for textures.
+    UINT64 m_ResourceOffset;
+    UINT64 m_StagingOffset;
+    UINT64 m_Size;
 public:
-    CopyCrossAdapter(Context& Context, Resource& Resource, unique_comptr<ID3D12Resource> CrossAdapterBuffer, D3DDevice& Device, bool ToCrossAdapter)
+    CopyCrossAdapter(Context& Context, Resource& Resource, ComPtr<ID3D12Resource> CrossAdapterBuffer, D3DDevice& Device, bool ToCrossAdapter,
+                     bool SetActiveDevice, UINT64 ResourceOffset, UINT64 StagingOffset, UINT64 Size)
         : Task(Context, Device)
         , m_Resource(Resource)
         , m_CrossAdapterBuffer(std::move(CrossAdapterBuffer))
         , m_ImmCtx(m_D3DDevice->ImmCtx())
         , m_ToCrossAdapter(ToCrossAdapter)
+        , m_SetActiveDevice(SetActiveDevice)
+        , m_ResourceOffset(ResourceOffset)
+        , m_StagingOffset(StagingOffset)
+        , m_Size(Size)
     {
     }
 
     void MigrateResources() final
     {
-        if (!m_ToCrossAdapter)
+        if (!m_ToCrossAdapter && m_SetActiveDevice)
         {
             m_Resource.SetActiveDevice(m_D3DDevice);
         }
@@ -43,9 +60,11 @@ public:
         ID3D12Resource* CLResource = m_Resource.GetUnderlyingResource(m_D3DDevice)->GetUnderlyingResource();
         if (m_Resource.m_Desc.image_type == CL_MEM_OBJECT_BUFFER)
         {
-            ID3D12Resource* Source = m_ToCrossAdapter ? CLResource : m_CrossAdapterBuffer.get();
-            ID3D12Resource* Dest = m_ToCrossAdapter ? m_CrossAdapterBuffer.get() : CLResource;
-            m_ImmCtx.GetGraphicsCommandList()->CopyBufferRegion(Dest, 0, Source, 0, m_Resource.m_Desc.image_width);
+            ID3D12Resource* Source = m_ToCrossAdapter ? CLResource : m_CrossAdapterBuffer.Get();
+            ID3D12Resource* Dest = m_ToCrossAdapter ? m_CrossAdapterBuffer.Get() : CLResource;
+            UINT64 SourceOffset = m_ToCrossAdapter ? m_ResourceOffset : m_StagingOffset;
+            UINT64 DestOffset = m_ToCrossAdapter ? m_StagingOffset : m_ResourceOffset;
+            m_ImmCtx.GetGraphicsCommandList()->CopyBufferRegion(Dest, DestOffset, Source, SourceOffset, m_Size);
         }
         else
         {
@@ -53,7 +72,7 @@ public:
             UINT NumSubresources = TransRes->NumSubresources();
             D3D12_TEXTURE_COPY_LOCATION Buffer, Image;
             Buffer.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-            Buffer.pResource = m_CrossAdapterBuffer.get();
+            Buffer.pResource = m_CrossAdapterBuffer.Get();
             Image.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
             Image.pResource = CLResource;
 
@@ -71,15 +90,186 @@ public:
     }
 };
 
+namespace
+{
+    struct CrossAdapterStaging
+    {
+        ComPtr<ID3D12Resource> Source;
+        ComPtr<ID3D12Resource> Dest;
+    };
+
+    // A cross-adapter heap of the given size on fromDevice, shared to
+    // toDevice, with a placed cross-adapter buffer over each side.
+    CrossAdapterStaging CreateCrossAdapterStaging(D3DDevice* fromDevice, D3DDevice* toDevice, UINT64 size)
+    {
+        unique_comptr<ID3D12Heap> CrossAdapterHeap;
+        D3D12_HEAP_DESC HeapDesc = CD3DX12_HEAP_DESC(
+            D3D12TranslationLayer::Align<UINT64>(size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT),
+            D3D12_HEAP_TYPE_DEFAULT, 0,
+            D3D12_HEAP_FLAG_SHARED | D3D12_HEAP_FLAG_SHARED_CROSS_ADAPTER);
+        D3D12TranslationLayer::ThrowFailure(fromDevice->GetDevice()->CreateHeap(&HeapDesc, IID_PPV_ARGS(&CrossAdapterHeap)));
+        HANDLE SharedHandle = nullptr;
+        D3D12TranslationLayer::ThrowFailure(fromDevice->GetDevice()->CreateSharedHandle(
+            CrossAdapterHeap.get(), nullptr, GENERIC_ALL, nullptr, &SharedHandle
+        ));
+        auto cleanup = wil::scope_exit([SharedHandle]()
+        {
+            CloseHandle(SharedHandle);
+        });
+
+        CrossAdapterStaging Staging;
+        D3D12_RESOURCE_DESC ResDesc = CD3DX12_RESOURCE_DESC::Buffer(size, D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER);
+        D3D12TranslationLayer::ThrowFailure(fromDevice->GetDevice()->CreatePlacedResource(
+            CrossAdapterHeap.get(), 0, &ResDesc,
+            D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&Staging.Source)
+        ));
+
+        CrossAdapterHeap.reset();
+        D3D12TranslationLayer::ThrowFailure(toDevice->GetDevice()->OpenSharedHandle(SharedHandle, IID_PPV_ARGS(&CrossAdapterHeap)));
+        D3D12TranslationLayer::ThrowFailure(toDevice->GetDevice()->CreatePlacedResource(
+            CrossAdapterHeap.get(), 0, &ResDesc,
+            D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&Staging.Dest)
+        ));
+        return Staging;
+    }
+}
+
+void Resource::EnqueueCopyRangeCrossAdapter(D3DDevice* fromDevice, D3DDevice* toDevice, Task* triggeringTask,
+    UINT64 offset, UINT64 size)
+{
+    assert(m_Desc.image_type == CL_MEM_OBJECT_BUFFER);
+    auto Staging = CreateCrossAdapterStaging(fromDevice, toDevice, size);
+
+    auto Lock = g_Platform->GetTaskPoolLock();
+    std::unique_ptr<Task> CopyToCrossAdapter(new CopyCrossAdapter(
+        triggeringTask->m_Parent.get(), *this, Staging.Source, *fromDevice, true, false, offset, 0, size));
+    std::unique_ptr<Task> CopyFromCrossAdapter(new CopyCrossAdapter(
+        triggeringTask->m_Parent.get(), *this, Staging.Dest, *toDevice, false, false, offset, 0, size));
+
+    cl_event e = CopyToCrossAdapter.get();
+    CopyFromCrossAdapter->AddDependencies(&e, 1, Lock);
+    fromDevice->SubmitTask(CopyToCrossAdapter.get(), Lock);
+    CopyToCrossAdapter->Release();
+    CopyToCrossAdapter.release();
+    // The destination-side copy waits on the source-side fence, so the
+    // source work needs a submission of its own.
+    fromDevice->Flush(Lock);
+
+    e = CopyFromCrossAdapter.get();
+    triggeringTask->AddDependencies(&e, 1, Lock);
+    toDevice->SubmitTask(CopyFromCrossAdapter.get(), Lock);
+    CopyFromCrossAdapter->Release();
+    CopyFromCrossAdapter.release();
+}
+
+void Resource::MigrateSubRange(D3DDevice* newDevice, Task* triggeringTask, cl_mem_migration_flags flags, UINT64 offset, UINT64 size)
+{
+    assert(!m_ParentBuffer.Get() && m_Desc.image_type == CL_MEM_OBJECT_BUFFER);
+
+    // First placement and content-undefined migrations take the full path,
+    // which also handles the initial data upload.
+    if (!m_ActiveUnderlying || (flags & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED))
+    {
+        EnqueueMigrateResource(newDevice, triggeringTask, flags);
+        return;
+    }
+
+    // Lock order: the copy tasks queued below nest the task pool lock outside
+    // the multi-device lock (SetActiveDevice runs under the pool lock), so
+    // take them in that order here too.
+    auto Lock = g_Platform->GetTaskPoolLock();
+    std::lock_guard MDLock(m_MultiDeviceLock);
+
+    // Pieces of the requested range that earlier sub-range migrations moved
+    // to other devices come from those devices; whatever is left comes from
+    // the active device. Remote ranges stay non-overlapping throughout.
+    std::vector<RemoteRange> Updated;
+    std::vector<std::pair<UINT64, UINT64>> Covered;
+    for (auto const& Range : m_RemoteRanges)
+    {
+        const UINT64 OverlapBegin = std::max(Range.Offset, offset);
+        const UINT64 OverlapEnd = std::min(Range.Offset + Range.Size, offset + size);
+        if (OverlapBegin >= OverlapEnd)
+        {
+            Updated.push_back(Range);
+            continue;
+        }
+        if (Range.Device != newDevice)
+        {
+            EnqueueCopyRangeCrossAdapter(Range.Device, newDevice, triggeringTask, OverlapBegin, OverlapEnd - OverlapBegin);
+        }
+        Covered.push_back({ OverlapBegin, OverlapEnd });
+        if (Range.Offset < OverlapBegin)
+        {
+            Updated.push_back({ Range.Device, Range.Offset, OverlapBegin - Range.Offset });
+        }
+        if (Range.Offset + Range.Size > OverlapEnd)
+        {
+            Updated.push_back({ Range.Device, OverlapEnd, Range.Offset + Range.Size - OverlapEnd });
+        }
+    }
+    if (m_CurrentActiveDevice != newDevice)
+    {
+        std::sort(Covered.begin(), Covered.end());
+        UINT64 Cursor = offset;
+        for (auto const& [Begin, End] : Covered)
+        {
+            if (Begin > Cursor)
+            {
+                EnqueueCopyRangeCrossAdapter(m_CurrentActiveDevice, newDevice, triggeringTask, Cursor, Begin - Cursor);
+            }
+            Cursor = std::max(Cursor, End);
+        }
+        if (Cursor < offset + size)
+        {
+            EnqueueCopyRangeCrossAdapter(m_CurrentActiveDevice, newDevice, triggeringTask, Cursor, offset + size - Cursor);
+        }
+        Updated.push_back({ newDevice, offset, size });
+    }
+    m_RemoteRanges = std::move(Updated);
+}
+
 void Resource::EnqueueMigrateResource(D3DDevice* newDevice, Task* triggeringTask, cl_mem_migration_flags flags)
 {
     if (m_ParentBuffer.Get())
     {
-        m_ParentBuffer->EnqueueMigrateResource(newDevice, triggeringTask, flags);
+        // Buffer slices move individually so sharding a large buffer across
+        // devices with sub-buffers doesn't pay a full-parent migration per
+        // shard. 1D image buffers keep whole-parent migration.
+        if (m_Desc.image_type == CL_MEM_OBJECT_BUFFER)
+        {
+            m_ParentBuffer->MigrateSubRange(newDevice, triggeringTask, flags, m_Offset, m_Desc.image_width);
+        }
+        else
+        {
+            m_ParentBuffer->EnqueueMigrateResource(newDevice, triggeringTask, flags);
+        }
         SetActiveDevice(newDevice);
         return;
     }
 
+    {
+        // Consolidate slices that sub-range migration moved to other devices
+        // back onto the active device first, so the rest of this function
+        // only has to reason about one source of valid data.
+        auto Lock = g_Platform->GetTaskPoolLock();
+        std::lock_guard MDLock(m_MultiDeviceLock);
+        if (!m_RemoteRanges.empty())
+        {
+            if (m_ActiveUnderlying && (flags & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) == 0)
+            {
+                for (auto const& Range : m_RemoteRanges)
+                {
+                    if (Range.Device != m_CurrentActiveDevice)
+                    {
+                        EnqueueCopyRangeCrossAdapter(Range.Device, m_CurrentActiveDevice, triggeringTask, Range.Offset, Range.Size);
+                    }
+                }
+            }
+            m_RemoteRanges.clear();
+        }
+    }
+
     if (m_CurrentActiveDevice == newDevice)
         return;
 
@@ -95,52 +285,47 @@ void Resource::EnqueueMigrateResource(D3DDevice* newDevice, Task* triggeringTask
     }
 
     assert(m_CurrentActiveDevice != nullptr && triggeringTask != nullptr);
-    unique_comptr<ID3D12Heap> CrossAdapterHeap;
-    D3D12_HEAP_DESC HeapDesc = CD3DX12_HEAP_DESC(GetActiveUnderlyingResource()->GetResourceSize(), D3D12_HEAP_TYPE_DEFAULT, 0,
-                                                 D3D12_HEAP_FLAG_SHARED | D3D12_HEAP_FLAG_SHARED_CROSS_ADAPTER);
-    D3D12TranslationLayer::ThrowFailure(m_CurrentActiveDevice->GetDevice()->CreateHeap(&HeapDesc, IID_PPV_ARGS(&CrossAdapterHeap)));
-    HANDLE SharedHandle = nullptr;
-    D3D12TranslationLayer::ThrowFailure(m_CurrentActiveDevice->GetDevice()->CreateSharedHandle(
-        CrossAdapterHeap.get(), nullptr, GENERIC_ALL, nullptr, &SharedHandle
-    ));
-    auto cleanup = wil::scope_exit([SharedHandle]()
-    {
-        CloseHandle(SharedHandle);
-    });
-
-    unique_comptr<ID3D12Resource> CrossAdapterResource;
-    D3D12_RESOURCE_DESC ResDesc = CD3DX12_RESOURCE_DESC::Buffer(GetActiveUnderlyingResource()->GetResourceSize(),
-                                                                D3D12_RESOURCE_FLAG_ALLOW_CROSS_ADAPTER);
-    D3D12TranslationLayer::ThrowFailure(m_CurrentActiveDevice->GetDevice()->CreatePlacedResource(
-        CrossAdapterHeap.get(), 0, &ResDesc,
-        D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&CrossAdapterResource)
-    ));
-
-    std::unique_ptr<Task> CopyToCrossAdapter(new CopyCrossAdapter(
-        triggeringTask->m_Parent.get(), *this, std::move(CrossAdapterResource), *m_CurrentActiveDevice, true));
-
-    CrossAdapterHeap.reset();
-    D3D12TranslationLayer::ThrowFailure(newDevice->GetDevice()->OpenSharedHandle(SharedHandle, IID_PPV_ARGS(&CrossAdapterHeap)));
-    D3D12TranslationLayer::ThrowFailure(newDevice->GetDevice()->CreatePlacedResource(
-        CrossAdapterHeap.get(), 0, &ResDesc,
-        D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&CrossAdapterResource)
-    ));
-    std::unique_ptr<Task> CopyFromCrossAdapter(new CopyCrossAdapter(
-        triggeringTask->m_Parent.get(), *this, std::move(CrossAdapterResource), *newDevice, false));
+    auto Staging = CreateCrossAdapterStaging(m_CurrentActiveDevice, newDevice, GetActiveUnderlyingResource()->GetResourceSize());
+
+    // Large buffers migrate in chunks through disjoint ranges of the shared
+    // staging buffer. Each source-side chunk copy gets its own submission, and
+    // the matching destination-side copy depends only on that chunk, so the
+    // destination GPU starts pulling completed chunks while the source GPU is
+    // still staging later ones instead of waiting for the whole transfer.
+    // Textures and small buffers keep the single-copy path.
+    constexpr UINT64 MigrationChunkSize = 64 * 1024 * 1024;
+    const UINT64 TotalSize = m_Desc.image_type == CL_MEM_OBJECT_BUFFER ? m_Desc.image_width : 0;
+    const UINT64 NumChunks = TotalSize > MigrationChunkSize ?
+        (TotalSize + MigrationChunkSize - 1) / MigrationChunkSize : 1;
 
     auto Lock = g_Platform->GetTaskPoolLock();
+    for (UINT64 Chunk = 0; Chunk < NumChunks; ++Chunk)
+    {
+        const UINT64 Offset = Chunk * MigrationChunkSize;
+        const UINT64 Size = std::min(MigrationChunkSize, TotalSize - Offset);
+        std::unique_ptr<Task> CopyToCrossAdapter(new CopyCrossAdapter(
+            triggeringTask->m_Parent.get(), *this, Staging.Source, *m_CurrentActiveDevice, true, true, Offset, Offset, Size));
+        std::unique_ptr<Task> CopyFromCrossAdapter(new CopyCrossAdapter(
+            triggeringTask->m_Parent.get(), *this, Staging.Dest, *newDevice, false, true, Offset, Offset, Size));
+
+        cl_event e = CopyToCrossAdapter.get();
+        CopyFromCrossAdapter->AddDependencies(&e, 1, Lock);
+        m_CurrentActiveDevice->SubmitTask(CopyToCrossAdapter.get(), Lock);
+        CopyToCrossAdapter->Release();
+        CopyToCrossAdapter.release();
+        if (NumChunks > 1)
+        {
+            // A submission boundary per chunk: completing this submission's
+            // fence is what unblocks the matching destination-side copy.
+            m_CurrentActiveDevice->Flush(Lock);
+        }
 
-    cl_event e = CopyToCrossAdapter.get();
-    CopyFromCrossAdapter->AddDependencies(&e, 1, Lock);
-    m_CurrentActiveDevice->SubmitTask(CopyToCrossAdapter.get(), Lock);
-    CopyToCrossAdapter->Release();
-    CopyToCrossAdapter.release();
-
-    e = CopyFromCrossAdapter.get();
-    triggeringTask->AddDependencies(&e, 1, Lock);
-    newDevice->SubmitTask(CopyFromCrossAdapter.get(), Lock);
-    CopyFromCrossAdapter->Release();
-    CopyFromCrossAdapter.release();
+        e = CopyFromCrossAdapter.get();
+        triggeringTask->AddDependencies(&e, 1, Lock);
+        newDevice->SubmitTask(CopyFromCrossAdapter.get(), Lock);
+        CopyFromCrossAdapter->Release();
+        CopyFromCrossAdapter.release();
+    }
 
     m_CurrentActiveDevice->Flush(Lock);
 }
@@ -189,16 +374,136 @@ public:
     }
 };
 
+// Coalesces buffer initial data from many resources into one task: the data
+// is packed into large shared upload-heap segments and copied out with
+// grouped CopyBufferRegion calls when the task records. Model loaders that
+// create thousands of CL_MEM_COPY_HOST_PTR buffers otherwise pay a task,
+// staging allocation, and submission per buffer.
+class BatchedUploadTask : public Task
+{
+    struct Entry
+    {
+        Resource::ref_ptr_int Res;
+        std::unique_ptr<byte[]> Data;
+        UINT64 Size;
+    };
+    std::vector<Entry> m_Entries;
+    // Kept alive until OnComplete; the copies read from them on the GPU.
+    std::vector<ComPtr<ID3D12Resource>> m_UploadSegments;
+
+public:
+    BatchedUploadTask(Context& Context, D3DDevice& Device)
+        : Task(Context, Device)
+    {
+    }
+
+    // Takes ownership of the resource's initial data. Only called under the
+    // task pool lock, while this task still sits in the recording submission.
+    void AddEntry(Resource& res, Task& triggeringTask, TaskPoolLock const&)
+    {
+        // Submission order already sequences the copies ahead of the
+        // triggering task, so no forward edge - it must not wait on this
+        // batch's fence to become ready. The waiter edge is what carries
+        // errors: if this batch's record fails, Complete fails the
+        // triggering task instead of letting it run against an
+        // uninitialized buffer with an event that reports success.
+        m_TasksWaitingOnThis.insert(&triggeringTask);
+        m_Entries.push_back({ Resource::ref_ptr_int(&res), std::move(res.m_InitialData), res.m_Desc.image_width });
+    }
+
+    void MigrateResources() final {}
+    void RecordImpl() final
+    {
+        auto& Ctx = m_D3DDevice->ImmCtx();
+        for (auto& entry : m_Entries)
+        {
+            Ctx.GetResourceStateManager().TransitionResource(
+                entry.Res->GetUnderlyingResource(m_D3DDevice), D3D12_RESOURCE_STATE_COPY_DEST);
+        }
+        Ctx.GetResourceStateManager().ApplyAllResourceTransitions();
+
+        // Pack entries into upload segments of bounded size so one giant
+        // model doesn't demand a single giant allocation.
+        constexpr UINT64 MaxSegmentSize = 64 * 1024 * 1024;
+        for (size_t First = 0; First < m_Entries.size(); )
+        {
+            UINT64 SegmentSize = 0;
+            size_t End = First;
+            do
+            {
+                SegmentSize += m_Entries[End].Size;
+                ++End;
+            } while (End < m_Entries.size() && SegmentSize + m_Entries[End].Size <= MaxSegmentSize);
+
+            auto HeapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+            auto BufferDesc = CD3DX12_RESOURCE_DESC::Buffer(SegmentSize);
+            ComPtr<ID3D12Resource> Segment;
+            D3D12TranslationLayer::ThrowFailure(m_D3DDevice->GetDevice()->CreateCommittedResource(
+                &HeapProps, D3D12_HEAP_FLAG_NONE, &BufferDesc,
+                D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&Segment)));
+
+            void* pMapped = nullptr;
+            constexpr D3D12_RANGE EmptyRange = {};
+            D3D12TranslationLayer::ThrowFailure(Segment->Map(0, &EmptyRange, &pMapped));
+            UINT64 Offset = 0;
+            for (size_t i = First; i < End; ++i)
+            {
+                auto& entry = m_Entries[i];
+                memcpy(static_cast<byte*>(pMapped) + Offset, entry.Data.get(), entry.Size);
+                Ctx.GetGraphicsCommandList()->CopyBufferRegion(
+                    entry.Res->GetUnderlyingResource(m_D3DDevice)->GetUnderlyingResource(), entry.Res->m_Offset,
+                    Segment.Get(), Offset, entry.Size);
+                Offset += entry.Size;
+                entry.Data.reset();
+            }
+            Segment->Unmap(0, nullptr);
+            m_UploadSegments.push_back(std::move(Segment));
+            First = End;
+        }
+        Ctx.AdditionalCommandsAdded();
+    }
+    void OnComplete() final
+    {
+        m_Entries.clear();
+        m_UploadSegments.clear();
+    }
+};
+
 void Resource::UploadInitialData(Task* triggeringTask)
 {
     if (!m_InitialData)
         return;
 
+    auto Lock = g_Platform->GetTaskPoolLock();
+
+    if (m_Desc.image_type == CL_MEM_OBJECT_BUFFER)
+    {
+        // Buffers batch into one upload task per submission. The batch task
+        // is submitted (and so pushed into the recording submission) before
+        // any task that triggers an upload is, which is all the ordering the
+        // single per-device queue needs - no forward dependency or flush.
+        // AddEntry registers the triggering task as a waiter on the batch so
+        // an upload failure still propagates to it.
+        auto batch = m_CurrentActiveDevice->GetPendingUploadBatch(Lock);
+        if (!batch)
+        {
+            std::unique_ptr<BatchedUploadTask> NewBatch(new BatchedUploadTask(
+                m_Parent.get(), *m_CurrentActiveDevice));
+            batch = NewBatch.get();
+            m_CurrentActiveDevice->SubmitTask(batch, Lock);
+            m_CurrentActiveDevice->SetPendingUploadBatch(batch, Lock);
+            batch->Release();
+            NewBatch.release();
+        }
+        batch->AddEntry(*this, *triggeringTask, Lock);
+        return;
+    }
+
+    // Images keep the per-resource path: their upload goes through
+    // UpdateSubresources, which handles subresource footprints.
     std::unique_ptr<Task> UploadTask(new ::UploadInitialData(
         m_Parent.get(), *this, *m_CurrentActiveDevice));
 
-    auto Lock = g_Platform->GetTaskPoolLock();
-
     cl_event e = UploadTask.get();
     triggeringTask->AddDependencies(&e, 1, Lock);
     m_CurrentActiveDevice->SubmitTask(UploadTask.get(), Lock);
@@ -264,6 +569,17 @@ clEnqueueMigrateMemObjects(cl_command_queue       command_queue,
         task->AddDependencies(event_wait_list, num_events_in_wait_list, Lock);
         queue.QueueTask(task.get(), Lock);
 
+        // Content-preserving migrations are prefetch hints: flush so the
+        // cross-adapter copies start now, while the app is still enqueueing
+        // the work that needs the data, instead of parking the task until
+        // the next flush - at which point the copies would record directly
+        // in front of that work and hide nothing. Content-undefined
+        // migrations move no data, so they keep the normal batching.
+        if ((flags & CL_MIGRATE_MEM_OBJECT_CONTENT_UNDEFINED) == 0)
+        {
+            queue.Flush(Lock, /* flushDevice */ true);
+        }
+
         // No more exceptions
         if (event)
             *event = task.release();
@@ -3,9 +3,13 @@
 #include "task.hpp"
 #include "queue.hpp"
 #include "resources.hpp"
+#include "kernel.hpp"
 #include "formats.hpp"
 #include <variant>
 #include <wil/resource.h>
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#endif
 
 #include "FormatDesc.hpp"
 #include "ImmediateContext.inl"
@@ -150,6 +154,8 @@ private:
     const Args m_Args;
 
     void CopyFromHostPtr(UpdateSubresourcesFlags);
+    bool UseGpuFillPath() const;
+    void RecordGpuFill();
     std::vector<CPrepareUpdateSubresourcesHelper> m_Helpers;
 
     void MigrateResources() final
@@ -170,22 +176,112 @@ MemWriteFillTask::MemWriteFillTask(Context &Parent, Resource &Target,
     , m_Target(&Target)
     , m_Args(args)
 {
-    if (!DeferCopy)
+    if (!DeferCopy && !UseGpuFillPath())
     {
         CopyFromHostPtr(UpdateSubresourcesFlags::ScenarioBatchedContext);
     }
 }
 
+// Buffer fills larger than this are done by expanding the pattern into a single
+// seed chunk and stamping it across the destination with GPU buffer copies,
+// instead of expanding the entire fill on the CPU and pushing it all through
+// the upload heap.
+constexpr UINT64 GpuFillSeedChunkSize = 65536;
+
+bool MemWriteFillTask::UseGpuFillPath() const
+{
+    return m_Args.Data.index() == 1 &&
+        m_Target->m_Desc.image_type == CL_MEM_OBJECT_BUFFER &&
+        m_Args.Width > GpuFillSeedChunkSize;
+}
+
+void MemWriteFillTask::RecordGpuFill()
+{
+    auto& Device = m_CommandQueue->GetD3DDevice();
+    auto& ImmCtx = Device.ImmCtx();
+    FillData const& FillArgs = std::get<1>(m_Args.Data);
+
+    const UINT64 FillSize = m_Args.Width;
+    // Bound the number of copy commands for very large fills by growing the
+    // seed chunk. The chunk stays a multiple of the (power-of-two) pattern
+    // size so every stamp continues the pattern where the last one left off.
+    UINT64 ChunkSize = std::min(FillSize, std::max<UINT64>(GpuFillSeedChunkSize, FillSize / 256));
+    ChunkSize -= ChunkSize % FillArgs.PatternSize;
+
+    auto UploadHeap = ImmCtx.AcquireSuballocatedHeap(
+        D3D12TranslationLayer::AllocatorHeapType::Upload, ChunkSize,
+        D3D12TranslationLayer::ResourceAllocationContext::ImmediateContextThreadTemporary); // throw( _com_error )
+
+    void* pMapped;
+    CD3DX12_RANGE ReadRange(0, 0);
+    D3D12TranslationLayer::ThrowFailure(UploadHeap.Map(0, &ReadRange, &pMapped)); // throw( _com_error )
+    // Expand the pattern by doubling in cacheable memory, then push the seed
+    // chunk into the write-combined upload heap with one large copy instead of
+    // one tiny memcpy per pattern repeat.
+    std::vector<char> Seed(ChunkSize);
+    memcpy(Seed.data(), FillArgs.Pattern, FillArgs.PatternSize);
+    for (UINT64 Filled = FillArgs.PatternSize; Filled < ChunkSize; Filled *= 2)
+    {
+        memcpy(Seed.data() + Filled, Seed.data(), std::min(Filled, ChunkSize - Filled));
+    }
+    memcpy(pMapped, Seed.data(), ChunkSize);
+    CD3DX12_RANGE WrittenRange(0, (SIZE_T)ChunkSize);
+    UploadHeap.Unmap(0, &WrittenRange);
+
+    auto* Target = m_Target->GetUnderlyingResource(&Device);
+    ImmCtx.GetResourceStateManager().TransitionResource(Target, D3D12_RESOURCE_STATE_COPY_DEST);
+    ImmCtx.GetResourceStateManager().ApplyAllResourceTransitions();
+
+    // m_Args.DstX already includes the buffer suballocation offset.
+    ID3D12Resource* pTargetResource = Target->GetUnderlyingResource();
+    for (UINT64 Offset = 0; Offset < FillSize; Offset += ChunkSize)
+    {
+        ImmCtx.GetGraphicsCommandList()->CopyBufferRegion(
+            pTargetResource, m_Args.DstX + Offset,
+            UploadHeap.GetResource(), UploadHeap.GetOffset(),
+            std::min(ChunkSize, FillSize - Offset));
+    }
+    ImmCtx.AdditionalCommandsAdded();
+    ImmCtx.ReleaseSuballocatedHeap(
+        D3D12TranslationLayer::AllocatorHeapType::Upload, UploadHeap, ImmCtx.GetCommandListID());
+}
+
 void MemWriteFillTask::CopyFromHostPtr(UpdateSubresourcesFlags flags)
 {
-    // For buffer rects, have to use row-by-row copies if the pitches don't align to
-    // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT.
-    // TODO: Add a path that uses CopyTextureRegion if it does align.
-    
+    // Buffer rects are copied row-by-row: D3D12 has no strided buffer copy,
+    // and CopyTextureRegion can't have a buffer on both ends. Every row costs
+    // its own upload allocation and GPU copy, so when consecutive rows (and
+    // slices) are contiguous in both the host layout and the buffer layout,
+    // batch them into one copy - a tightly packed rect write becomes a single
+    // upload. Texture writes don't need this: the translation layer already
+    // collapses to one bulk copy when the host pitch matches the placement
+    // footprint, followed by a single CopyTextureRegion.
     const bool bIsRowByRowCopy = m_Target->m_Desc.image_type == CL_MEM_OBJECT_BUFFER;
     UINT NumRowCopies = bIsRowByRowCopy ? m_Args.Height : 1;
     UINT NumSliceCopies = bIsRowByRowCopy ? m_Args.Depth : 1;
 
+    UINT64 BytesPerCopy = m_Args.Width;
+    if (bIsRowByRowCopy && m_Args.Data.index() == 0)
+    {
+        WriteData const &WriteArgs = std::get<0>(m_Args.Data);
+        if (NumRowCopies > 1 &&
+            m_Args.DstBufferRowPitch == m_Args.Width &&
+            WriteArgs.RowPitch == m_Args.Width &&
+            BytesPerCopy * NumRowCopies <= UINT_MAX)
+        {
+            BytesPerCopy *= NumRowCopies;
+            NumRowCopies = 1;
+        }
+        if (NumSliceCopies > 1 && NumRowCopies == 1 &&
+            m_Args.DstBufferSlicePitch == BytesPerCopy &&
+            WriteArgs.SlicePitch == BytesPerCopy &&
+            BytesPerCopy * NumSliceCopies <= UINT_MAX)
+        {
+            BytesPerCopy *= NumSliceCopies;
+            NumSliceCopies = 1;
+        }
+    }
+
     D3D12TranslationLayer::CSubresourceSubset subresources =
         m_Target->GetUnderlyingResource(&m_CommandQueue->GetD3DDevice())->GetFullSubresourceSubset();
     const cl_uint FormatBytes = GetFormatSizeBytes(m_Target->m_Format);
@@ -240,7 +336,7 @@ void MemWriteFillTask::CopyFromHostPtr(UpdateSubresourcesFlags flags)
                         ((z + m_Args.DstZ) * m_Args.DstBufferSlicePitch) + // Slice offset
                         ((y + m_Args.DstY) * m_Args.DstBufferRowPitch) + // Row offset
                         m_Args.DstX); // Offset within row
-                    DstBox.right = DstBox.left + m_Args.Width;
+                    DstBox.right = DstBox.left + (UINT)BytesPerCopy;
                 }
                 m_Helpers.emplace_back(
                     *m_Target->GetUnderlyingResource(&m_CommandQueue->GetD3DDevice()),
@@ -259,6 +355,12 @@ void MemWriteFillTask::CopyFromHostPtr(UpdateSubresourcesFlags flags)
 
 void MemWriteFillTask::RecordImpl()
 {
+    if (UseGpuFillPath())
+    {
+        RecordGpuFill();
+        return;
+    }
+
     if (m_Helpers.empty())
     {
         CopyFromHostPtr(UpdateSubresourcesFlags::ScenarioImmediateContext);
@@ -874,6 +976,70 @@ clEnqueueFillImage(cl_command_queue   command_queue,
     return CL_SUCCESS;
 }
 
+#if defined(_M_IX86) || defined(_M_X64)
+// True when the CPU supports SSE4.1's MOVNTDQA streaming load.
+static bool SupportsStreamingLoads()
+{
+    static const bool bSupported = []()
+    {
+        int CpuInfo[4];
+        __cpuid(CpuInfo, 1);
+        return (CpuInfo[2] & (1 << 19)) != 0; // SSE4.1
+    }();
+    return bSupported;
+}
+
+// Copies out of write-combined memory into cached memory. Ordinary loads
+// from a write-combined page bypass the cache and issue one uncached bus
+// transaction each, so a plain memcpy out of an ALLOC_HOST_PTR heap runs at
+// a small fraction of memory bandwidth; MOVNTDQA fills a whole streaming
+// line buffer per transaction instead. Falls back to memcpy on CPUs without
+// SSE4.1 - the sources here are readable either way, just slowly.
+static void StreamingLoadCopy(void* pDst, void const* pSrc, size_t Size)
+{
+    if (!SupportsStreamingLoads())
+    {
+        memcpy(pDst, pSrc, Size);
+        return;
+    }
+    auto pSrcBytes = static_cast<byte const*>(pSrc);
+    auto pDstBytes = static_cast<byte*>(pDst);
+    if (size_t Misalignment = reinterpret_cast<uintptr_t>(pSrcBytes) & 15)
+    {
+        size_t HeadSize = std::min<size_t>(16 - Misalignment, Size);
+        memcpy(pDstBytes, pSrcBytes, HeadSize);
+        pSrcBytes += HeadSize;
+        pDstBytes += HeadSize;
+        Size -= HeadSize;
+    }
+    // Four loads per iteration keeps all of the CPU's streaming line
+    // buffers in flight.
+    auto pSrcVec = reinterpret_cast<__m128i const*>(pSrcBytes);
+    for (; Size >= 64; Size -= 64, pSrcVec += 4, pDstBytes += 64)
+    {
+        __m128i v0 = _mm_stream_load_si128(const_cast<__m128i*>(pSrcVec + 0));
+        __m128i v1 = _mm_stream_load_si128(const_cast<__m128i*>(pSrcVec + 1));
+        __m128i v2 = _mm_stream_load_si128(const_cast<__m128i*>(pSrcVec + 2));
+        __m128i v3 = _mm_stream_load_si128(const_cast<__m128i*>(pSrcVec + 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDstBytes) + 0, v0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDstBytes) + 1, v1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDstBytes) + 2, v2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDstBytes) + 3, v3);
+    }
+    for (; Size >= 16; Size -= 16, pSrcVec += 1, pDstBytes += 16)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDstBytes),
+            _mm_stream_load_si128(const_cast<__m128i*>(pSrcVec)));
+    }
+    memcpy(pDstBytes, pSrcVec, Size);
+}
+#else
+static void StreamingLoadCopy(void* pDst, void const* pSrc, size_t Size)
+{
+    memcpy(pDst, pSrc, Size);
+}
+#endif
+
 class MemReadTask : public Task
 {
 public:
@@ -910,7 +1076,14 @@ public:
 private:
     Resource::ref_ptr_int m_Source;
     const Args m_Args;
-    
+
+    // Set when the read was recorded as a GPU copy straight into the user
+    // pointer; they keep the wrapped allocation alive until the fence that
+    // covers the copy has signaled (OnComplete).
+    ComPtr<ID3D12Heap> m_DirectReadbackHeap;
+    ComPtr<ID3D12Resource> m_DirectReadbackBuffer;
+
+    bool TryRecordDirectReadback();
     void RecordViaCopy();
 
     void MigrateResources() final
@@ -920,6 +1093,8 @@ private:
     void RecordImpl() final;
     void OnComplete() final
     {
+        m_DirectReadbackBuffer.Reset();
+        m_DirectReadbackHeap.Reset();
         m_Source.Release();
     }
 };
@@ -928,6 +1103,9 @@ void MemReadTask::CopyBits(void* pData, int Subresource, size_t SrcRowPitch, siz
 {
     const char *pSrc = reinterpret_cast<char*>(pData) + Subresource * SrcSlicePitch;
     const cl_uint FormatBytes = GetFormatSizeBytes(m_Source->m_Format);
+    // ALLOC_HOST_PTR resources are mapped from their write-combined heap;
+    // plain loads there are uncached, so pull those rows with streaming loads.
+    const bool bWriteCombinedSource = (m_Source->m_Flags & CL_MEM_ALLOC_HOST_PTR) != 0;
     if (m_Args.DstZ != 0 || m_Args.DstY != 0 || m_Args.DstX != 0)
     {
         for (cl_uint z = 0; z < m_Args.Depth; ++z)
@@ -942,7 +1120,31 @@ void MemReadTask::CopyBits(void* pData, int Subresource, size_t SrcRowPitch, siz
                     (z + m_Args.SrcZ) * SrcSlicePitch +
                     (y + m_Args.SrcY) * SrcRowPitch +
                     m_Args.SrcX * FormatBytes;
-                memcpy(pDest, pRowSrc, m_Args.Width * FormatBytes);
+                if (bWriteCombinedSource)
+                {
+                    StreamingLoadCopy(pDest, pRowSrc, m_Args.Width * FormatBytes);
+                }
+                else
+                {
+                    memcpy(pDest, pRowSrc, m_Args.Width * FormatBytes);
+                }
+            }
+        }
+    }
+    else if (bWriteCombinedSource)
+    {
+        // Same geometry as the MemcpySubresource path below, row by row
+        // through the streaming copy.
+        for (cl_uint z = 0; z < m_Args.Depth; ++z)
+        {
+            for (cl_uint y = 0; y < m_Args.Height; ++y)
+            {
+                char* pDest = reinterpret_cast<char*>(m_Args.pData) +
+                    (z + Subresource + m_Args.DstZ) * m_Args.DstSlicePitch +
+                    y * m_Args.DstRowPitch;
+                StreamingLoadCopy(pDest,
+                    pSrc + z * SrcSlicePitch + y * SrcRowPitch,
+                    m_Args.Width * FormatBytes);
             }
         }
     }
@@ -956,8 +1158,73 @@ void MemReadTask::CopyBits(void* pData, int Subresource, size_t SrcRowPitch, siz
     }
 }
 
+// Reads below this size aren't worth a heap open plus a placed resource; the
+// staging memcpy only becomes the bottleneck on large results.
+constexpr UINT64 DirectReadbackThresholdBytes = 1024 * 1024;
+
+// Large linear buffer reads can skip the staging pass entirely: wrap the user
+// allocation as a D3D12 heap with OpenExistingHeapFromAddress and let the GPU
+// copy land directly in the application buffer. The wrap only works when the
+// pointer is the 64KB-aligned base of a virtual allocation (big allocations
+// from the CRT heap are), so any failure just falls back to the staging path.
+bool MemReadTask::TryRecordDirectReadback()
+{
+    if (m_Source->m_Desc.image_type != CL_MEM_OBJECT_BUFFER ||
+        m_Args.Height != 1 || m_Args.Depth != 1 || m_Args.NumArraySlices != 1 ||
+        m_Args.DstX != 0 || m_Args.DstY != 0 || m_Args.DstZ != 0 ||
+        m_Args.Width < DirectReadbackThresholdBytes ||
+        (reinterpret_cast<uintptr_t>(m_Args.pData) & 0xFFFF) != 0)
+    {
+        return false;
+    }
+
+    auto& Device = m_CommandQueue->GetD3DDevice();
+    ComPtr<ID3D12Device3> spDevice3;
+    D3D12_FEATURE_DATA_EXISTING_HEAPS ExistingHeaps = {};
+    if (FAILED(Device.GetDevice()->QueryInterface(IID_PPV_ARGS(&spDevice3))) ||
+        FAILED(Device.GetDevice()->CheckFeatureSupport(
+            D3D12_FEATURE_EXISTING_HEAPS, &ExistingHeaps, sizeof(ExistingHeaps))) ||
+        !ExistingHeaps.Supported)
+    {
+        return false;
+    }
+
+    if (FAILED(spDevice3->OpenExistingHeapFromAddress(m_Args.pData, IID_PPV_ARGS(&m_DirectReadbackHeap))))
+    {
+        return false;
+    }
+    D3D12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Buffer(m_Args.Width);
+    if (FAILED(spDevice3->CreatePlacedResource(m_DirectReadbackHeap.Get(), 0, &Desc,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&m_DirectReadbackBuffer))))
+    {
+        // E.g. the heap covers less than the requested width.
+        m_DirectReadbackHeap.Reset();
+        return false;
+    }
+
+    auto& ImmCtx = Device.ImmCtx();
+    auto* Source = m_Source->GetUnderlyingResource(&Device);
+    ImmCtx.GetResourceStateManager().TransitionResource(Source, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    ImmCtx.GetResourceStateManager().ApplyAllResourceTransitions();
+    ImmCtx.GetGraphicsCommandList()->CopyBufferRegion(
+        m_DirectReadbackBuffer.Get(), 0,
+        Source->GetUnderlyingResource(),
+        m_Source->m_Offset + m_Args.SrcX, m_Args.Width);
+    ImmCtx.AdditionalCommandsAdded();
+    // The copy is the source's last use here, and the usual pattern is a
+    // dispatch output read back between iterations - the next use wants UAV.
+    // Begin the transition now so it overlaps with work recorded in between.
+    ImmCtx.GetResourceStateManager().BeginTransition(Source, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    return true;
+}
+
 void MemReadTask::RecordImpl()
 {
+    if (TryRecordDirectReadback())
+    {
+        return;
+    }
+
     if (!(m_Source->m_Flags & CL_MEM_ALLOC_HOST_PTR))
     {
         RecordViaCopy();
@@ -1378,13 +1645,53 @@ public:
         , m_Source(&Source)
         , m_Dest(&Dest)
         , m_Args(args)
+        , m_CoalescedWidth(args.Width)
+    {
+    }
+
+    CopyResourceTask* AsBufferCopy() final
+    {
+        return (m_CommandType == CL_COMMAND_COPY_BUFFER &&
+                m_Source->m_Desc.image_type == CL_MEM_OBJECT_BUFFER &&
+                m_Dest->m_Desc.image_type == CL_MEM_OBJECT_BUFFER) ? this : nullptr;
+    }
+
+    // Absorbs next into this copy when it extends this one's ranges
+    // contiguously in both buffers (offsets here are absolute - they already
+    // include any sub-buffer offset). The absorbed task records nothing but
+    // still flows through the task machinery, so event order and completion
+    // are unchanged. Same-or-related buffers are excluded: the per-enqueue
+    // overlap validation doesn't cover merged ranges.
+    bool TryCoalesce(CopyResourceTask& next)
     {
+        if (m_Coalesced || next.m_Coalesced ||
+            next.m_Source.Get() != m_Source.Get() ||
+            next.m_Dest.Get() != m_Dest.Get() ||
+            m_Source.Get() == m_Dest.Get() ||
+            m_Source->m_ParentBuffer.Get() == m_Dest.Get() ||
+            m_Dest->m_ParentBuffer.Get() == m_Source.Get() ||
+            (m_Source->m_ParentBuffer.Get() &&
+             m_Source->m_ParentBuffer.Get() == m_Dest->m_ParentBuffer.Get()) ||
+            next.m_Args.SrcX != m_Args.SrcX + m_CoalescedWidth ||
+            next.m_Args.DstX != m_Args.DstX + m_CoalescedWidth)
+        {
+            return false;
+        }
+        m_CoalescedWidth += next.m_Args.Width;
+        next.m_Coalesced = true;
+        return true;
     }
 
 private:
     Resource::ref_ptr_int m_Source;
     Resource::ref_ptr_int m_Dest;
     const Args m_Args;
+    // Flush-time coalescing (CommandQueue::CoalesceQueuedCopies): this copy's
+    // width after absorbing contiguous successors, and whether this task's own
+    // copy was absorbed into a predecessor. Buffer copies only; for everything
+    // else m_CoalescedWidth just mirrors m_Args.Width.
+    cl_uint m_CoalescedWidth;
+    bool m_Coalesced = false;
 
     static constexpr bool ImageTypesCopyCompatible(cl_mem_object_type a, cl_mem_object_type b)
     {
@@ -1407,6 +1714,11 @@ private:
     }
     void RecordImpl() final
     {
+        if (m_Coalesced)
+        {
+            // A predecessor's copy already covers this range.
+            return;
+        }
         auto& ImmCtx = m_CommandQueue->GetD3DDevice().ImmCtx();
         if (ImageTypesCopyCompatible(m_Source->m_Desc.image_type, m_Dest->m_Desc.image_type))
         {
@@ -1417,7 +1729,7 @@ private:
                     m_Args.SrcX,
                     m_Args.SrcY,
                     m_Args.SrcZ,
-                    m_Args.SrcX + m_Args.Width,
+                    m_Args.SrcX + m_CoalescedWidth,
                     m_Args.SrcY + m_Args.Height,
                     m_Args.SrcZ + m_Args.Depth
                 };
@@ -1500,6 +1812,13 @@ private:
     }
 };
 
+bool TryCoalesceBufferCopies(Task& head, Task& next)
+{
+    CopyResourceTask* headCopy = head.AsBufferCopy();
+    CopyResourceTask* nextCopy = next.AsBufferCopy();
+    return headCopy && nextCopy && headCopy->TryCoalesce(*nextCopy);
+}
+
 extern CL_API_ENTRY cl_int CL_API_CALL
 clEnqueueCopyBuffer(cl_command_queue    command_queue,
     cl_mem              src_buffer,
@@ -1717,6 +2036,7 @@ public:
         , m_Dest(&Dest)
         , m_Args(args)
     {
+        TryCreateRepackTask(Source, Dest);
     }
 
 private:
@@ -1724,6 +2044,14 @@ private:
     Resource::ref_ptr_int m_Dest;
     const Args m_Args;
 
+    // When set, RecordImpl records this internal compute dispatch (one of the
+    // queue's repack kernels, see CommandQueue::GetRepackKernel) instead of
+    // the per-row copy loop, which issues Height * Depth CopyBufferRegions.
+    // Left null for small rects or when the repack kernels are unavailable.
+    std::unique_ptr<Task> m_RepackTask;
+    static constexpr cl_uint RepackRowThreshold = 8;
+    void TryCreateRepackTask(Resource& Source, Resource& Dest);
+
     void MigrateResources() final
     {
         m_Source->EnqueueMigrateResource(&m_CommandQueue->GetD3DDevice(), this, 0);
@@ -1737,8 +2065,144 @@ private:
     }
 };
 
+// OpenCL C source for the internal buffer-rect repack kernels. Buffer <->
+// buffer and buffer <-> image rect copies never convert: the bytes are
+// already laid out in the destination's element format, so a plain
+// byte-granularity (or dword-granularity, when every offset and pitch
+// allows) gather/scatter is all that's needed, and one generic kernel pair
+// covers every format in formats.hpp. Offsets and pitches are passed in
+// elements of the kernel's access width.
+static const char g_RepackKernelSource[] = R"(
+kernel void clon12_repack_u8(global const uchar *src, global uchar *dst,
+    uint count, uint src_base, uint src_row, uint src_slice,
+    uint dst_base, uint dst_row, uint dst_slice)
+{
+    uint x = get_global_id(0);
+    uint y = get_global_id(1);
+    uint z = get_global_id(2);
+    if (x < count)
+        dst[dst_base + z * dst_slice + y * dst_row + x] =
+            src[src_base + z * src_slice + y * src_row + x];
+}
+kernel void clon12_repack_u32(global const uint *src, global uint *dst,
+    uint count, uint src_base, uint src_row, uint src_slice,
+    uint dst_base, uint dst_row, uint dst_slice)
+{
+    uint x = get_global_id(0);
+    uint y = get_global_id(1);
+    uint z = get_global_id(2);
+    if (x < count)
+        dst[dst_base + z * dst_slice + y * dst_row + x] =
+            src[src_base + z * src_slice + y * src_row + x];
+}
+)";
+
+Kernel *CommandQueue::GetRepackKernel(bool bDwordGranularity)
+{
+    std::lock_guard Lock(m_RepackKernelLock);
+    if (!m_RepackBuildAttempted)
+    {
+        m_RepackBuildAttempted = true;
+        try
+        {
+            ::ref_ptr<Program> program(new Program(GetContext(), std::string(g_RepackKernelSource)), adopt_ref{});
+            std::vector<D3DDeviceAndRef> devices;
+            devices.emplace_back(&GetDevice(), &GetD3DDevice());
+            if (program->Build(std::move(devices), "", nullptr, nullptr) == CL_SUCCESS)
+            {
+                m_RepackKernels[0].Attach(static_cast<Kernel*>(clCreateKernel(program.Get(), "clon12_repack_u8", nullptr)));
+                m_RepackKernels[1].Attach(static_cast<Kernel*>(clCreateKernel(program.Get(), "clon12_repack_u32", nullptr)));
+                m_RepackProgram = std::move(program);
+            }
+        }
+        catch (...)
+        {
+            // Leave the kernels null; rect copies keep the per-row loop.
+        }
+    }
+    return m_RepackKernels[bDwordGranularity ? 1 : 0].Get();
+}
+
+void CopyBufferRectTask::TryCreateRepackTask(Resource& Source, Resource& Dest)
+{
+    if (m_Args.Width == 0 ||
+        (size_t)m_Args.Height * m_Args.Depth < RepackRowThreshold)
+    {
+        return;
+    }
+    const cl_uint SrcBase = m_Args.SrcOffset + m_Args.SrcZ * m_Args.SrcBufferSlicePitch +
+        m_Args.SrcY * m_Args.SrcBufferRowPitch + m_Args.SrcX;
+    const cl_uint DstBase = m_Args.DstOffset + m_Args.DstZ * m_Args.DstBufferSlicePitch +
+        m_Args.DstY * m_Args.DstBufferRowPitch + m_Args.DstX;
+    const bool bDwords = (SrcBase | DstBase | m_Args.Width |
+        m_Args.SrcBufferRowPitch | m_Args.SrcBufferSlicePitch |
+        m_Args.DstBufferRowPitch | m_Args.DstBufferSlicePitch) % 4 == 0;
+    Kernel* pBaseKernel = m_CommandQueue->GetRepackKernel(bDwords);
+    if (!pBaseKernel)
+    {
+        return;
+    }
+    try
+    {
+        const cl_uint Shift = bDwords ? 2 : 0;
+        ::ref_ptr<Kernel> kernel(new Kernel(*pBaseKernel), adopt_ref{});
+        // The UAVs bound for buffer arguments already account for sub-buffer
+        // and slab offsets, so unlike the per-row loop below, the kernel
+        // offsets must not include Resource::m_Offset.
+        cl_mem Src = &Source;
+        cl_mem Dst = &Dest;
+        const cl_uint ScalarArgs[] =
+        {
+            m_Args.Width >> Shift,
+            SrcBase >> Shift,
+            m_Args.SrcBufferRowPitch >> Shift,
+            m_Args.SrcBufferSlicePitch >> Shift,
+            DstBase >> Shift,
+            m_Args.DstBufferRowPitch >> Shift,
+            m_Args.DstBufferSlicePitch >> Shift,
+        };
+        if (kernel->SetArg(0, sizeof(Src), &Src) != CL_SUCCESS ||
+            kernel->SetArg(1, sizeof(Dst), &Dst) != CL_SUCCESS)
+        {
+            return;
+        }
+        for (cl_uint i = 0; i < _countof(ScalarArgs); ++i)
+        {
+            if (kernel->SetArg(i + 2, sizeof(cl_uint), &ScalarArgs[i]) != CL_SUCCESS)
+            {
+                return;
+            }
+        }
+        constexpr cl_uint ThreadsPerGroup = 64;
+        std::array<uint32_t, 3> Groups =
+        {
+            ((m_Args.Width >> Shift) + ThreadsPerGroup - 1) / ThreadsPerGroup,
+            m_Args.Height,
+            m_Args.Depth
+        };
+        std::array<uint16_t, 3> LocalSize = { ThreadsPerGroup, 1, 1 };
+        m_RepackTask = CreateExecuteKernelTask(*kernel, m_CommandQueue.Get(), Groups, LocalSize, 3);
+    }
+    catch (...)
+    {
+        m_RepackTask.reset();
+    }
+}
+
 void CopyBufferRectTask::RecordImpl()
 {
+    if (m_RepackTask)
+    {
+        // The nested dispatch can only throw before it records any commands
+        // (kernel specialization failure), so the per-row loop below remains
+        // a safe fallback.
+        try
+        {
+            m_RepackTask->Record();
+            return;
+        }
+        catch (...) {}
+    }
     // TODO: Fast-path when pitches line up with D3D12 buffer-as-texture support, and not same-resource copy
     /*
     if (m_Source->GetUnderlyingResource() != m_Dest->GetUnderlyingResource() &&
@@ -2437,6 +2901,30 @@ private:
             ReadArgs.DstSlicePitch = (cl_uint)m_Resource.m_Desc.image_slice_pitch;
             MemReadTask(m_Parent.get(), m_Resource, CL_COMMAND_READ_BUFFER, m_CommandQueue.Get(), ReadArgs).Record();
         }
+
+        // The readback just left host memory equal to the device copy, so a
+        // snapshot taken now lets Unmap upload only the ranges the app
+        // actually touched. Physics-style apps map hundreds of MB and write a
+        // few KB per frame; diffing at memory speed beats pushing the whole
+        // region through the upload heap. Writable buffer maps only, and only
+        // when the region is big enough for the diff to pay for the snapshot.
+        // On allocation failure Unmap just writes the full region as before.
+        // CLON12_MAP_DIFF=0 disables.
+        if ((m_MapFlags & CL_MAP_WRITE) &&
+            m_Resource.m_Desc.image_type == CL_MEM_OBJECT_BUFFER &&
+            m_Args.Width >= SnapshotThresholdBytes &&
+            GetMapDiffEnabled())
+        {
+            try
+            {
+                m_Snapshot.reset(new byte[m_Args.Width]);
+                memcpy(m_Snapshot.get(), m_Pointer, m_Args.Width);
+            }
+            catch (std::bad_alloc&)
+            {
+                m_Snapshot.reset();
+            }
+        }
     }
     void Unmap(bool IsResourceBeingDestroyed) final
     {
@@ -2445,6 +2933,11 @@ private:
         // B) The task would add-ref the resource, which would result in a double-delete
         if ((m_MapFlags & CL_MAP_WRITE) && !IsResourceBeingDestroyed)
         {
+            if (m_Snapshot)
+            {
+                WriteBackDirtyRanges();
+                return;
+            }
             MemWriteFillTask::Args WriteArgs = {};
             MemWriteFillTask::WriteData PointerArgs = {};
             PointerArgs.pData = m_Resource.m_pHostPointer;
@@ -2463,19 +2956,76 @@ private:
             MemWriteFillTask(m_Parent.get(), m_Resource, CL_COMMAND_WRITE_BUFFER, m_CommandQueue.Get(), WriteArgs, true).Record();
         }
     }
+
+    // Compares the mapped region against the map-time snapshot in page-sized
+    // chunks and records a write-back only for runs of chunks that changed.
+    // An untouched map records nothing at all.
+    void WriteBackDirtyRanges()
+    {
+        byte const* Current = (byte const*)m_Pointer;
+        size_t const Width = m_Args.Width;
+        for (size_t Begin = 0; Begin < Width; )
+        {
+            size_t End = std::min(Begin + DiffChunkBytes, Width);
+            if (memcmp(Current + Begin, m_Snapshot.get() + Begin, End - Begin) == 0)
+            {
+                Begin = End;
+                continue;
+            }
+            // Extend the span across consecutive dirty chunks.
+            while (End < Width)
+            {
+                size_t NextEnd = std::min(End + DiffChunkBytes, Width);
+                if (memcmp(Current + End, m_Snapshot.get() + End, NextEnd - End) == 0)
+                {
+                    break;
+                }
+                End = NextEnd;
+            }
+
+            MemWriteFillTask::Args WriteArgs = {};
+            MemWriteFillTask::WriteData PointerArgs = {};
+            PointerArgs.pData = m_Resource.m_pHostPointer;
+            PointerArgs.RowPitch = (cl_uint)m_Resource.m_Desc.image_row_pitch;
+            PointerArgs.SlicePitch = (cl_uint)m_Resource.m_Desc.image_slice_pitch;
+            WriteArgs.Data = PointerArgs;
+            WriteArgs.SrcX = WriteArgs.DstX = m_Args.SrcX + (cl_uint)Begin;
+            WriteArgs.Width = (cl_uint)(End - Begin);
+            WriteArgs.Height = 1;
+            WriteArgs.Depth = 1;
+            WriteArgs.NumArraySlices = 1;
+            MemWriteFillTask(m_Parent.get(), m_Resource, CL_COMMAND_WRITE_BUFFER, m_CommandQueue.Get(), WriteArgs, true).Record();
+            Begin = End;
+        }
+    }
+
+    static bool GetMapDiffEnabled()
+    {
+        static const bool bEnabled = []() -> bool
+        {
+            if (const char* Override = getenv("CLON12_MAP_DIFF"))
+            {
+                return strtoul(Override, nullptr, 10) != 0;
+            }
+            return true;
+        }();
+        return bEnabled;
+    }
+
+    static constexpr size_t SnapshotThresholdBytes = 1024 * 1024;
+    static constexpr size_t DiffChunkBytes = 4096;
+    std::unique_ptr<byte[]> m_Snapshot;
 };
 
-constexpr static D3D12_RANGE EmptyRange = {};
 class MapSynchronizeTask : public MapTask
 {
 public:
     MapSynchronizeTask(Context& Parent, cl_command_queue command_queue, cl_map_flags flags, Resource& resource, Args const& args, cl_command_type command)
         : MapTask(Parent, command_queue, resource, flags, command, args)
     {
-        void* basePointer = nullptr;
         auto& Device = m_CommandQueue->GetD3DDevice();
         UINT subresource = args.FirstArraySlice * resource.m_CreationArgs.m_appDesc.m_MipLevels + args.FirstMipLevel;
-        D3D12TranslationLayer::ThrowFailure(resource.GetUnderlyingResource(&Device)->GetUnderlyingResource()->Map(0, &EmptyRange, &basePointer));
+        void* basePointer = resource.GetPersistentMapPointer(&Device);
         auto& Placement = resource.GetUnderlyingResource(&Device)->GetSubresourcePlacement(subresource);
         m_RowPitch = Placement.Footprint.RowPitch;
         m_SlicePitch = args.NumArraySlices > 1 ?
@@ -2512,10 +3062,102 @@ private:
     }
     void Unmap([[maybe_unused]] bool IsResourceBeingDestroyed) final
     {
-        m_Resource.GetActiveUnderlyingResource()->GetUnderlyingResource()->Unmap(0, &EmptyRange);
+        // The underlying resource stays persistently mapped; nothing to undo.
     }
 };
 
+// Read maps of CL_MEM_ALLOC_HOST_PTR resources would otherwise hand the app a
+// pointer straight into the write-combined heap (see MapSynchronizeTask),
+// where every CPU load is uncached - catastrophically slow if the app walks
+// the data non-sequentially. This task instead pulls the mapped region into a
+// cached shadow allocation with streaming loads on the worker thread before
+// the map completes, so the app-visible pointer is always cached memory. For
+// writable maps the shadow is copied back through the heap pointer on unmap,
+// where ordinary stores combine just fine.
+class MapStreamCopyTask : public MapTask
+{
+public:
+    MapStreamCopyTask(Context& Parent, cl_command_queue command_queue, cl_map_flags flags, Resource& resource, Args const& args, cl_command_type command)
+        : MapTask(Parent, command_queue, resource, flags, command, args)
+    {
+        auto& Device = m_CommandQueue->GetD3DDevice();
+        UINT subresource = args.FirstArraySlice * resource.m_CreationArgs.m_appDesc.m_MipLevels + args.FirstMipLevel;
+        void* basePointer = resource.GetPersistentMapPointer(&Device);
+        auto& Placement = resource.GetUnderlyingResource(&Device)->GetSubresourcePlacement(subresource);
+        m_RowPitch = Placement.Footprint.RowPitch;
+        m_SlicePitch = args.NumArraySlices > 1 ?
+            (UINT)(resource.GetUnderlyingResource(&Device)->GetSubresourcePlacement(subresource + 1).Offset - Placement.Offset) :
+            resource.GetUnderlyingResource(&Device)->DepthPitch(subresource);
+
+        m_HeapPointer = (byte*)basePointer +
+            m_SlicePitch * m_Args.SrcZ +
+            m_RowPitch * m_Args.SrcY +
+            GetFormatSizeBytes(resource.m_Format) * m_Args.SrcX +
+            Placement.Offset;
+
+        // The shadow shares the heap region's pitches, so it only needs to
+        // span from the first to the last mapped byte.
+        size_t RowBytes = (size_t)m_Args.Width * GetFormatSizeBytes(resource.m_Format);
+        size_t Slices = (size_t)m_Args.Depth * m_Args.NumArraySlices;
+        m_Shadow.reset(new byte[m_SlicePitch * (Slices - 1) + m_RowPitch * (m_Args.Height - 1) + RowBytes]);
+        m_Pointer = m_Shadow.get();
+    }
+
+private:
+    void RecordImpl() final
+    {
+        // A read-only map just needs pending writers retired; a writable map
+        // also needs readers retired before the unmap write-back can land.
+        D3D12TranslationLayer::MAP_TYPE MapType = (m_MapFlags & CL_MAP_WRITE) ?
+            D3D12TranslationLayer::MAP_TYPE_READWRITE :
+            D3D12TranslationLayer::MAP_TYPE_READ;
+        for (cl_uint i = 0; i < m_Args.NumArraySlices; ++i)
+        {
+            UINT subresource = (m_Args.FirstArraySlice + i) * m_Resource.m_CreationArgs.m_appDesc.m_MipLevels + m_Args.FirstMipLevel;
+            m_Resource.GetActiveUnderlyingResource()->m_pParent->SynchronizeForMap(
+                m_Resource.GetActiveUnderlyingResource(),
+                subresource, MapType, false);
+        }
+        ForEachRow([](byte* pShadow, byte* pHeap, size_t Size)
+        {
+            StreamingLoadCopy(pShadow, pHeap, Size);
+        });
+    }
+    void Unmap(bool IsResourceBeingDestroyed) final
+    {
+        if ((m_MapFlags & CL_MAP_WRITE) && !IsResourceBeingDestroyed)
+        {
+            ForEachRow([](byte* pShadow, byte* pHeap, size_t Size)
+            {
+                memcpy(pHeap, pShadow, Size);
+            });
+        }
+        m_Shadow.reset();
+    }
+
+    // Row-wise walk over the mapped region; the shadow and the heap region
+    // share pitches, so only the copy direction differs between callers.
+    template <typename TCopy> void ForEachRow(TCopy&& Copy)
+    {
+        size_t RowBytes = (size_t)m_Args.Width * GetFormatSizeBytes(m_Resource.m_Format);
+        size_t Slices = (size_t)m_Args.Depth * m_Args.NumArraySlices;
+        for (size_t slice = 0; slice < Slices; ++slice)
+        {
+            byte* pShadowRow = m_Shadow.get() + slice * m_SlicePitch;
+            byte* pHeapRow = m_HeapPointer + slice * m_SlicePitch;
+            for (cl_uint y = 0; y < m_Args.Height; ++y)
+            {
+                Copy(pShadowRow, pHeapRow, RowBytes);
+                pShadowRow += m_RowPitch;
+                pHeapRow += m_RowPitch;
+            }
+        }
+    }
+
+    byte* m_HeapPointer = nullptr;
+    std::unique_ptr<byte[]> m_Shadow;
+};
+
 class MapCopyTask : public MapTask
 {
 public:
@@ -2537,20 +3179,53 @@ public:
         Args.m_desc12.Flags = D3D12_RESOURCE_FLAG_NONE;
 
         cl_mem_flags stagingFlags = CL_MEM_ALLOC_HOST_PTR;
+        m_StagingKey = {};
         if (resource.m_Desc.image_type == CL_MEM_OBJECT_BUFFER)
         {
-            m_MappableResource.Attach(Resource::CreateBuffer(Parent, Args, nullptr, stagingFlags, nullptr));
+            // Buffers are pooled in power-of-two buckets so steady-state maps
+            // of nearby sizes share one staging resource; the copies below
+            // only touch the mapped range, so a larger buffer is fine.
+            UINT64 BucketSize = 4096;
+            while (BucketSize < args.Width && BucketSize < (1u << 31))
+            {
+                BucketSize *= 2;
+            }
+            if (BucketSize < args.Width)
+            {
+                BucketSize = D3D12TranslationLayer::Align<UINT64>(args.Width, 4);
+            }
+            m_StagingKey.ImageType = CL_MEM_OBJECT_BUFFER;
+            m_StagingKey.Width = BucketSize;
+            m_MappableResource = m_CommandQueue->TryAcquireStagingResource(m_StagingKey);
+            if (!m_MappableResource.Get())
+            {
+                // The creation args may describe a larger parent (sub-buffer or
+                // slab-placed buffer); size the staging buffer for the bucket.
+                Args.m_appDesc.m_Width = (UINT)BucketSize;
+                Args.m_desc12 = CD3DX12_RESOURCE_DESC::Buffer(BucketSize);
+                m_MappableResource.Attach(Resource::CreateBuffer(Parent, Args, nullptr, stagingFlags, nullptr));
+            }
         }
         else
         {
-            cl_image_desc NewDesc = resource.m_Desc;
-            NewDesc.image_width = args.Width;
-            NewDesc.image_height = args.Height;
-            NewDesc.image_depth = args.Depth;
-            NewDesc.image_array_size = args.NumArraySlices;
-            NewDesc.image_row_pitch = 0;
-            NewDesc.image_slice_pitch = 0;
-            m_MappableResource.Attach(Resource::CreateImage(Parent, Args, nullptr, resource.m_Format, NewDesc, stagingFlags, nullptr));
+            m_StagingKey.ImageType = resource.m_Desc.image_type;
+            m_StagingKey.Format = resource.m_Format;
+            m_StagingKey.Width = args.Width;
+            m_StagingKey.Height = args.Height;
+            m_StagingKey.Depth = args.Depth;
+            m_StagingKey.ArraySize = args.NumArraySlices;
+            m_MappableResource = m_CommandQueue->TryAcquireStagingResource(m_StagingKey);
+            if (!m_MappableResource.Get())
+            {
+                cl_image_desc NewDesc = resource.m_Desc;
+                NewDesc.image_width = args.Width;
+                NewDesc.image_height = args.Height;
+                NewDesc.image_depth = args.Depth;
+                NewDesc.image_array_size = args.NumArraySlices;
+                NewDesc.image_row_pitch = 0;
+                NewDesc.image_slice_pitch = 0;
+                m_MappableResource.Attach(Resource::CreateImage(Parent, Args, nullptr, resource.m_Format, NewDesc, stagingFlags, nullptr));
+            }
         }
 
         m_MappableResource->EnqueueMigrateResource(&m_CommandQueue->GetD3DDevice(), this, 0);
@@ -2605,11 +3280,16 @@ private:
             CopyResourceTask(m_Parent.get(), *m_MappableResource.Get(), m_Resource, m_CommandQueue.Get(), CopyArgs, CL_COMMAND_COPY_IMAGE).Record();
         }
 
-        m_MappableResource.Release();
+        // Return the staging resource to the queue's pool for the next
+        // map/read; any outstanding GPU work against it is ordered by the
+        // queue's single immediate context, and the next map synchronizes
+        // before touching it on the CPU.
+        m_CommandQueue->RecycleStagingResource(m_StagingKey, std::move(m_MappableResource));
         m_UnderlyingMapTask.reset();
     }
 
     Resource::ref_ptr m_MappableResource;
+    CommandQueue::StagingResourceKey m_StagingKey = {};
     std::unique_ptr<MapSynchronizeTask> m_UnderlyingMapTask;
 };
 
@@ -2692,7 +3372,16 @@ clEnqueueMapBuffer(cl_command_queue command_queue,
         }
         else if (resource.m_Flags & CL_MEM_ALLOC_HOST_PTR)
         {
-            task.reset(new MapSynchronizeTask(context, command_queue, map_flags, resource, CmdArgs, CL_COMMAND_MAP_BUFFER));
+            // Write-only maps keep the direct heap pointer; stores to
+            // write-combined memory are fast, only loads are painful.
+            if ((map_flags & CL_MAP_READ) && queue.m_StreamReadMaps)
+            {
+                task.reset(new MapStreamCopyTask(context, command_queue, map_flags, resource, CmdArgs, CL_COMMAND_MAP_BUFFER));
+            }
+            else
+            {
+                task.reset(new MapSynchronizeTask(context, command_queue, map_flags, resource, CmdArgs, CL_COMMAND_MAP_BUFFER));
+            }
         }
         else
         {
@@ -142,6 +142,36 @@ bool ValidateMemFlagsForBufferReference(cl_mem_flags& flags, Resource& buffer, T
     return true;
 }
 
+// Buffers no larger than this get placed inside shared slab buffers instead
+// of each getting a committed resource; ranges are handed out at constant
+// buffer placement alignment so views and sub-buffers work at any offset.
+constexpr size_t BufferSlabSize = 2 * 1024 * 1024;
+constexpr size_t BufferSlabMaxAllocSize = 64 * 1024;
+constexpr size_t BufferSlabAlignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+static D3D12TranslationLayer::ResourceCreationArgs GetBufferCreationArgs(size_t size)
+{
+    D3D12TranslationLayer::ResourceCreationArgs Args = {};
+    Args.m_bManageResidency = true;
+    Args.m_appDesc.m_Subresources = 1;
+    Args.m_appDesc.m_SubresourcesPerPlane = 1;
+    Args.m_appDesc.m_NonOpaquePlaneCount = 1;
+    Args.m_appDesc.m_MipLevels = 1;
+    Args.m_appDesc.m_ArraySize = 1;
+    Args.m_appDesc.m_Depth = 1;
+    Args.m_appDesc.m_Width = (UINT)size;
+    Args.m_appDesc.m_Height = 1;
+    Args.m_appDesc.m_Format = DXGI_FORMAT_UNKNOWN;
+    Args.m_appDesc.m_Samples = 1;
+    Args.m_appDesc.m_Quality = 0;
+    Args.m_appDesc.m_resourceDimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    Args.m_appDesc.m_usage = D3D12TranslationLayer::RESOURCE_USAGE_DEFAULT;
+    Args.m_appDesc.m_bindFlags = D3D12TranslationLayer::RESOURCE_BIND_UNORDERED_ACCESS | D3D12TranslationLayer::RESOURCE_BIND_SHADER_RESOURCE | D3D12TranslationLayer::RESOURCE_BIND_CONSTANT_BUFFER;
+    Args.m_desc12 = CD3DX12_RESOURCE_DESC::Buffer(D3D12TranslationLayer::Align<size_t>(size, 4), D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+    Args.m_heapDesc = CD3DX12_HEAP_DESC(0, D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_CREATE_NOT_RESIDENT);
+    return Args;
+}
+
 /* Memory Object APIs */
 extern CL_API_ENTRY cl_mem CL_API_CALL
 clCreateBufferWithProperties(cl_context   context_,
@@ -173,24 +203,7 @@ clCreateBufferWithProperties(cl_context   context_,
         return nullptr;
     }
 
-    D3D12TranslationLayer::ResourceCreationArgs Args = {};
-    Args.m_bManageResidency = true;
-    Args.m_appDesc.m_Subresources = 1;
-    Args.m_appDesc.m_SubresourcesPerPlane = 1;
-    Args.m_appDesc.m_NonOpaquePlaneCount = 1;
-    Args.m_appDesc.m_MipLevels = 1;
-    Args.m_appDesc.m_ArraySize = 1;
-    Args.m_appDesc.m_Depth = 1;
-    Args.m_appDesc.m_Width = (UINT)size;
-    Args.m_appDesc.m_Height = 1;
-    Args.m_appDesc.m_Format = DXGI_FORMAT_UNKNOWN;
-    Args.m_appDesc.m_Samples = 1;
-    Args.m_appDesc.m_Quality = 0;
-    Args.m_appDesc.m_resourceDimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    Args.m_appDesc.m_usage = D3D12TranslationLayer::RESOURCE_USAGE_DEFAULT;
-    Args.m_appDesc.m_bindFlags = D3D12TranslationLayer::RESOURCE_BIND_UNORDERED_ACCESS | D3D12TranslationLayer::RESOURCE_BIND_SHADER_RESOURCE | D3D12TranslationLayer::RESOURCE_BIND_CONSTANT_BUFFER;
-    Args.m_desc12 = CD3DX12_RESOURCE_DESC::Buffer(D3D12TranslationLayer::Align<size_t>(size, 4), D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
-    Args.m_heapDesc = CD3DX12_HEAP_DESC(0, D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_CREATE_NOT_RESIDENT);
+    D3D12TranslationLayer::ResourceCreationArgs Args = GetBufferCreationArgs(size);
     ModifyResourceArgsForMemFlags(Args, flags);
 
     try
@@ -558,6 +571,79 @@ clRetainMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
     return CL_SUCCESS;
 }
 
+// How many final mem-object releases accumulate on a thread before the batch
+// is processed; see the doc on Resource::DeferFinalRelease. 0 or 1 disables
+// batching, restoring immediate destruction on every release.
+static size_t GetReleaseBatchThreshold()
+{
+    static const size_t Threshold = []() -> size_t
+    {
+        if (const char* Override = getenv("CLON12_RELEASE_BATCH_SIZE"))
+        {
+            return strtoul(Override, nullptr, 10);
+        }
+        return 64;
+    }();
+    return Threshold;
+}
+
+namespace
+{
+    struct PendingReleaseList
+    {
+        std::vector<Resource*> List;
+        ~PendingReleaseList()
+        {
+            // Thread exit: release whatever is still pending. Plain releases,
+            // not a deletion batch - other thread locals may already be gone.
+            for (auto pResource : List)
+            {
+                pResource->Release();
+            }
+        }
+    };
+    thread_local PendingReleaseList g_PendingReleases;
+}
+
+bool Resource::DeferFinalRelease(Resource& resource) noexcept
+{
+    if (GetReleaseBatchThreshold() <= 1)
+    {
+        return false;
+    }
+    try
+    {
+        g_PendingReleases.List.push_back(&resource);
+    }
+    catch (std::bad_alloc&)
+    {
+        return false;
+    }
+    if (g_PendingReleases.List.size() >= GetReleaseBatchThreshold())
+    {
+        FlushPendingReleases();
+    }
+    return true;
+}
+
+void Resource::FlushPendingReleases() noexcept
+{
+    auto& list = g_PendingReleases.List;
+    if (list.empty())
+    {
+        return;
+    }
+    // One pass under a single translation-layer deletion batch: suballocation
+    // returns and deferred-deletion inserts for the whole list funnel through
+    // one queue-lock acquisition and one completed-fence read per context.
+    D3D12TranslationLayer::ScopedDeferredDeletionBatch batch;
+    for (auto pResource : list)
+    {
+        pResource->Release();
+    }
+    list.clear();
+}
+
 extern CL_API_ENTRY cl_int CL_API_CALL
 clReleaseMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
 {
@@ -565,7 +651,16 @@ clReleaseMemObject(cl_mem memobj) CL_API_SUFFIX__VERSION_1_0
     {
         return CL_INVALID_MEM_OBJECT;
     }
-    static_cast<Resource*>(memobj)->Release();
+    Resource& resource = *static_cast<Resource*>(memobj);
+    // Dropping the app's last reference runs the destructor, which returns
+    // suballocations and queues deferred deletions one lock at a time - batch
+    // those so graph teardown doesn't storm the deletion queue lock. The
+    // deferred entry keeps the reference until the batch is flushed.
+    if (resource.GetRefCount() == 1 && Resource::DeferFinalRelease(resource))
+    {
+        return CL_SUCCESS;
+    }
+    resource.Release();
     return CL_SUCCESS;
 }
 
@@ -610,18 +705,22 @@ clGetSupportedImageFormats(cl_context           context_,
     }
 
     cl_uint NumFormats = 0;
-    for (UINT i = 0; i < DXGI_FORMAT_B8G8R8X8_UNORM; ++i)
+    for (UINT i = 0; i < FormatDetails::c_DXGIToCLTableSize; ++i)
     {
+        // Formats with no CL mapping can't contribute an entry, so don't
+        // bother checking device support for them.
+        cl_image_format format = GetCLImageFormatForDXGIFormat((DXGI_FORMAT)i, 0);
+        if (format.image_channel_data_type == 0)
+        {
+            continue;
+        }
+
         bool IsSupported = [&]()
         {
             for (cl_uint device = 0; device < context.GetDeviceCount(); ++device)
             {
-                D3D12_FEATURE_DATA_FORMAT_SUPPORT Support = { (DXGI_FORMAT)i };
-                if (FAILED(context.GetD3DDevice(device).GetDevice()->CheckFeatureSupport(
-                    D3D12_FEATURE_FORMAT_SUPPORT, &Support, sizeof(Support))))
-                {
-                    return false;
-                }
+                D3D12_FEATURE_DATA_FORMAT_SUPPORT const& Support =
+                    context.GetD3DDevice(device).GetFormatSupport((DXGI_FORMAT)i);
 
                 if ((flags & (CL_MEM_WRITE_ONLY | CL_MEM_READ_WRITE)) &&
                     (Support.Support2 & D3D12_FORMAT_SUPPORT2_UAV_TYPED_STORE) == D3D12_FORMAT_SUPPORT2_NONE)
@@ -670,15 +769,11 @@ clGetSupportedImageFormats(cl_context           context_,
         if (!IsSupported)
             continue;
 
-        cl_image_format format = GetCLImageFormatForDXGIFormat((DXGI_FORMAT)i, 0);
-        if (format.image_channel_data_type != 0)
+        if (NumFormats < num_entries && image_formats)
         {
-            if (NumFormats < num_entries && image_formats)
-            {
-                image_formats[NumFormats] = format;
-            }
-            ++NumFormats;
+            image_formats[NumFormats] = format;
         }
+        ++NumFormats;
     }
 
     if (num_image_formats)
@@ -722,8 +817,16 @@ clGetMemObjectInfo(cl_mem           memobj,
     case CL_MEM_MAP_COUNT: return RetValue(resource.GetMapCount());
     case CL_MEM_REFERENCE_COUNT: return RetValue(resource.GetRefCount());
     case CL_MEM_CONTEXT: return RetValue(&resource.m_Parent.get());
-    case CL_MEM_ASSOCIATED_MEMOBJECT: return RetValue(resource.m_ParentBuffer.Get());
-    case CL_MEM_OFFSET: return RetValue(resource.m_Offset);
+    // Hidden slab parents aren't app-visible: a slab-placed buffer reports no
+    // associated object and no offset, and children of one report offsets
+    // relative to it rather than to the slab.
+    case CL_MEM_ASSOCIATED_MEMOBJECT: return RetValue(resource.m_OwnedBySlab ? nullptr : resource.m_ParentBuffer.Get());
+    case CL_MEM_OFFSET:
+    {
+        size_t SlabOffset = resource.m_OwnedBySlab ? resource.m_Offset :
+            (resource.m_ParentBuffer.Get() && resource.m_ParentBuffer->m_OwnedBySlab ? resource.m_ParentBuffer->m_Offset : 0);
+        return RetValue(resource.m_Offset - SlabOffset);
+    }
     case CL_MEM_USES_SVM_POINTER: return RetValue((cl_bool)CL_FALSE);
     case CL_MEM_PROPERTIES: return CopyOutParameterImpl(resource.m_Properties.data(),
                                                         resource.m_Properties.size() * sizeof(resource.m_Properties[0]),
@@ -1012,7 +1115,8 @@ auto Resource::GetUnderlyingResource(D3DDevice* device) -> UnderlyingResource*
             D3D12TranslationLayer::ResourceAllocationContext::FreeThread);
     }
 
-    if (m_CreationArgs.m_desc12.Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS)
+    if ((m_CreationArgs.m_desc12.Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS) &&
+        !BindsThroughRootView())
     {
         m_UAVs.try_emplace(device, &device->ImmCtx(), m_UAVDesc, *Entry.get());
     }
@@ -1025,6 +1129,22 @@ auto Resource::GetUnderlyingResource(D3DDevice* device) -> UnderlyingResource*
     return Entry.get();
 }
 
+void* Resource::GetPersistentMapPointer(D3DDevice* device)
+{
+    std::lock_guard Lock(m_MultiDeviceLock);
+    auto& Entry = m_PersistentMaps[device];
+    if (!Entry)
+    {
+        // Map once and leave the resource mapped for its lifetime. CPU-visible
+        // heaps allow persistent maps, and this avoids a Map/Unmap round trip
+        // through the D3D12 runtime on every map task.
+        constexpr D3D12_RANGE EmptyRange = {};
+        D3D12TranslationLayer::ThrowFailure(
+            GetUnderlyingResource(device)->GetUnderlyingResource()->Map(0, &EmptyRange, &Entry));
+    }
+    return Entry;
+}
+
 void Resource::SetActiveDevice(D3DDevice* device)
 {
     std::lock_guard Lock(m_MultiDeviceLock);
@@ -1046,8 +1166,123 @@ D3D12TranslationLayer::UAV& Resource::GetUAV(D3DDevice* device)
     return iter->second;
 }
 
+bool Resource::BindsThroughRootView()
+{
+    return m_ParentBuffer.Get() &&
+        m_Desc.image_type == CL_MEM_OBJECT_BUFFER &&
+        m_Offset - GetRootBuffer()->m_Offset <= UINT32_MAX;
+}
+
+Resource* Resource::GetRootBuffer()
+{
+    Resource* root = this;
+    while (root->m_ParentBuffer.Get())
+    {
+        root = root->m_ParentBuffer.Get();
+    }
+    return root;
+}
+
+D3D12TranslationLayer::UAV& Resource::GetUAVForKernel(D3DDevice* device)
+{
+    if (BindsThroughRootView())
+    {
+        // The root's UAV was created alongside its underlying resource, which
+        // this view's GetUnderlyingResource resolves through during migration.
+        return GetRootBuffer()->GetUAV(device);
+    }
+    return GetUAV(device);
+}
+
+// Gives a range back to a slab's free list, merging it with adjacent free
+// ranges so the space can serve larger allocations again.
+static void ReturnSlabRange(std::vector<std::pair<size_t, size_t>>& FreeRanges, size_t offset, size_t size)
+{
+    auto iter = std::lower_bound(FreeRanges.begin(), FreeRanges.end(), offset,
+        [](std::pair<size_t, size_t> const& range, size_t o) { return range.first < o; });
+    if (iter != FreeRanges.end() && offset + size == iter->first)
+    {
+        iter->first = offset;
+        iter->second += size;
+    }
+    else
+    {
+        iter = FreeRanges.insert(iter, { offset, size }); // throw( bad_alloc )
+    }
+    if (iter != FreeRanges.begin())
+    {
+        auto prev = std::prev(iter);
+        if (prev->first + prev->second == iter->first)
+        {
+            prev->second += iter->second;
+            FreeRanges.erase(iter);
+        }
+    }
+}
+
+Resource* Resource::AllocateFromSlab(Context& Parent, size_t size, cl_mem_flags flags, const cl_mem_properties *properties)
+{
+    size_t alignedSize = D3D12TranslationLayer::Align<size_t>(size, BufferSlabAlignment);
+    cl_image_format image_format = {};
+    std::lock_guard Lock(Parent.m_BufferSlabLock);
+
+    for (auto& Slab : Parent.m_BufferSlabs)
+    {
+        for (auto iter = Slab.m_FreeRanges.begin(); iter != Slab.m_FreeRanges.end(); ++iter)
+        {
+            if (iter->second < alignedSize)
+            {
+                continue;
+            }
+            size_t offset = iter->first;
+            iter->first += alignedSize;
+            iter->second -= alignedSize;
+            if (iter->second == 0)
+            {
+                Slab.m_FreeRanges.erase(iter);
+            }
+            try
+            {
+                return new Resource(*Slab.m_pResource, offset, size, image_format, CL_MEM_OBJECT_BUFFER, flags, properties, true);
+            }
+            catch (...)
+            {
+                ReturnSlabRange(Slab.m_FreeRanges, offset, alignedSize);
+                throw;
+            }
+        }
+    }
+
+    // No slab had room - start a new one. The pool keeps only a weak pointer;
+    // the buffer constructed below holds the reference that keeps it alive.
+    auto SlabArgs = GetBufferCreationArgs(BufferSlabSize);
+    ref_ptr_int spSlab(new Resource(Parent, SlabArgs, nullptr, BufferSlabSize, CL_MEM_READ_WRITE, std::nullopt, nullptr), adopt_ref{});
+    Parent.m_BufferSlabs.emplace_back(); // throw( bad_alloc )
+    try
+    {
+        auto& NewSlab = Parent.m_BufferSlabs.back();
+        NewSlab.m_pResource = spSlab.Get();
+        NewSlab.m_FreeRanges.push_back({ alignedSize, BufferSlabSize - alignedSize }); // throw( bad_alloc )
+        return new Resource(*spSlab.Get(), 0, size, image_format, CL_MEM_OBJECT_BUFFER, flags, properties, true);
+    }
+    catch (...)
+    {
+        Parent.m_BufferSlabs.pop_back();
+        throw;
+    }
+}
+
 Resource* Resource::CreateBuffer(Context& Parent, D3D12TranslationLayer::ResourceCreationArgs& Args, void* pHostPointer, cl_mem_flags flags, const cl_mem_properties *properties)
 {
+    // Small buffers without host pointers share slab storage instead of each
+    // getting a committed resource; host-pointer-backed buffers and custom
+    // heaps keep their own allocation.
+    if (!pHostPointer &&
+        Args.m_heapDesc.Properties.Type == D3D12_HEAP_TYPE_DEFAULT &&
+        Args.m_appDesc.m_Width <= BufferSlabMaxAllocSize)
+    {
+        return AllocateFromSlab(Parent, Args.m_appDesc.m_Width, flags, properties);
+    }
     return new Resource(Parent, Args, pHostPointer, Args.m_appDesc.m_Width, flags, std::nullopt, properties);
 }
 
@@ -1269,13 +1504,14 @@ Resource::Resource(Context& Parent, D3D12TranslationLayer::ResourceCreationArgs
     UAVDesc.Buffer.NumElements = (UINT)((size - 1) / 4) + 1;
 }
 
-Resource::Resource(Resource& ParentBuffer, size_t offset, size_t size, const cl_image_format& image_format, cl_mem_object_type type, cl_mem_flags flags, const cl_mem_properties *properties)
+Resource::Resource(Resource& ParentBuffer, size_t offset, size_t size, const cl_image_format& image_format, cl_mem_object_type type, cl_mem_flags flags, const cl_mem_properties *properties, bool ownedBySlab)
     : CLChildBase(ParentBuffer.m_Parent.get())
     , m_pHostPointer(ParentBuffer.m_pHostPointer && type == CL_MEM_OBJECT_BUFFER ? reinterpret_cast<char*>(ParentBuffer.m_pHostPointer) + offset : nullptr)
     , m_Flags(flags)
     , m_ParentBuffer(&ParentBuffer)
     , m_Format(image_format)
     , m_Offset(offset + ParentBuffer.m_Offset)
+    , m_OwnedBySlab(ownedBySlab)
     , m_Desc(GetBufferDesc(size, type))
     , m_CreationArgs(ParentBuffer.m_CreationArgs)
     , m_GLInfo(ParentBuffer.m_GLInfo)
@@ -1413,6 +1649,14 @@ Resource::Resource(Context& Parent, D3D12TranslationLayer::ResourceCreationArgs
 
 Resource::~Resource()
 {
+    for (auto& slot : m_InlineMaps)
+    {
+        if (MapTask* task = slot.Task.load(std::memory_order_acquire))
+        {
+            task->Unmap(true);
+            task->ReleaseInternalRef();
+        }
+    }
     for (auto&& [ptr, vec] : m_OutstandingMaps)
     {
         for (auto& map : vec)
@@ -1426,17 +1670,72 @@ Resource::~Resource()
         auto& callback = *iter;
         callback.m_pfn(this, callback.m_userData);
     }
+
+    if (m_OwnedBySlab)
+    {
+        auto& Parent = m_Parent.get();
+        std::lock_guard Lock(Parent.m_BufferSlabLock);
+        auto iter = std::find_if(Parent.m_BufferSlabs.begin(), Parent.m_BufferSlabs.end(),
+            [this](Context::BufferSlab const& Slab) { return Slab.m_pResource == m_ParentBuffer.Get(); });
+        if (iter != Parent.m_BufferSlabs.end())
+        {
+            try
+            {
+                ReturnSlabRange(iter->m_FreeRanges, m_Offset,
+                                D3D12TranslationLayer::Align<size_t>(m_Desc.image_width, BufferSlabAlignment));
+            }
+            catch (std::bad_alloc&)
+            {
+                // The range is dropped; the slab just won't hand it out again.
+            }
+            if (iter->m_FreeRanges.size() == 1 && iter->m_FreeRanges.front().second == BufferSlabSize)
+            {
+                // Last allocation is gone: drop the pool entry. The slab itself
+                // dies when this resource's parent reference is released below.
+                Parent.m_BufferSlabs.erase(iter);
+            }
+        }
+    }
 }
 
+// Sentinel key for a slot an adder has claimed but not yet published.
+static void* const MapSlotClaiming = reinterpret_cast<void*>(1);
+
 void Resource::AddMapTask(MapTask *task)
 {
+    ++m_MapCount;
+    for (auto& slot : m_InlineMaps)
+    {
+        void* expected = nullptr;
+        if (slot.Key.compare_exchange_strong(expected, MapSlotClaiming, std::memory_order_acq_rel))
+        {
+            task->AddInternalRef();
+            slot.Task.store(task, std::memory_order_relaxed);
+            slot.Key.store(task->GetPointer(), std::memory_order_release);
+            return;
+        }
+    }
     std::lock_guard MapLock(m_MapLock);
     m_OutstandingMaps[task->GetPointer()].emplace_back(task);
-    ++m_MapCount;
 }
 
 MapTask* Resource::GetMapTask(void* ptr)
 {
+    for (auto& slot : m_InlineMaps)
+    {
+        if (slot.Key.load(std::memory_order_acquire) == ptr)
+        {
+            MapTask* task = slot.Task.load(std::memory_order_acquire);
+            // Re-check the key after reading the task: the slot may have been
+            // recycled in between. A recycle for the same pointer is fine -
+            // any outstanding map of the pointer is an equally valid answer,
+            // same as the old vector's front().
+            if (task && slot.Key.load(std::memory_order_acquire) == ptr)
+            {
+                return task;
+            }
+        }
+    }
     std::lock_guard MapLock(m_MapLock);
     auto iter = m_OutstandingMaps.find(ptr);
     if (iter == m_OutstandingMaps.end())
@@ -1449,23 +1748,38 @@ MapTask* Resource::GetMapTask(void* ptr)
 
 void Resource::RemoveMapTask(MapTask *task)
 {
-    std::lock_guard MapLock(m_MapLock);
-    auto iter = m_OutstandingMaps.find(task->GetPointer());
-    if (iter == m_OutstandingMaps.end())
-        return;
+    for (auto& slot : m_InlineMaps)
+    {
+        if (slot.Key.load(std::memory_order_acquire) == task->GetPointer() &&
+            slot.Task.load(std::memory_order_relaxed) == task)
+        {
+            // Clear the task before freeing the key so an adder reusing the
+            // slot can't have its freshly stored task stomped.
+            slot.Task.store(nullptr, std::memory_order_relaxed);
+            slot.Key.store(nullptr, std::memory_order_release);
+            --m_MapCount;
+            task->ReleaseInternalRef();
+            return;
+        }
+    }
+    {
+        std::lock_guard MapLock(m_MapLock);
+        auto iter = m_OutstandingMaps.find(task->GetPointer());
+        if (iter == m_OutstandingMaps.end())
+            return;
 
-    auto& vec = iter->second;
-    auto vecIter = std::find_if(vec.begin(), vec.end(), [task](::ref_ptr_int<MapTask> const& ptr) { return ptr.Get() == task; });
-    if (vecIter == vec.end())
-        return;
+        auto& vec = iter->second;
+        auto vecIter = std::find_if(vec.begin(), vec.end(), [task](::ref_ptr_int<MapTask> const& ptr) { return ptr.Get() == task; });
+        if (vecIter == vec.end())
+            return;
 
+        vec.erase(vecIter);
+        if (vec.empty())
+        {
+            m_OutstandingMaps.erase(iter);
+        }
+    }
     --m_MapCount;
-
-    vec.erase(vecIter);
-    if (!vec.empty())
-        return;
-
-    m_OutstandingMaps.erase(iter);
 }
 
 void Resource::AddDestructionCallback(DestructorCallback::Fn pfn, void* pUserData)
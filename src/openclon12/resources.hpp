@@ -27,6 +27,11 @@ public:
     void* const m_pHostPointer;
     const ref_ptr_int m_ParentBuffer;
     const size_t m_Offset = 0;
+    // True when this buffer's storage is a range carved out of one of the
+    // context's shared slab buffers rather than its own committed resource.
+    // The range goes back to the pool on destruction, and the hidden slab is
+    // not app-visible: mem object info queries hide it.
+    const bool m_OwnedBySlab = false;
     const cl_image_format m_Format = {};
     const cl_image_desc m_Desc;
     std::vector<cl_mem_properties> const m_Properties;
@@ -50,16 +55,45 @@ public:
     static Resource *ImportGLResource(Context &Parent, cl_mem_flags flags, mesa_glinterop_export_in &in, cl_int *error);
 
     UnderlyingResource* GetUnderlyingResource(D3DDevice*);
+    void* GetPersistentMapPointer(D3DDevice*);
     void SetActiveDevice(D3DDevice*);
     UnderlyingResource* GetActiveUnderlyingResource() const { return m_ActiveUnderlying; }
-    cl_uint GetMapCount() const { std::lock_guard MapLock(m_MapLock); return m_MapCount; }
+    cl_uint GetMapCount() const { return m_MapCount.load(std::memory_order_relaxed); }
 
     void EnqueueMigrateResource(D3DDevice* newDevice, Task* triggeringTask, cl_mem_migration_flags flags);
+    // Migrates only [offset, offset + size) of this buffer to newDevice,
+    // leaving the rest wherever it currently lives. Used by sub-buffer
+    // migration so sharding a large buffer across devices moves each
+    // device's slice instead of the whole parent per shard. Parent buffers
+    // only; the moved range is tracked in m_RemoteRanges until a later
+    // migration pulls it back.
+    void MigrateSubRange(D3DDevice* newDevice, Task* triggeringTask, cl_mem_migration_flags flags, UINT64 offset, UINT64 size);
 
     D3D12TranslationLayer::SRV& GetSRV(D3DDevice*);
     D3D12TranslationLayer::UAV& GetUAV(D3DDevice*);
+
+    // Kernel arguments bind plain buffer views (sub-buffers and slab-backed
+    // buffers) through the root buffer's raw UAV: generated kernel code
+    // addresses global pointers as (UAV id, byte offset) pairs - the same
+    // low-dword slot local pointers use for shared memory offsets - so the
+    // view's offset travels in the pointer and the view needs no descriptor
+    // or per-device state of its own. Short-lived sub-buffer slices are
+    // therefore view-free; typed 1D image buffers keep dedicated views.
+    bool BindsThroughRootView();
+    Resource* GetRootBuffer();
+    D3D12TranslationLayer::UAV& GetUAVForKernel(D3DDevice*);
     ~Resource();
 
+    // clReleaseMemObject batches final releases in a per-thread list and
+    // Release()s the whole list in one pass inside a translation-layer
+    // deletion batch, so tearing down a large graph pays one deferred-deletion
+    // queue lock and one fence read per flush instead of one of each per
+    // buffer. The list is flushed when it reaches a threshold
+    // (CLON12_RELEASE_BATCH_SIZE, default 64; 0 or 1 disables batching), at
+    // clFinish, and at thread exit.
+    static bool DeferFinalRelease(Resource& resource) noexcept;
+    static void FlushPendingReleases() noexcept;
+
     void AddMapTask(MapTask*);
     MapTask* GetMapTask(void* MapPtr);
     void RemoveMapTask(MapTask*);
@@ -71,6 +105,27 @@ protected:
     D3DDevice *m_CurrentActiveDevice = nullptr;
     UnderlyingResource *m_ActiveUnderlying = nullptr;
     std::unordered_map<D3DDevice*, UnderlyingResourcePtr> m_UnderlyingMap;
+    std::unordered_map<D3DDevice*, void*> m_PersistentMaps;
+
+    // Byte ranges of a parent buffer whose latest contents live on a device
+    // other than m_CurrentActiveDevice, produced by MigrateSubRange. Kept
+    // non-overlapping; empty except while sub-buffers are sharded across
+    // devices. Guarded by m_MultiDeviceLock.
+    struct RemoteRange
+    {
+        D3DDevice* Device;
+        UINT64 Offset;
+        UINT64 Size;
+    };
+    std::vector<RemoteRange> m_RemoteRanges;
+
+    // Queues a cross-adapter copy of [offset, offset + size) from this
+    // buffer's storage on fromDevice into its storage on toDevice, as a pair
+    // of copy tasks that become dependencies of triggeringTask. Copies on one
+    // device execute in submission order, which is what keeps successive
+    // range migrations over overlapping ranges coherent.
+    void EnqueueCopyRangeCrossAdapter(D3DDevice* fromDevice, D3DDevice* toDevice, Task* triggeringTask,
+        UINT64 offset, UINT64 size);
     std::unordered_map<D3DDevice*, D3D12TranslationLayer::SRV> m_SRVs;
     std::unordered_map<D3DDevice*, D3D12TranslationLayer::UAV> m_UAVs;
 
@@ -78,18 +133,36 @@ protected:
     D3D12_UNORDERED_ACCESS_VIEW_DESC m_UAVDesc;
     D3D12_SHADER_RESOURCE_VIEW_DESC m_SRVDesc;
 
+    // Read-mostly tracking of outstanding maps. Apps keep at most a handful
+    // of concurrent maps per resource, so they live in a small array of slots
+    // published with atomics; m_OutstandingMaps (and its lock) is only the
+    // overflow. Slot protocol: an adder claims a free slot by CAS-ing the key
+    // to a claiming sentinel, stores the task, then publishes the real key;
+    // the remover clears the task before the key. Readers re-check the key
+    // after loading the task, so a slot recycled under them can't yield a
+    // task for a different pointer. Each occupied slot holds an internal ref
+    // on its task.
+    struct MapSlot
+    {
+        std::atomic<void*> Key{ nullptr };
+        std::atomic<MapTask*> Task{ nullptr };
+    };
+    static constexpr size_t NumInlineMapSlots = 8;
+    MapSlot m_InlineMaps[NumInlineMapSlots];
     mutable std::mutex m_MapLock;
     std::unordered_map<void*, std::vector<::ref_ptr_int<MapTask>>> m_OutstandingMaps;
-    cl_uint m_MapCount = 0;
+    std::atomic<cl_uint> m_MapCount{ 0 };
 
     mutable std::mutex m_DestructorLock;
     std::vector<DestructorCallback> m_DestructorCallbacks;
 
     Resource(Context& Parent, decltype(m_CreationArgs) const& CreationArgs, void* pHostPointer, size_t size, cl_mem_flags flags, std::optional<GLInfo> glInfo, const cl_mem_properties *properties);
-    Resource(Resource& ParentBuffer, size_t offset, size_t size, const cl_image_format& image_format, cl_mem_object_type type, cl_mem_flags flags, const cl_mem_properties *properties);
+    Resource(Resource& ParentBuffer, size_t offset, size_t size, const cl_image_format& image_format, cl_mem_object_type type, cl_mem_flags flags, const cl_mem_properties *properties, bool ownedBySlab = false);
     Resource(Context& Parent, decltype(m_CreationArgs) const& CreationArgs, void* pHostPointer, const cl_image_format& image_format, const cl_image_desc& image_desc, cl_mem_flags flags, std::optional<GLInfo> glInfo, const cl_mem_properties *properties);
 
     static cl_image_desc GetBufferDesc(size_t size, cl_mem_object_type type);
+    static Resource* AllocateFromSlab(Context& Parent, size_t size, cl_mem_flags flags, const cl_mem_properties *properties); // throw( bad_alloc )
     void UploadInitialData(Task* triggeringTask);
     friend class UploadInitialData;
+    friend class BatchedUploadTask;
 };
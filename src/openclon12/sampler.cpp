@@ -39,13 +39,11 @@ Sampler::Sampler(Context& Parent, Desc const& desc, const cl_sampler_properties
 
 D3D12TranslationLayer::Sampler& Sampler::GetUnderlying(D3DDevice* device)
 {
-    std::lock_guard Lock(m_Lock);
-    auto iter = m_UnderlyingSamplers.find(device);
-    if (iter != m_UnderlyingSamplers.end())
-        return iter->second;
-
-    auto ret = m_UnderlyingSamplers.try_emplace(device, &device->ImmCtx(), TranslateSamplerDesc(m_Desc));
-    return ret.first->second;
+    // Identical configs share one device-lifetime descriptor, so the many CL
+    // sampler objects created for kernels' constant samplers don't each burn
+    // a descriptor heap slot.
+    return device->GetCachedSampler(m_Desc.NormalizedCoords, m_Desc.AddressingMode,
+                                    m_Desc.FilterMode, TranslateSamplerDesc(m_Desc));
 }
 
 
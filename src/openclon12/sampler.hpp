@@ -21,7 +21,4 @@ public:
 
     const Desc m_Desc;
     const std::vector<cl_sampler_properties> m_Properties;
-private:
-    std::mutex m_Lock;
-    std::unordered_map<class D3DDevice*, D3D12TranslationLayer::Sampler> m_UnderlyingSamplers;
 };
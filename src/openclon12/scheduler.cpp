@@ -14,18 +14,14 @@
 namespace BackgroundTaskScheduler
 {
 
-//-------------------------------------------------------------------------------------------------
-Scheduler::Scheduler()
-{
-    m_QueuedEvents.emplace_back(); // throw( bad_alloc )
-    m_QueuedEventsPseudoEnd = m_QueuedEvents.begin();
-}
-
 //-------------------------------------------------------------------------------------------------
 void Scheduler::QueueTask(Task task)
 {
     bool bCancelTask = false;
     {
+        // m_Lock protects the mode and the epoch snapshot, but the task
+        // itself goes into a per-worker queue: workers pop without m_Lock, so
+        // producers no longer wait out task selection on the worker threads.
         std::lock_guard<std::mutex> lock(m_Lock);
         if (m_CurrentMode.NumThreads == 0 || m_bShutdown)
         {
@@ -33,7 +29,15 @@ void Scheduler::QueueTask(Task task)
         }
         else
         {
-            m_Tasks.push_back(QueuedTask{ task, m_QueuedEventsPseudoEnd }); // throw( bad_alloc )
+            uint32_t numQueues = m_NumWorkerQueues.load(std::memory_order_relaxed);
+            assert(numQueues > 0);
+            WorkerQueue& queue = *m_WorkerQueues[m_QueueRoundRobin++ % numQueues];
+            {
+                std::lock_guard<std::mutex> queueLock(queue.m_Lock);
+                queue.m_Tasks.push_back(QueuedTask{ task, m_CurrentEpoch }); // throw( bad_alloc )
+            }
+            m_QueuedTaskCount.fetch_add(1, std::memory_order_release);
+            ++m_OutstandingTasks;
         }
     }
 
@@ -47,6 +51,33 @@ void Scheduler::QueueTask(Task task)
     else
     {
         m_CV.notify_one();
+        if (m_bAutoscale)
+        {
+            ConsiderScaleUp();
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------
+void Scheduler::ConsiderScaleUp() noexcept
+{
+    try
+    {
+        std::unique_lock<std::mutex> lock(m_Lock);
+        if (!m_bAutoscale || m_bShutdown ||
+            m_CurrentMode != m_EffectiveMode ||
+            m_CurrentMode.NumThreads >= m_Policy.MaxThreads ||
+            m_QueuedTaskCount.load(std::memory_order_relaxed) <= m_CurrentMode.NumThreads)
+        {
+            return;
+        }
+        ++m_CurrentMode.NumThreads;
+        SetSchedulingModeImpl(m_CurrentMode, lock); // Releases lock
+    }
+    catch (std::bad_alloc&)
+    {
+        // Growth is opportunistic - the queued task still runs on the
+        // existing threads, and the next enqueue retries.
     }
 }
 
@@ -89,6 +120,16 @@ void Scheduler::SetSchedulingModeImpl(SchedulingMode mode, std::unique_lock<std:
     // Adjust number of threads
     if (NewNumThreads > PreviousNumThreads)
     {
+        // Make sure the per-worker queues exist before any new thread can look
+        // for one. Queues are never destroyed while the scheduler lives, so
+        // workers can index the array without m_Lock.
+        size_t NewNumQueues = std::min(NewNumThreads, MaxWorkerQueues);
+        for (size_t i = m_NumWorkerQueues.load(std::memory_order_relaxed); i < NewNumQueues; ++i)
+        {
+            m_WorkerQueues[i].reset(new WorkerQueue); // throw( bad_alloc )
+            m_NumWorkerQueues.store((uint32_t)(i + 1), std::memory_order_release);
+        }
+
         m_Threads.resize(NewNumThreads); // throw( bad_alloc )
         for (auto i = PreviousNumThreads; i < NewNumThreads; ++i)
         {
@@ -157,6 +198,8 @@ void Scheduler::SetSchedulingMode(SchedulingMode mode)
         // If we're shut down, ignore requests to spin back up.
         return;
     }
+    // An explicit mode is a fixed size again - stop autoscaling around it.
+    m_bAutoscale = false;
     if (mode == m_CurrentMode)
     {
         return;
@@ -180,6 +223,7 @@ void Scheduler::SetSchedulingMode(SchedulingMode mode)
             // Since we'll refuse to queue tasks when in this mode, this task should
             // be the last one - replace it with our new task
             m_Tasks.pop_back();
+            --m_OutstandingTasks;
         }
 
         QueueSetSchedulingModeTask(mode, lock);
@@ -188,6 +232,23 @@ void Scheduler::SetSchedulingMode(SchedulingMode mode)
     }
 }
 
+//-------------------------------------------------------------------------------------------------
+void Scheduler::SetAutoscalePolicy(AutoscalePolicy policy)
+{
+    // A pool that can hit zero threads would start cancelling tasks, so the
+    // floor is one thread; dropping to zero stays an explicit mode flip.
+    policy.MinThreads = std::max(1u, policy.MinThreads);
+    policy.MaxThreads = std::max(policy.MinThreads, policy.MaxThreads);
+    SetSchedulingMode({ policy.MinThreads, policy.ThreadPriority });
+
+    std::lock_guard<std::mutex> lock(m_Lock);
+    if (!m_bShutdown)
+    {
+        m_Policy = policy;
+        m_bAutoscale = true;
+    }
+}
+
 //-------------------------------------------------------------------------------------------------
 void Scheduler::SignalEventOnCompletionOfCurrentTasks(XPlatHelpers::Event hEvent, SchedulingMode modeAfterSignal)
 {
@@ -203,13 +264,13 @@ void Scheduler::SignalEventOnCompletionOfCurrentTasks(XPlatHelpers::Event hEvent
             return;
         }
 
-        // Update the entry that existing tasks will signal
-        QueuedEventSignal& signal = m_QueuedEvents.back();
-        signal.m_RefCount = (long)(m_Tasks.size() + m_TasksInProgress);
-        signal.m_Event = XPlatHelpers::unique_event(hEvent, XPlatHelpers::unique_event::copy_tag{});
-        // Add a new entry that new tasks will reference
-        m_QueuedEvents.emplace_back();
-        ++m_QueuedEventsPseudoEnd;
+        // Register a signal covering everything outstanding, then advance the
+        // epoch so tasks queued from here on don't count toward it
+        m_PendingSignals.push_back(PendingEventSignal{
+            m_CurrentEpoch,
+            m_OutstandingTasks,
+            XPlatHelpers::unique_event(hEvent, XPlatHelpers::unique_event::copy_tag{}) }); // throw( bad_alloc )
+        ++m_CurrentEpoch;
 
         // If we want to end up in a different mode, then queue a task to put us there
         if (modeAfterSignal != m_CurrentMode)
@@ -245,16 +306,64 @@ void Scheduler::TaskThread(int ThreadID) noexcept
                 // This thread is done
                 return;
             }
+            if (m_QueuedTaskCount.load(std::memory_order_acquire) != 0)
+            {
+                // Normal tasks live in the per-worker queues - pop or steal
+                // without holding the scheduler lock so producers aren't blocked
+                // behind task selection.
+                lock.unlock();
+                bool bHaveTask = PopOrSteal(ThreadID, task);
+                lock.lock();
+                if (bHaveTask)
+                {
+                    break;
+                }
+                // Another worker got there first - re-evaluate
+                continue;
+            }
             if (!m_Tasks.empty())
             {
-                // Pop the front task and exit the loop, this thread will now do work
+                // Control tasks (mode changes) only run once the worker queues
+                // have drained, preserving the ordering they had when everything
+                // shared one FIFO.
                 task = m_Tasks.front();
                 m_Tasks.pop_front();
-                ++m_TasksInProgress;
                 break;
             }
 
-            // Not supposed to exit yet, and nothing to do - wait for a notification
+            // Not supposed to exit yet, and nothing to do - wait for a notification.
+            // Autoscaled pools above the policy minimum use a timed wait instead:
+            // a worker that times out while the whole pool is quiet retires the
+            // highest-numbered thread. The top thread never initiates - if it's
+            // the only idle one the pool is still busy - so the shrinking thread
+            // can always join its victim directly.
+            if (m_bAutoscale && !m_bShutdown &&
+                m_CurrentMode == m_EffectiveMode &&
+                m_EffectiveMode.NumThreads > m_Policy.MinThreads &&
+                ThreadID != (int)m_EffectiveMode.NumThreads - 1)
+            {
+                if (m_CV.wait_for(lock, c_AutoscaleIdleTimeout) == std::cv_status::timeout &&
+                    m_bAutoscale && !m_bShutdown &&
+                    m_OutstandingTasks == 0 &&
+                    m_CurrentMode == m_EffectiveMode &&
+                    m_EffectiveMode.NumThreads > m_Policy.MinThreads)
+                {
+                    --m_CurrentMode.NumThreads;
+                    try
+                    {
+                        SetSchedulingModeImpl(m_CurrentMode, lock); // Releases lock
+                    }
+                    catch (std::bad_alloc&)
+                    {
+                        // Shrinking is opportunistic; a later pass retries.
+                    }
+                    if (!lock.owns_lock())
+                    {
+                        lock.lock();
+                    }
+                }
+                continue;
+            }
             m_CV.wait(lock);
         }
 
@@ -264,10 +373,39 @@ void Scheduler::TaskThread(int ThreadID) noexcept
         lock.lock();
 
         RetireTask(task, lock);
-        --m_TasksInProgress;
     }
 }
 
+//-------------------------------------------------------------------------------------------------
+bool Scheduler::PopOrSteal(int ThreadID, QueuedTask& task) noexcept
+{
+    // Own queue pops from the front (FIFO); steals take from the back of the
+    // victim's queue, where the owner is least likely to be popping next.
+    size_t numQueues = m_NumWorkerQueues.load(std::memory_order_acquire);
+    for (size_t i = 0; i < numQueues; ++i)
+    {
+        WorkerQueue& queue = *m_WorkerQueues[((size_t)ThreadID + i) % numQueues];
+        std::lock_guard<std::mutex> queueLock(queue.m_Lock);
+        if (queue.m_Tasks.empty())
+        {
+            continue;
+        }
+        if (i == 0)
+        {
+            task = queue.m_Tasks.front();
+            queue.m_Tasks.pop_front();
+        }
+        else
+        {
+            task = queue.m_Tasks.back();
+            queue.m_Tasks.pop_back();
+        }
+        m_QueuedTaskCount.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
 //-------------------------------------------------------------------------------------------------
 void Scheduler::SetSchedulingModeTask(SchedulingMode mode) noexcept
 {
@@ -299,30 +437,50 @@ void Scheduler::QueueSetSchedulingModeTask(SchedulingMode mode, std::unique_lock
             mode.NumThreads == 0 ? SetSchedulingModeTaskStatic : nullptr,
             spContext.get()
         },
-        m_QueuedEventsPseudoEnd }); // throw
+        m_CurrentEpoch }); // throw
+    ++m_OutstandingTasks;
     spContext.release();
 }
 
 //-------------------------------------------------------------------------------------------------
 void Scheduler::CancelExistingTasks() noexcept
 {
+    auto CancelBatch = [this](std::deque<QueuedTask>& tasks) noexcept
+    {
+        for (auto& task : tasks)
+        {
+            if (task.m_Cancel)
+            {
+                task.m_Cancel(task.m_pContext);
+            }
+        }
+        std::unique_lock<std::mutex> lock(m_Lock);
+        for (auto& task : tasks)
+        {
+            RetireTask(task, lock);
+        }
+    };
+
     decltype(m_Tasks) TasksToCancel;
     {
         std::lock_guard<std::mutex> lock(m_Lock);
         std::swap(TasksToCancel, m_Tasks);
     }
+    CancelBatch(TasksToCancel);
 
-    for (auto& task : TasksToCancel)
+    // Drain the worker queues one at a time - swapping each queue out avoids
+    // allocating while collecting, which keeps this path noexcept-clean.
+    size_t numQueues = m_NumWorkerQueues.load(std::memory_order_acquire);
+    for (size_t i = 0; i < numQueues; ++i)
     {
-        if (task.m_Cancel)
+        std::deque<QueuedTask> QueueTasks;
         {
-            task.m_Cancel(task.m_pContext);
+            WorkerQueue& queue = *m_WorkerQueues[i];
+            std::lock_guard<std::mutex> queueLock(queue.m_Lock);
+            std::swap(QueueTasks, queue.m_Tasks);
+            m_QueuedTaskCount.fetch_sub((uint32_t)QueueTasks.size(), std::memory_order_release);
         }
-    }
-    std::unique_lock<std::mutex> lock(m_Lock);
-    for (auto& task : TasksToCancel)
-    {
-        RetireTask(task, lock);
+        CancelBatch(QueueTasks);
     }
 }
 
@@ -361,18 +519,21 @@ void Scheduler::Shutdown() noexcept
 void Scheduler::RetireTask(QueuedTask const& task, std::unique_lock<std::mutex> const& lock) noexcept
 {
     assert(lock.owns_lock()); UNREFERENCED_PARAMETER(lock);
-    for (auto iter = task.m_QueuedEventsAtTimeOfTaskSubmission; iter->m_Event;)
+    assert(m_OutstandingTasks > 0);
+    --m_OutstandingTasks;
+    // Signals registered before this task was queued have an older epoch and
+    // never counted it; everything at or after the task's epoch did.
+    for (auto iter = m_PendingSignals.begin(); iter != m_PendingSignals.end();)
     {
-        int refcount = --iter->m_RefCount;
-        if (refcount == 0)
+        if (task.m_EpochAtTimeOfTaskSubmission <= iter->m_Epoch &&
+            --iter->m_RefCount == 0)
         {
             iter->m_Event.set();
-            iter = m_QueuedEvents.erase(iter);
+            iter = m_PendingSignals.erase(iter);
             continue;
         }
         ++iter;
     }
-    assert(m_QueuedEvents.size() > 0);
 }
 
 }
\ No newline at end of file
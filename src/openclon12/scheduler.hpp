@@ -8,8 +8,9 @@
 #include <mutex>
 #include <condition_variable>
 #include <algorithm>
-#include <list>
 #include <atomic>
+#include <memory>
+#include <chrono>
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -44,20 +45,28 @@ namespace BackgroundTaskScheduler
     class Scheduler
     {
     protected:
-        struct QueuedEventSignal
+        // Flush visibility is tracked with epoch counters instead of a signal
+        // list: every task captures the current epoch at submission, and
+        // registering an event bumps the epoch, so a pending signal is just
+        // "this many tasks from epochs at or before mine are still
+        // outstanding". Retiring a task only touches m_PendingSignals when one
+        // is registered, which outside of queue teardown is never - the common
+        // case is a plain counter decrement.
+        struct PendingEventSignal
         {
-            std::atomic<long> m_RefCount;
+            uint32_t m_Epoch;    // Tasks with epoch <= this count toward the signal.
+            uint32_t m_RefCount; // Outstanding such tasks; the event fires at zero.
             XPlatHelpers::unique_event m_Event;
         };
-        std::list<QueuedEventSignal> m_QueuedEvents;
-        std::list<QueuedEventSignal>::iterator m_QueuedEventsPseudoEnd;
+        std::vector<PendingEventSignal> m_PendingSignals;
+        uint32_t m_CurrentEpoch = 0;
 
         struct QueuedTask : Task
         {
-            std::list<QueuedEventSignal>::iterator m_QueuedEventsAtTimeOfTaskSubmission;
+            uint32_t m_EpochAtTimeOfTaskSubmission;
             QueuedTask() = default;
-            QueuedTask(Task const& t, decltype(m_QueuedEventsAtTimeOfTaskSubmission) iter)
-                : Task(t), m_QueuedEventsAtTimeOfTaskSubmission(iter)
+            QueuedTask(Task const& t, uint32_t epoch)
+                : Task(t), m_EpochAtTimeOfTaskSubmission(epoch)
             {
             }
             QueuedTask(QueuedTask const&) = default;
@@ -66,12 +75,33 @@ namespace BackgroundTaskScheduler
             QueuedTask& operator=(QueuedTask&&) = default;
         };
 
-        // These are the tasks that are waiting for a thread to consume them.
+        // Normal tasks are distributed round-robin across per-worker queues so
+        // producers and consumers only contend on one small lock each, instead of
+        // everybody serializing on m_Lock. Workers pop their own queue from the
+        // front and steal from other queues from the back when theirs is empty.
+        struct WorkerQueue
+        {
+            std::mutex m_Lock;
+            std::deque<QueuedTask> m_Tasks;
+        };
+        // Fixed-size array so workers can index it without holding m_Lock; slots
+        // are populated (under m_Lock) before m_NumWorkerQueues is bumped, and
+        // never torn down until destruction. Threads beyond the array share
+        // queues via modulo.
+        static constexpr size_t MaxWorkerQueues = 64;
+        std::unique_ptr<WorkerQueue> m_WorkerQueues[MaxWorkerQueues];
+        std::atomic<uint32_t> m_NumWorkerQueues = {0};
+        // Number of tasks sitting in worker queues. Workers use this to decide
+        // whether a pop/steal pass is worth dropping m_Lock for.
+        std::atomic<uint32_t> m_QueuedTaskCount = {0};
+        // Queued + currently-executing tasks, including control tasks. Guarded by
+        // m_Lock; this is what the pending event signals count down from.
+        uint32_t m_OutstandingTasks = 0;
+        uint32_t m_QueueRoundRobin = 0;
+
+        // Control tasks (scheduling mode changes) still go through this global
+        // FIFO; they only run once the worker queues have drained.
         std::deque<QueuedTask> m_Tasks;
-        // This is a counter of how many tasks are currently being processed by
-        // worker threads. Adding this to the size of m_Tasks enables determining
-        // the total number of currently not-completed tasks.
-        uint32_t m_TasksInProgress = 0;
         std::vector<std::thread> m_Threads;
         std::vector<std::thread> m_ExitingThreads;
         mutable std::mutex m_Lock;
@@ -81,23 +111,46 @@ namespace BackgroundTaskScheduler
         SchedulingMode m_EffectiveMode = { 0, Priority::Idle };
         bool m_bShutdown = false;
 
+        bool m_bAutoscale = false;
+        struct AutoscalePolicy
+        {
+            uint32_t MinThreads;
+            uint32_t MaxThreads;
+            Priority ThreadPriority;
+        };
+        AutoscalePolicy m_Policy = {};
+        // How long a worker sits idle before it retires a thread from an
+        // autoscaled pool (see TaskThread).
+        static constexpr std::chrono::milliseconds c_AutoscaleIdleTimeout{ 250 };
+
         // These methods require the lock to be held.
         // Const-ref methods just require it, non-const-ref methods may release it.
-        bool IsSchedulerIdle(std::unique_lock<std::mutex> const&) const noexcept { return m_Tasks.empty() && m_TasksInProgress == 0; }
+        bool IsSchedulerIdle(std::unique_lock<std::mutex> const&) const noexcept { return m_OutstandingTasks == 0; }
         void SetSchedulingModeImpl(SchedulingMode mode, std::unique_lock<std::mutex>& lock); // Releases lock
         void QueueSetSchedulingModeTask(SchedulingMode mode, std::unique_lock<std::mutex> const&);
         void RetireTask(QueuedTask const& task, std::unique_lock<std::mutex> const&) noexcept;
 
+        // Takes per-queue locks but not m_Lock.
+        bool PopOrSteal(int ThreadID, QueuedTask& task) noexcept;
+
         // These methods will take the lock.
+        void ConsiderScaleUp() noexcept;
         void SetSchedulingModeTask(SchedulingMode mode) noexcept;
         static void __stdcall SetSchedulingModeTaskStatic(void* pContext);
         void TaskThread(int ThreadID) noexcept;
 
     public:
-        Scheduler();
+        Scheduler() = default;
         ~Scheduler() { Shutdown(); }
 
         void SetSchedulingMode(SchedulingMode mode);
+        // Sizes the pool on demand between the policy bounds instead of a
+        // fixed thread count: QueueTask adds a thread while queued work
+        // exceeds the pool, and a worker that stays idle past the timeout
+        // while the whole pool is quiet retires one. Takes effect immediately
+        // at MinThreads; an explicit SetSchedulingMode call (including the
+        // shutdown flip to zero threads) turns autoscaling back off.
+        void SetAutoscalePolicy(AutoscalePolicy policy);
         void QueueTask(Task task);
         void SignalEventOnCompletionOfCurrentTasks(XPlatHelpers::Event hEvent, SchedulingMode modeAfterSignal);
         void CancelExistingTasks() noexcept;
@@ -67,6 +67,17 @@ clGetPipeInfo(cl_mem           pipe,
     return CL_INVALID_MEM_OBJECT;
 }
 
+// SVM remains unsupported, deliberately. Even coarse-grained buffer SVM
+// requires host and device to agree on pointer values: a pointer stored into
+// an SVM allocation by either side must be dereferenceable by the other. The
+// kernel ABI here represents a global pointer as (buffer_id << 32) | offset
+// against the UAVs bound to that specific dispatch (see Kernel::SetArg), and
+// D3D12 offers no way to place a resource at a chosen GPU VA, so a host
+// pointer can never be a valid device pointer or vice versa. The allocation
+// side would be easy - a persistently mapped CPU-visible custom-heap buffer,
+// with clEnqueueSVMMap a fence wait - but without compiler support for
+// genuine flat addressing, pointer-bearing data structures would silently
+// break, which is worse than reporting CL_DEVICE_SVM_CAPABILITIES of 0.
 extern CL_API_ENTRY void * CL_API_CALL
 clSVMAlloc(cl_context       context,
     cl_svm_mem_flags flags,
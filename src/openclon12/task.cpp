@@ -2,6 +2,99 @@
 // Licensed under the MIT License.
 #include "task.hpp"
 #include "queue.hpp"
+#include "trace.hpp"
+
+// Recycles Task allocations through size-bucketed freelists. Enqueue rates can
+// be high enough that the general-purpose allocator shows up in profiles, and
+// most Task subclasses fall into a handful of sizes, so freed blocks are kept
+// around for the next enqueue rather than returned to the heap. The pool is
+// intentionally leaked: tasks are externally refcounted API objects and can be
+// released arbitrarily late during process teardown.
+class TaskAllocationPool
+{
+    // Every allocation is prefixed with a 16-byte header holding its bucket
+    // index, preserving the default allocation alignment for the Task itself.
+    static constexpr size_t HeaderSize = 16;
+    static constexpr size_t BucketSizes[] = { 256, 512, 1024, 2048 };
+    static constexpr size_t NumBuckets = std::extent_v<decltype(BucketSizes)>;
+    static constexpr size_t MaxFreeBlocksPerBucket = 1024;
+
+    std::mutex m_Lock;
+    std::vector<void*> m_FreeBlocks[NumBuckets];
+
+public:
+    void* Allocate(size_t size) // throw( bad_alloc )
+    {
+        size_t TotalSize = size + HeaderSize;
+        size_t Bucket = 0;
+        for (; Bucket < NumBuckets && BucketSizes[Bucket] < TotalSize; ++Bucket);
+
+        void* pBlock = nullptr;
+        if (Bucket < NumBuckets)
+        {
+            {
+                std::lock_guard Lock(m_Lock);
+                auto& FreeBlocks = m_FreeBlocks[Bucket];
+                if (!FreeBlocks.empty())
+                {
+                    pBlock = FreeBlocks.back();
+                    FreeBlocks.pop_back();
+                }
+            }
+            if (!pBlock)
+            {
+                pBlock = ::operator new(BucketSizes[Bucket]);
+            }
+        }
+        else
+        {
+            pBlock = ::operator new(TotalSize);
+        }
+
+        *reinterpret_cast<size_t*>(pBlock) = Bucket;
+        return reinterpret_cast<char*>(pBlock) + HeaderSize;
+    }
+
+    void Free(void* p) noexcept
+    {
+        void* pBlock = reinterpret_cast<char*>(p) - HeaderSize;
+        size_t Bucket = *reinterpret_cast<size_t*>(pBlock);
+        if (Bucket < NumBuckets)
+        {
+            std::lock_guard Lock(m_Lock);
+            auto& FreeBlocks = m_FreeBlocks[Bucket];
+            if (FreeBlocks.size() < MaxFreeBlocksPerBucket)
+            {
+                try
+                {
+                    FreeBlocks.push_back(pBlock);
+                    return;
+                }
+                catch (std::bad_alloc&) {}
+            }
+        }
+        ::operator delete(pBlock);
+    }
+
+    static TaskAllocationPool& Get()
+    {
+        static TaskAllocationPool* pPool = new TaskAllocationPool;
+        return *pPool;
+    }
+};
+
+void* Task::operator new(size_t size)
+{
+    return TaskAllocationPool::Get().Allocate(size);
+}
+
+void Task::operator delete(void* p)
+{
+    if (p)
+    {
+        TaskAllocationPool::Get().Free(p);
+    }
+}
 
 /* Event Object APIs */
 extern CL_API_ENTRY cl_int CL_API_CALL
@@ -87,7 +180,8 @@ clGetEventInfo(cl_event         event,
     case CL_EVENT_COMMAND_TYPE: return RetValue(task.m_CommandType);
     case CL_EVENT_COMMAND_EXECUTION_STATUS:
     {
-        auto Lock = g_Platform->GetTaskPoolLock();
+        // Lock-free: apps poll this in tight loops, and taking the pool lock
+        // here would serialize them against enqueue and completion work.
         auto state = task.GetState();
         if (state == Task::State::Ready)
             state = Task::State::Submitted;
@@ -248,6 +342,9 @@ clGetEventProfilingInfo(cl_event            event,
     {
         return ReportError("Timestamps not available.", CL_PROFILING_INFO_NOT_AVAILABLE);
     }
+    // Lock-free: the acquire read of the state orders against the completing
+    // store, which happens after the GPU timestamps are resolved, so the
+    // reads below see final values.
     if (task.GetState() != Task::State::Complete)
     {
         return ReportError("Event not complete.", CL_PROFILING_INFO_NOT_AVAILABLE);
@@ -291,9 +388,22 @@ clEnqueueMarkerWithWaitList(cl_command_queue  command_queue,
 
     try
     {
-        std::unique_ptr<Task> task(new DummyTask(context, CL_COMMAND_MARKER, command_queue));
-
         auto Lock = g_Platform->GetTaskPoolLock();
+        if (num_events_in_wait_list == 0)
+        {
+            // In-order queues satisfy a marker exactly when its predecessor
+            // completes - no task needs to flow through the queue.
+            if (Task *marker = queue.TryQueueMarkerProxy(CL_COMMAND_MARKER, Lock))
+            {
+                if (event)
+                    *event = marker;
+                else
+                    marker->Release();
+                return CL_SUCCESS;
+            }
+        }
+
+        std::unique_ptr<Task> task(new DummyTask(context, CL_COMMAND_MARKER, command_queue));
         if (num_events_in_wait_list)
         {
             task->AddDependencies(event_wait_list, num_events_in_wait_list, Lock);
@@ -347,9 +457,23 @@ clEnqueueBarrierWithWaitList(cl_command_queue  command_queue,
 
     try
     {
-        std::unique_ptr<Task> task(new DummyTask(context, CL_COMMAND_BARRIER, command_queue));
-
         auto Lock = g_Platform->GetTaskPoolLock();
+        if (num_events_in_wait_list == 0)
+        {
+            // On an in-order queue a barrier with no wait list adds no
+            // ordering beyond the implicit chaining, so it reduces to the
+            // same predecessor-pinned proxy as a marker.
+            if (Task *marker = queue.TryQueueMarkerProxy(CL_COMMAND_BARRIER, Lock))
+            {
+                if (event)
+                    *event = marker;
+                else
+                    marker->Release();
+                return CL_SUCCESS;
+            }
+        }
+
+        std::unique_ptr<Task> task(new DummyTask(context, CL_COMMAND_BARRIER, command_queue));
         if (num_events_in_wait_list)
         {
             task->AddDependencies(event_wait_list, num_events_in_wait_list, Lock);
@@ -391,6 +515,7 @@ clEnqueueBarrier(cl_command_queue command_queue) CL_API_SUFFIX__VERSION_1_1_DEPR
 
 void Task::Record()
 {
+    CLON12_TRACE_TASK(RecordBegin, this);
     ImmCtx *pImmCtx = nullptr;
     if (m_CommandQueue.Get())
     {
@@ -416,6 +541,7 @@ void Task::Record()
     {
         m_StopTimestamp->End();
     }
+    CLON12_TRACE_TASK(RecordEnd, this);
 }
 
 cl_ulong& Task::GetTimestamp(cl_profiling_info timestampType)
@@ -496,6 +622,16 @@ void Task::AddDependencies(const cl_event* event_wait_list, cl_uint num_events_i
                 {
                     throw DependencyException {};
                 }
+                // Completed tasks, and running tasks whose covering fence has
+                // already passed, are satisfied by definition and don't need
+                // tracking. This also covers cross-device waits on tasks that
+                // completed before this one was enqueued, which would
+                // otherwise be added to a waiter set that's never walked.
+                if (task->GetState() <= State::Complete ||
+                    task->CoveringFenceCompleted())
+                {
+                    continue;
+                }
                 if (task->m_D3DDevice != m_D3DDevice ||
                     task->GetState() == Task::State::Queued ||
                     task->GetState() == Task::State::Submitted)
@@ -522,10 +658,50 @@ void Task::AddDependencies(const cl_event* event_wait_list, cl_uint num_events_i
     }
 }
 
+bool Task::CoveringFenceCompleted() const
+{
+    // m_CoveringFenceValue is only stamped once the task's submission has
+    // been handed to the queue, so a nonzero value plus a Running state means
+    // the fence is the only thing left between this task and completion.
+    return m_State == State::Running &&
+        m_CoveringFenceValue != 0 &&
+        m_D3DDevice->ImmCtx().GetFence()->GetCompletedValue() >= m_CoveringFenceValue;
+}
+
+void Task::PruneSatisfiedDependencies(TaskPoolLock const&)
+{
+    auto newEnd = std::remove_if(m_TasksToWaitOn.begin(), m_TasksToWaitOn.end(),
+        [this](ref_ptr_int const& dep)
+        {
+            if (!dep->CoveringFenceCompleted())
+            {
+                return false;
+            }
+            dep->m_TasksWaitingOnThis.erase(
+                std::find_if(dep->m_TasksWaitingOnThis.begin(), dep->m_TasksWaitingOnThis.end(),
+                    [this](ref_ptr_int const& p) { return p.Get() == this; }));
+            return true;
+        });
+    m_TasksToWaitOn.erase(newEnd, m_TasksToWaitOn.end());
+}
+
 cl_int Task::WaitForCompletion()
 {
+    // Spin for the queue's budget before parking on the OS event: waits on
+    // sub-100us kernels are otherwise dominated by the kernel-mode wait/wake
+    // round trip. The future is what carries the blocking wait; the final
+    // state is read afterwards through the atomic.
+    if (cl_uint SpinUs = m_CommandQueue.Get() ? m_CommandQueue->m_EventSpinMicroseconds : 0)
+    {
+        auto Deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(SpinUs);
+        while (m_CompletionFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready &&
+               std::chrono::steady_clock::now() < Deadline)
+        {
+            YieldProcessor();
+        }
+    }
     m_CompletionFuture.wait();
-    return (cl_int)m_State;
+    return (cl_int)GetState();
 }
 
 void Task::RegisterCallback(cl_int command_exec_callback_type, NotificationRequest::Fn pfn_notify, void* user_data)
@@ -565,6 +741,7 @@ void Task::RegisterCallback(cl_int command_exec_callback_type, NotificationReque
 void Task::Submit()
 {
     m_State = State::Submitted;
+    CLON12_TRACE_TASK(Submitted, this);
     if (GetTimestamp(CL_PROFILING_COMMAND_QUEUED) != 0)
     {
         GetTimestamp(CL_PROFILING_COMMAND_SUBMIT) = TimestampFromQPC();
@@ -575,6 +752,7 @@ void Task::Submit()
 void Task::Ready(TaskPoolLock const& lock)
 {
     m_State = State::Ready;
+    CLON12_TRACE_TASK(Ready, this);
     for (auto &task : m_TasksWaitingOnThis)
     {
         assert(task->m_CommandQueue.Get() || task->m_D3DDevice);
@@ -599,6 +777,7 @@ void Task::Ready(TaskPoolLock const& lock)
 void Task::Started(TaskPoolLock const &)
 {
     m_State = State::Running;
+    CLON12_TRACE_TASK(Running, this);
     FireNotifications();
 }
 
@@ -609,13 +788,10 @@ void Task::Complete(cl_int error, TaskPoolLock const& lock)
     {
         return;
     }
-    m_State = (State)error;
-
-    if (m_CommandQueue.Get())
-    {
-        m_CommandQueue->NotifyTaskCompletion(this, lock);
-    }
 
+    // Resolve GPU timestamps before publishing the completed state:
+    // profiling queries read them without the pool lock once they observe
+    // completion through the atomic state.
     if (m_StartTimestamp || m_StopTimestamp)
     {
         assert(m_CommandQueue.Get() && m_D3DDevice);
@@ -635,6 +811,14 @@ void Task::Complete(cl_int error, TaskPoolLock const& lock)
         }
     }
 
+    m_State = (State)error;
+    CLON12_TRACE_TASK(Complete, this);
+
+    if (m_CommandQueue.Get())
+    {
+        m_CommandQueue->NotifyTaskCompletion(this, lock);
+    }
+
     if (error >= 0)
     {
         // Perform any on-complete type work, such as CPU copies of memory
@@ -683,19 +867,39 @@ void Task::Complete(cl_int error, TaskPoolLock const& lock)
 
 void Task::FireNotification(NotificationRequest const& callback, cl_int state)
 {
-    g_Platform->QueueCallback([=]()
+    // Notifications are delivered on the callback scheduler's dedicated
+    // thread, so a slow application pfn_notify never stalls the thread that
+    // observed the state change. Hold an internal ref across the hop: the
+    // app may release the event as soon as the callback is registered, but
+    // the handle passed to pfn_notify must stay valid until delivery.
+    try
     {
+        g_Platform->QueueCallback([=, refThis = ref_int(*this)]()
+        {
+            CLON12_TRACE_TASK(NotifyBegin, this);
+            callback.m_pfn(this, state, callback.m_userData);
+            CLON12_TRACE_TASK(NotifyEnd, this);
+        });
+    }
+    catch (std::bad_alloc&)
+    {
+        // Deliver on this thread rather than dropping the notification.
+        // The task pool lock is recursive, so CL calls made from the
+        // callback still function here.
+        CLON12_TRACE_TASK(NotifyBegin, this);
         callback.m_pfn(this, state, callback.m_userData);
-    });
+        CLON12_TRACE_TASK(NotifyEnd, this);
+    }
 }
 
 void Task::FireNotifications()
 {
-    switch (m_State)
+    State state = GetState();
+    switch (state)
     {
     default: // Error states
     case State::Complete:
-        for (auto& c : m_CompletionCallbacks) FireNotification(c, (cl_int)m_State);
+        for (auto& c : m_CompletionCallbacks) FireNotification(c, (cl_int)state);
         m_CompletionCallbacks.clear();
         // Fallthrough
     case State::Running:
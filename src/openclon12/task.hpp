@@ -3,6 +3,7 @@
 #pragma once
 #include "platform.hpp"
 #include "context.hpp"
+#include <atomic>
 #include <mutex>
 #include <future>
 
@@ -91,13 +92,37 @@ public:
     };
 
     void Record();
-    State GetState() const { return m_State; }
+    // Safe to call without the task pool lock: acquire-ordered against the
+    // completing store, so a caller that observes Complete also sees final
+    // profiling timestamps.
+    State GetState() const { return m_State.load(std::memory_order_acquire); }
     cl_ulong& GetTimestamp(cl_profiling_info timestampType);
 
     void AddDependencies(const cl_event* event_wait_list, cl_uint num_events_in_wait_list, TaskPoolLock const&);
+    // True once the device fence has passed this task's covering value: its
+    // GPU work has retired and it can only complete successfully. The fence
+    // acts as an epoch marker - no waiter needs to track a task whose epoch
+    // has passed.
+    bool CoveringFenceCompleted() const;
+    // Drops wait-list entries whose covering fence has completed, releasing
+    // the refs that would otherwise keep those tasks alive until their
+    // CPU-side completion walks the waiter set.
+    void PruneSatisfiedDependencies(TaskPoolLock const&);
     cl_int WaitForCompletion();
     void RegisterCallback(cl_int command_exec_callback_type, NotificationRequest::Fn pfn_notify, void* user_data);
 
+    // Flush-time copy coalescing: buffer-to-buffer copy tasks return
+    // themselves so TryCoalesceBufferCopies can merge adjacent contiguous
+    // copies; everything else records as-is.
+    virtual class CopyResourceTask* AsBufferCopy() { return nullptr; }
+    // True when nothing but pred orders this task - its wait list has either
+    // already drained or holds only the in-order chain to pred.
+    bool SoleDependencyIs(Task* pred) const
+    {
+        return m_TasksToWaitOn.empty() ||
+            (m_TasksToWaitOn.size() == 1 && m_TasksToWaitOn[0].Get() == pred);
+    }
+
     const cl_command_type m_CommandType;
     const ::ref_ptr_int<class CommandQueue> m_CommandQueue;
     const ::ref_ptr_int<class Device> m_Device;
@@ -107,6 +132,11 @@ public:
     Task(Context& Parent, D3DDevice& device);
     virtual ~Task();
 
+    // Task objects are allocated and freed on every enqueue, so their storage
+    // is recycled through a size-bucketed pool instead of hitting the heap.
+    void* operator new(size_t size);
+    void operator delete(void* p);
+
     static cl_ulong TimestampToNanoseconds(cl_ulong Ticks, cl_ulong Frequency);
     static cl_ulong TimestampFromQPC();
 
@@ -123,8 +153,13 @@ protected:
     void FireNotification(NotificationRequest const& callback, cl_int state);
     void FireNotifications();
 
-    // State changes can only be made while holding the task pool lock
-    State m_State = State::Queued;
+    // State changes can only be made while holding the task pool lock. The
+    // value itself is atomic so status polls and profiling queries on
+    // completed events never have to take that lock.
+    std::atomic<State> m_State{ State::Queued };
+    // Fence value whose completion covers this task's GPU work; stamped by
+    // D3DDevice::ExecuteTasks when the task's submission is handed to the queue.
+    UINT64 m_CoveringFenceValue = 0;
     cl_ulong m_ProfilingTimestamps[4] = {};
 
     std::vector<ref_ptr_int> m_TasksToWaitOn;
@@ -139,6 +174,11 @@ protected:
     std::shared_ptr<D3D12TranslationLayer::TimestampQuery> m_StopTimestamp;
 };
 
+// Absorbs next's copy into head when both are buffer copies over contiguous
+// ranges of the same buffers; defined in resource_tasks.cpp alongside
+// CopyResourceTask. Used by CommandQueue::CoalesceQueuedCopies.
+bool TryCoalesceBufferCopies(Task& head, Task& next);
+
 class UserEvent : public Task
 {
 public:
@@ -160,6 +200,28 @@ private:
     void MigrateResources() final { }
 };
 
+// Marker or barrier on an in-order queue with no explicit wait list. In-order
+// queues already serialize every command, so these impose no ordering beyond
+// what the queue's implicit chaining provides; instead of flowing through the
+// whole queue/record/complete machinery, the proxy snapshots the queue's last
+// queued task and completes when that predecessor does (immediately, if the
+// queue was idle). Created and tracked by CommandQueue::TryQueueMarkerProxy;
+// never queued, submitted to the device, or recorded.
+class MarkerProxyTask : public Task
+{
+public:
+    MarkerProxyTask(Context& Parent, cl_command_type type, cl_command_queue command_queue)
+        : Task(Parent, type, command_queue)
+    {
+    }
+    using Task::Submit;
+    using Task::Complete;
+
+private:
+    void RecordImpl() final { }
+    void MigrateResources() final { }
+};
+
 class Resource;
 // Map tasks will be enqueued on a queue, and also tracked on the resource which has been mapped.
 // That'll allow Unmap to do the right thing, by looking up the type of map operation that was
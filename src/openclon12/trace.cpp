@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "trace.hpp"
+
+#ifndef CLON12_NO_TRACING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <TraceLoggingProvider.h>
+
+// {9a7e3f2b-1c44-4d7a-8e21-5b903cde416f}
+TRACELOGGING_DEFINE_PROVIDER(g_hTraceProvider, "Microsoft.OpenCLOn12.Tasks",
+    (0x9a7e3f2b, 0x1c44, 0x4d7a, 0x8e, 0x21, 0x5b, 0x90, 0x3c, 0xde, 0x41, 0x6f));
+#endif
+
+namespace Trace
+{
+
+namespace
+{
+    constexpr const char* StageNames[] =
+    {
+        "Queued", "Submitted", "Ready", "Record", "Record",
+        "Running", "Complete", "Notify", "Notify",
+    };
+    constexpr char StagePhases[] =
+    {
+        'i', 'i', 'i', 'B', 'E', 'i', 'i', 'B', 'E',
+    };
+
+    struct Event
+    {
+        uint64_t Microseconds;
+        const void* pTask;
+        Stage stage;
+    };
+
+    // Only the owning thread writes a ring; the exit-time dump reads it after
+    // every producer is quiesced, so the head counter is the only shared word.
+    struct Ring
+    {
+        static constexpr uint32_t Capacity = 16384; // Power of two; oldest events overwritten
+        uint32_t ThreadIndex = 0;
+        std::atomic<uint32_t> Head = {0};
+        Event Events[Capacity];
+    };
+
+    std::mutex g_RegistryLock;
+    std::vector<std::unique_ptr<Ring>> g_Rings;
+    std::string g_JsonPath;
+    bool g_bJsonEnabled = false;
+
+    Ring* GetRing() noexcept
+    {
+        thread_local Ring* pRing = nullptr;
+        if (!pRing)
+        {
+            try
+            {
+                auto spRing = std::make_unique<Ring>();
+                std::lock_guard<std::mutex> lock(g_RegistryLock);
+                spRing->ThreadIndex = (uint32_t)g_Rings.size();
+                g_Rings.push_back(std::move(spRing));
+                pRing = g_Rings.back().get();
+            }
+            catch (std::bad_alloc&)
+            {
+                // This thread's events are simply dropped.
+            }
+        }
+        return pRing;
+    }
+
+    void WriteJson() noexcept
+    {
+        FILE* pFile = fopen(g_JsonPath.c_str(), "w");
+        if (!pFile)
+        {
+            return;
+        }
+        fputs("[", pFile);
+        bool bFirst = true;
+        std::lock_guard<std::mutex> lock(g_RegistryLock);
+        for (auto& spRing : g_Rings)
+        {
+            const uint32_t Head = spRing->Head.load(std::memory_order_acquire);
+            const uint32_t Count = std::min(Head, Ring::Capacity);
+            for (uint32_t i = Head - Count; i != Head; ++i)
+            {
+                Event const& e = spRing->Events[i % Ring::Capacity];
+                const char Phase = StagePhases[(uint8_t)e.stage];
+                fprintf(pFile, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":%u%s,\"args\":{\"event\":\"%p\"}}",
+                    bFirst ? "" : ",",
+                    StageNames[(uint8_t)e.stage], Phase,
+                    (unsigned long long)e.Microseconds, spRing->ThreadIndex,
+                    Phase == 'i' ? ",\"s\":\"t\"" : "",
+                    e.pTask);
+                bFirst = false;
+            }
+        }
+        fputs("\n]\n", pFile);
+        fclose(pFile);
+    }
+
+    struct Initializer
+    {
+        Initializer() noexcept
+        {
+#ifdef _WIN32
+            TraceLoggingRegister(g_hTraceProvider);
+#endif
+            if (const char* pPath = getenv("CLON12_TRACE_FILE"))
+            {
+                try
+                {
+                    g_JsonPath = pPath;
+                    g_bJsonEnabled = true;
+                    atexit(WriteJson);
+                }
+                catch (std::bad_alloc&) { g_bJsonEnabled = false; }
+            }
+        }
+        ~Initializer()
+        {
+#ifdef _WIN32
+            TraceLoggingUnregister(g_hTraceProvider);
+#endif
+        }
+    } g_Initializer;
+}
+
+bool Enabled() noexcept
+{
+    return g_bJsonEnabled
+#ifdef _WIN32
+        || TraceLoggingProviderEnabled(g_hTraceProvider, 0, 0)
+#endif
+        ;
+}
+
+void Emit(Stage stage, const void* pTask) noexcept
+{
+#ifdef _WIN32
+    if (TraceLoggingProviderEnabled(g_hTraceProvider, 0, 0))
+    {
+        TraceLoggingWrite(g_hTraceProvider, "TaskStage",
+            TraceLoggingString(StageNames[(uint8_t)stage], "Stage"),
+            TraceLoggingUInt8((uint8_t)stage, "StageId"),
+            TraceLoggingPointer(pTask, "Event"));
+    }
+#endif
+    if (!g_bJsonEnabled)
+    {
+        return;
+    }
+    Ring* pRing = GetRing();
+    if (!pRing)
+    {
+        return;
+    }
+    const uint64_t Microseconds = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const uint32_t Index = pRing->Head.load(std::memory_order_relaxed);
+    pRing->Events[Index % Ring::Capacity] = { Microseconds, pTask, stage };
+    pRing->Head.store(Index + 1, std::memory_order_release);
+}
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+
+// Task-lifecycle tracing: each stage a task moves through (queued, submitted,
+// ready, recorded, complete, notification delivery) emits an event tagged with
+// the task's address - the same value the app holds as its cl_event - so
+// traces can be correlated with app-side waits.
+//
+// Events go to per-thread lock-free ring buffers; nothing is written and no
+// ring is allocated unless CLON12_TRACE_FILE names an output path, in which
+// case the rings are dumped as chrome://tracing JSON at process exit. On
+// Windows the stages are additionally mirrored to an ETW TraceLogging
+// provider ("Microsoft.OpenCLOn12.Tasks") whenever a session is listening.
+// Define CLON12_NO_TRACING to compile the whole surface out.
+
+#ifndef CLON12_NO_TRACING
+
+#include <cstdint>
+
+namespace Trace
+{
+    // Span stages come in Begin/End pairs; the rest are instants.
+    enum class Stage : uint8_t
+    {
+        Queued,       // CommandQueue::QueueTask
+        Submitted,    // Task::Submit
+        Ready,        // Task::Ready
+        RecordBegin,  // Task::Record
+        RecordEnd,
+        Running,      // Task::Started
+        Complete,     // Task::Complete
+        NotifyBegin,  // Event callback delivery
+        NotifyEnd,
+    };
+
+    bool Enabled() noexcept;
+    void Emit(Stage stage, const void* pTask) noexcept;
+}
+
+#define CLON12_TRACE_TASK(stage, pTask) \
+    do { if (Trace::Enabled()) Trace::Emit(Trace::Stage::stage, pTask); } while (0)
+
+#else
+
+#define CLON12_TRACE_TASK(stage, pTask) do { } while (0)
+
+#endif
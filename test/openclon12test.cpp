@@ -374,6 +374,224 @@ TEST(OpenCLOn12, SPIRV)
     EXPECT_EQ(data[3], 0x1004080cu);
 }
 
+
+// cl_msft_split_ndrange: the entry point is fetched by name like any vendor
+// extension, so the test declares the signature here.
+typedef cl_int (CL_API_CALL *clEnqueueNDRangeKernelSplitMSFT_fn)(
+    cl_uint num_command_queues,
+    const cl_command_queue* command_queues,
+    cl_kernel kernel,
+    cl_uint work_dim,
+    const size_t* global_work_offset,
+    const size_t* global_work_size,
+    const size_t* local_work_size,
+    cl_uint num_events_in_wait_list,
+    const cl_event* event_wait_list,
+    cl_event* event);
+
+TEST(OpenCLOn12, SplitNDRange)
+{
+    auto&& [context, device] = GetWARPContext();
+    if (!context.get())
+    {
+        return;
+    }
+    auto pfnSplit = (clEnqueueNDRangeKernelSplitMSFT_fn)clGetExtensionFunctionAddressForPlatform(
+        device.getInfo<CL_DEVICE_PLATFORM>(), "clEnqueueNDRangeKernelSplitMSFT");
+    ASSERT_NE(pfnSplit, nullptr);
+
+    cl::CommandQueue queueA(context, device);
+    cl::CommandQueue queueB(context, device);
+
+    const char* kernel_source =
+    "__kernel void main_test(__global uint *output)\n\
+    {\n\
+        output[get_global_id(0)] = get_global_id(0);\n\
+    }\n";
+
+    // 3 work groups split across 2 queues: the first shard takes the
+    // remainder group (global ids 0-7) and the second gets ids 8-11, so both
+    // the remainder distribution and correctness across the shard boundary
+    // show up in the output.
+    const size_t width = 12;
+    const size_t global[1] = { width };
+    const size_t local[1] = { 4 };
+    cl::Buffer buffer(context, (cl_mem_flags)CL_MEM_READ_WRITE, width * sizeof(uint32_t));
+
+    cl::Program program(context, kernel_source, true /*build*/);
+    cl::Kernel kernel(program, "main_test");
+    kernel.setArg(0, buffer);
+
+    cl_command_queue queues[] = { queueA(), queueB() };
+    cl_event marker = nullptr;
+    EXPECT_EQ(CL_SUCCESS, pfnSplit(2, queues, kernel(), 1, nullptr, global, local, 0, nullptr, &marker));
+    ASSERT_NE(marker, nullptr);
+
+    uint32_t result[width] = {};
+    std::fill_n(result, width, 0xdeaddead);
+    EXPECT_EQ(CL_SUCCESS, clEnqueueReadBuffer(queueA(), buffer(), CL_TRUE, 0, sizeof(result), result, 1, &marker, nullptr));
+    clReleaseEvent(marker);
+
+    for (uint32_t i = 0; i < width; ++i)
+    {
+        EXPECT_EQ(result[i], i);
+    }
+}
+
+// cl_msft_batch_ndrange: the descriptor types and entry point are likewise
+// declared here and fetched by name.
+typedef struct cl_ndrange_kernel_arg_msft
+{
+    cl_uint arg_index;
+    size_t arg_size;
+    const void* arg_value;
+} cl_ndrange_kernel_arg_msft;
+
+typedef struct cl_ndrange_kernel_desc_msft
+{
+    cl_kernel kernel;
+    cl_uint work_dim;
+    const size_t* global_work_offset;
+    const size_t* global_work_size;
+    const size_t* local_work_size;
+    cl_uint num_args;
+    const cl_ndrange_kernel_arg_msft* args;
+} cl_ndrange_kernel_desc_msft;
+
+typedef cl_int (CL_API_CALL *clEnqueueNDRangeKernelBatchMSFT_fn)(
+    cl_command_queue command_queue,
+    cl_uint num_kernels,
+    const cl_ndrange_kernel_desc_msft* kernel_descs,
+    cl_uint num_events_in_wait_list,
+    const cl_event* event_wait_list,
+    cl_event* event);
+
+TEST(OpenCLOn12, BatchNDRange)
+{
+    auto&& [context, device] = GetWARPContext();
+    if (!context.get())
+    {
+        return;
+    }
+    auto pfnBatch = (clEnqueueNDRangeKernelBatchMSFT_fn)clGetExtensionFunctionAddressForPlatform(
+        device.getInfo<CL_DEVICE_PLATFORM>(), "clEnqueueNDRangeKernelBatchMSFT");
+    ASSERT_NE(pfnBatch, nullptr);
+
+    cl::CommandQueue queue(context, device);
+
+    const char* kernel_source =
+    "__kernel void main_test(__global uint *output, uint value)\n\
+    {\n\
+        output[get_global_id(0)] = value;\n\
+    }\n";
+
+    const size_t width = 12;
+    cl::Buffer buffer(context, (cl_mem_flags)CL_MEM_READ_WRITE, width * sizeof(uint32_t));
+    cl::Program program(context, kernel_source, true /*build*/);
+    cl::Kernel kernel(program, "main_test");
+    kernel.setArg(0, buffer);
+
+    // One kernel, three launches with per-descriptor arg updates, each
+    // covering a third of the buffer through its global offset.
+    const cl_uint values[3] = { 100, 101, 102 };
+    const size_t offsets[3] = { 0, 4, 8 };
+    const size_t global[1] = { 4 };
+    cl_ndrange_kernel_arg_msft args[3];
+    cl_ndrange_kernel_desc_msft descs[3];
+    for (cl_uint i = 0; i < 3; ++i)
+    {
+        args[i] = { 1, sizeof(cl_uint), &values[i] };
+        descs[i] = { kernel(), 1, &offsets[i], global, nullptr, 1, &args[i] };
+    }
+
+    cl_event marker = nullptr;
+    EXPECT_EQ(CL_SUCCESS, pfnBatch(queue(), 3, descs, 0, nullptr, &marker));
+    ASSERT_NE(marker, nullptr);
+
+    uint32_t result[width] = {};
+    EXPECT_EQ(CL_SUCCESS, clEnqueueReadBuffer(queue(), buffer(), CL_TRUE, 0, sizeof(result), result, 1, &marker, nullptr));
+    clReleaseEvent(marker);
+    for (uint32_t i = 0; i < width; ++i)
+    {
+        EXPECT_EQ(result[i], values[i / 4]);
+    }
+
+    // A bad descriptor mid-batch fails the whole call and enqueues nothing,
+    // but arg updates applied while validating earlier descriptors persist
+    // (clSetKernelArg semantics).
+    const cl_uint poison = 555;
+    cl_ndrange_kernel_arg_msft poisonArg = { 1, sizeof(cl_uint), &poison };
+    cl_ndrange_kernel_desc_msft badBatch[2];
+    badBatch[0] = { kernel(), 1, nullptr, global, nullptr, 1, &poisonArg };
+    badBatch[1] = { kernel(), 0 /*invalid work_dim*/, nullptr, global, nullptr, 0, nullptr };
+    cl_event badEvent = nullptr;
+    EXPECT_EQ(CL_INVALID_WORK_DIMENSION, pfnBatch(queue(), 2, badBatch, 0, nullptr, &badEvent));
+    EXPECT_EQ(badEvent, nullptr);
+
+    queue.finish();
+    EXPECT_EQ(CL_SUCCESS, clEnqueueReadBuffer(queue(), buffer(), CL_TRUE, 0, sizeof(result), result, 0, nullptr, nullptr));
+    for (uint32_t i = 0; i < width; ++i)
+    {
+        // Nothing from the failed batch ran.
+        EXPECT_EQ(result[i], values[i / 4]);
+    }
+
+    // A plain enqueue without touching the args picks up the value set while
+    // validating the failed batch's first descriptor.
+    const size_t full[1] = { width };
+    EXPECT_EQ(CL_SUCCESS, clEnqueueNDRangeKernel(queue(), kernel(), 1, nullptr, full, nullptr, 0, nullptr, nullptr));
+    EXPECT_EQ(CL_SUCCESS, clEnqueueReadBuffer(queue(), buffer(), CL_TRUE, 0, sizeof(result), result, 0, nullptr, nullptr));
+    for (uint32_t i = 0; i < width; ++i)
+    {
+        EXPECT_EQ(result[i], poison);
+    }
+}
+
+// cl_msft_queue_priority property tokens (declared here like the other
+// vendor extension bits above).
+#define CL_QUEUE_PRIORITY_MSFT 0x4F83
+#define CL_QUEUE_PRIORITY_NORMAL_MSFT 0x1
+#define CL_QUEUE_PRIORITY_HIGH_MSFT 0x2
+
+TEST(OpenCLOn12, QueuePriority)
+{
+    auto&& [context, device] = GetWARPContext();
+    if (!context.get())
+    {
+        return;
+    }
+
+    // Queue creation must accept the advertised priority property and the
+    // resulting queue must still execute work.
+    cl_queue_properties props[] = { CL_QUEUE_PRIORITY_MSFT, CL_QUEUE_PRIORITY_HIGH_MSFT, 0 };
+    cl_int error = CL_SUCCESS;
+    cl_command_queue rawQueue = clCreateCommandQueueWithProperties(context(), device(), props, &error);
+    EXPECT_EQ(error, CL_SUCCESS);
+    ASSERT_NE(rawQueue, nullptr);
+    cl::CommandQueue queue(rawQueue);
+
+    const char* kernel_source =
+    "__kernel void main_test(__global uint *output)\n\
+    {\n\
+        output[get_global_id(0)] = get_global_id(0);\n\
+    }\n";
+
+    const size_t width = 4;
+    cl::Buffer buffer(context, (cl_mem_flags)CL_MEM_READ_WRITE, width * sizeof(uint32_t));
+    cl::Program program(context, kernel_source, true /*build*/);
+    cl::Kernel kernel(program, "main_test");
+    kernel.setArg(0, buffer);
+
+    queue.enqueueNDRangeKernel(kernel, cl::NullRange, cl::NDRange{ width });
+
+    uint32_t result[width] = {};
+    queue.enqueueReadBuffer(buffer, CL_TRUE, 0, sizeof(result), result);
+    for (uint32_t i = 0; i < width; ++i)
+    {
+        EXPECT_EQ(result[i], i);
+    }
+}
+
 class window
 {
 public: